@@ -459,6 +459,15 @@ static int local_conf_prepare(void)
      */
     local_conf.time.handover.duration = ogs_time_from_msec(300);
 
+    /*
+     * DNS Cache TTL : 60 seconds (Positive), 5 seconds (Negative)
+     *
+     * How long ogs_getaddrinfo_cached() keeps a successful/failed lookup
+     * before asking the resolver again.
+     */
+    local_conf.time.dns_cache.positive_ttl = OGS_DNS_CACHE_POSITIVE_TTL;
+    local_conf.time.dns_cache.negative_ttl = OGS_DNS_CACHE_NEGATIVE_TTL;
+
     /* Size of internal metrics pool (amount of ogs_metrics_spec_t) */
     ogs_app()->metrics.max_specs = 512;
 
@@ -639,6 +648,34 @@ int ogs_app_parse_local_conf(const char *local)
                                 } else
                                     ogs_warn("unknown key `%s`", msg_key);
                             }
+                        } else if (!strcmp(time_key, "dns_cache")) {
+                            ogs_yaml_iter_t dns_iter;
+                            ogs_yaml_iter_recurse(&time_iter, &dns_iter);
+
+                            while (ogs_yaml_iter_next(&dns_iter)) {
+                                const char *dns_key =
+                                    ogs_yaml_iter_key(&dns_iter);
+                                ogs_assert(dns_key);
+
+                                if (!strcmp(dns_key, "positive_ttl")) {
+                                    const char *v =
+                                        ogs_yaml_iter_value(&dns_iter);
+                                    if (v) {
+                                        local_conf.time.dns_cache.
+                                            positive_ttl =
+                                                ogs_time_from_msec(atoll(v));
+                                    }
+                                } else if (!strcmp(dns_key, "negative_ttl")) {
+                                    const char *v =
+                                        ogs_yaml_iter_value(&dns_iter);
+                                    if (v) {
+                                        local_conf.time.dns_cache.
+                                            negative_ttl =
+                                                ogs_time_from_msec(atoll(v));
+                                    }
+                                } else
+                                    ogs_warn("unknown key `%s`", dns_key);
+                            }
                         } else if (!strcmp(time_key, "t3502")) {
                             /* handle config in amf */
                         } else if (!strcmp(time_key, "t3512")) {
@@ -660,6 +697,9 @@ int ogs_app_parse_local_conf(const char *local)
     rv = local_conf_validation();
     if (rv != OGS_OK) return rv;
 
+    ogs_dns_cache_set_ttl(local_conf.time.dns_cache.positive_ttl,
+            local_conf.time.dns_cache.negative_ttl);
+
     return OGS_OK;
 }
 
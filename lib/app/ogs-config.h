@@ -135,6 +135,11 @@ typedef struct ogs_local_conf_s {
             ogs_time_t complete_delay;
         } handover;
 
+        struct {
+            ogs_time_t positive_ttl;
+            ogs_time_t negative_ttl;
+        } dns_cache;
+
     } time;
 
     ogs_plmn_id_t serving_plmn_id[OGS_MAX_NUM_OF_PLMN];
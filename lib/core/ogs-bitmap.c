@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "ogs-core.h"
+
+#define WORD_BITS 64
+
+static int first_zero(uint64_t word)
+{
+    return __builtin_ctzll(~word);
+}
+
+/* Set bit 'index' at 'level' and mark the word full one level up if needed */
+static void set_bit(ogs_bitmap_t *bitmap, int level, int index)
+{
+    for (; level < bitmap->levels; level++) {
+        uint64_t *word = &bitmap->level[level][index / WORD_BITS];
+
+        *word |= (uint64_t)1 << (index % WORD_BITS);
+        if (*word != UINT64_MAX)
+            break;
+
+        index /= WORD_BITS;
+    }
+}
+
+/* Clear bit 'index' at 'level' and the full mark of its word one level up */
+static void clear_bit(ogs_bitmap_t *bitmap, int level, int index)
+{
+    for (; level < bitmap->levels; level++) {
+        uint64_t *word = &bitmap->level[level][index / WORD_BITS];
+        bool was_full = (*word == UINT64_MAX);
+
+        *word &= ~((uint64_t)1 << (index % WORD_BITS));
+        if (!was_full)
+            break;
+
+        index /= WORD_BITS;
+    }
+}
+
+/*
+ * Returns the first index at or after 'start' whose bit is clear
+ * at 'level', or -1 if there is none.
+ */
+static int find_clear(ogs_bitmap_t *bitmap, int level, int start)
+{
+    uint64_t word;
+    int index = start / WORD_BITS;
+
+    if (level >= bitmap->levels || index >= bitmap->words[level])
+        return -1;
+
+    /* Treat the bits below 'start' as set */
+    word = bitmap->level[level][index] |
+        (((uint64_t)1 << (start % WORD_BITS)) - 1);
+    if (word != UINT64_MAX)
+        return index * WORD_BITS + first_zero(word);
+
+    /* The rest of this word is full, so move on to the next free word */
+    index = find_clear(bitmap, level + 1, index + 1);
+    if (index < 0)
+        return -1;
+
+    return index * WORD_BITS + first_zero(bitmap->level[level][index]);
+}
+
+int ogs_bitmap_init(ogs_bitmap_t *bitmap, int size)
+{
+    int i, j, bits;
+
+    ogs_assert(bitmap);
+    ogs_assert(size > 0);
+
+    memset(bitmap, 0, sizeof(*bitmap));
+    bitmap->size = size;
+
+    bits = size;
+    for (i = 0; i < OGS_BITMAP_MAX_LEVEL; i++) {
+        bitmap->words[i] = (bits + WORD_BITS - 1) / WORD_BITS;
+        bitmap->level[i] = ogs_calloc(bitmap->words[i], sizeof(uint64_t));
+        if (!bitmap->level[i]) {
+            ogs_error("ogs_calloc() failed [%d words]", bitmap->words[i]);
+            bitmap->levels = i;
+            ogs_bitmap_final(bitmap);
+            return OGS_ERROR;
+        }
+        bitmap->levels = i + 1;
+
+        if (bitmap->words[i] == 1)
+            break;
+
+        bits = bitmap->words[i];
+    }
+    ogs_assert(bitmap->words[bitmap->levels-1] == 1);
+
+    /*
+     * The bits past the end of each level never become free,
+     * so the search can not return them.
+     */
+    bits = size;
+    for (i = 0; i < bitmap->levels; i++) {
+        for (j = bits; j < bitmap->words[i] * WORD_BITS; j++)
+            bitmap->level[i][j / WORD_BITS] |= (uint64_t)1 << (j % WORD_BITS);
+        bits = bitmap->words[i];
+    }
+
+    return OGS_OK;
+}
+
+void ogs_bitmap_final(ogs_bitmap_t *bitmap)
+{
+    int i;
+
+    ogs_assert(bitmap);
+
+    for (i = 0; i < bitmap->levels; i++)
+        ogs_free(bitmap->level[i]);
+
+    memset(bitmap, 0, sizeof(*bitmap));
+}
+
+/*
+ * Sets the first clear index at or after the previous allocation,
+ * wrapping around to the start, and returns it.
+ * Returns -1 if every index is set.
+ */
+int ogs_bitmap_alloc(ogs_bitmap_t *bitmap)
+{
+    int index;
+
+    ogs_assert(bitmap);
+    ogs_assert(bitmap->levels);
+
+    if (bitmap->level[bitmap->levels-1][0] == UINT64_MAX)
+        return -1;
+
+    index = find_clear(bitmap, 0, bitmap->next);
+    if (index < 0)
+        index = find_clear(bitmap, 0, 0);
+
+    ogs_assert(index >= 0 && index < bitmap->size);
+
+    set_bit(bitmap, 0, index);
+    bitmap->used++;
+
+    bitmap->next = index + 1;
+    if (bitmap->next == bitmap->size)
+        bitmap->next = 0;
+
+    return index;
+}
+
+/* Sets 'index' and returns false if it was already set */
+bool ogs_bitmap_set(ogs_bitmap_t *bitmap, int index)
+{
+    ogs_assert(bitmap);
+    ogs_assert(index >= 0 && index < bitmap->size);
+
+    if (ogs_bitmap_test(bitmap, index))
+        return false;
+
+    set_bit(bitmap, 0, index);
+    bitmap->used++;
+
+    return true;
+}
+
+void ogs_bitmap_clear(ogs_bitmap_t *bitmap, int index)
+{
+    ogs_assert(bitmap);
+    ogs_assert(index >= 0 && index < bitmap->size);
+
+    if (!ogs_bitmap_test(bitmap, index))
+        return;
+
+    clear_bit(bitmap, 0, index);
+    bitmap->used--;
+}
+
+bool ogs_bitmap_test(ogs_bitmap_t *bitmap, int index)
+{
+    ogs_assert(bitmap);
+    ogs_assert(index >= 0 && index < bitmap->size);
+
+    return (bitmap->level[0][index / WORD_BITS] >>
+            (index % WORD_BITS)) & 1;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#if !defined(OGS_CORE_INSIDE) && !defined(OGS_CORE_COMPILATION)
+#error "This header cannot be included directly."
+#endif
+
+#ifndef OGS_BITMAP_H
+#define OGS_BITMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Hierarchical bitmap
+ *
+ * Level 0 holds one bit per index. A set bit at level N+1 means that the
+ * matching 64-bit word at level N is full. Finding the first free index
+ * walks one word per level, so 16M indexes are searched in four steps.
+ *
+ * ogs_bitmap_alloc() is next-fit: the search starts after the last
+ * allocated index and wraps around, so a released index is not handed
+ * out again until the rest of the bitmap has been used.
+ */
+#define OGS_BITMAP_MAX_LEVEL 6
+
+typedef struct ogs_bitmap_s {
+    int             size;           /* Number of indexes */
+    int             used;           /* Number of set indexes */
+    int             next;           /* Where ogs_bitmap_alloc() starts */
+
+    int             levels;
+    int             words[OGS_BITMAP_MAX_LEVEL];
+    uint64_t        *level[OGS_BITMAP_MAX_LEVEL];
+} ogs_bitmap_t;
+
+int ogs_bitmap_init(ogs_bitmap_t *bitmap, int size);
+void ogs_bitmap_final(ogs_bitmap_t *bitmap);
+
+int ogs_bitmap_alloc(ogs_bitmap_t *bitmap);
+bool ogs_bitmap_set(ogs_bitmap_t *bitmap, int index);
+void ogs_bitmap_clear(ogs_bitmap_t *bitmap, int index);
+bool ogs_bitmap_test(ogs_bitmap_t *bitmap, int index);
+
+#define ogs_bitmap_size(bitmap) ((bitmap)->size)
+#define ogs_bitmap_used(bitmap) ((bitmap)->used)
+#define ogs_bitmap_avail(bitmap) ((bitmap)->size - (bitmap)->used)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGS_BITMAP_H */
@@ -42,6 +42,7 @@ void ogs_core_initialize(void)
     ogs_log_init();
     ogs_pkbuf_init();
     ogs_socket_init();
+    ogs_dns_cache_init();
     ogs_tlv_init();
 
     ogs_log_install_domain(&__ogs_mem_domain, "mem", ogs_core()->log.level);
@@ -55,6 +56,7 @@ void ogs_core_initialize(void)
 void ogs_core_terminate(void)
 {
     ogs_tlv_final();
+    ogs_dns_cache_final();
     ogs_socket_final();
     ogs_pkbuf_final();
     ogs_log_final();
@@ -60,6 +60,7 @@
 #include "core/ogs-env.h"
 #include "core/ogs-fsm.h"
 #include "core/ogs-hash.h"
+#include "core/ogs-bitmap.h"
 #include "core/ogs-misc.h"
 #include "core/ogs-getopt.h"
 #include "core/ogs-file.h"
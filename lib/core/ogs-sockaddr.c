@@ -238,6 +238,195 @@ int ogs_copyaddrinfo(ogs_sockaddr_t **dst, const ogs_sockaddr_t *src)
     return OGS_OK;
 }
 
+typedef struct dns_cache_entry_s {
+    char *key;
+    ogs_sockaddr_t *sa_list; /* NULL if the lookup failed */
+    ogs_time_t expires;
+} dns_cache_entry_t;
+
+static struct {
+    ogs_hash_t *hash;
+    ogs_thread_mutex_t mutex;
+
+    ogs_time_t positive_ttl;
+    ogs_time_t negative_ttl;
+} dns_cache;
+
+static void dns_cache_entry_free(dns_cache_entry_t *entry)
+{
+    ogs_assert(entry);
+
+    ogs_freeaddrinfo(entry->sa_list);
+    ogs_free(entry->key);
+    ogs_free(entry);
+}
+
+static void dns_cache_purge(ogs_time_t now)
+{
+    ogs_hash_index_t *hi = NULL;
+
+    for (hi = ogs_hash_first(dns_cache.hash); hi; hi = ogs_hash_next(hi)) {
+        dns_cache_entry_t *entry = ogs_hash_this_val(hi);
+        ogs_assert(entry);
+
+        if (now == 0 || entry->expires <= now) {
+            ogs_hash_set(dns_cache.hash, entry->key, strlen(entry->key), NULL);
+            dns_cache_entry_free(entry);
+        }
+    }
+}
+
+void ogs_dns_cache_init(void)
+{
+    ogs_assert(dns_cache.hash == NULL);
+
+    dns_cache.hash = ogs_hash_make();
+    ogs_assert(dns_cache.hash);
+    ogs_thread_mutex_init(&dns_cache.mutex);
+
+    dns_cache.positive_ttl = OGS_DNS_CACHE_POSITIVE_TTL;
+    dns_cache.negative_ttl = OGS_DNS_CACHE_NEGATIVE_TTL;
+}
+
+void ogs_dns_cache_final(void)
+{
+    ogs_assert(dns_cache.hash);
+
+    dns_cache_purge(0);
+    ogs_hash_destroy(dns_cache.hash);
+    dns_cache.hash = NULL;
+    ogs_thread_mutex_destroy(&dns_cache.mutex);
+}
+
+void ogs_dns_cache_set_ttl(ogs_time_t positive_ttl, ogs_time_t negative_ttl)
+{
+    ogs_assert(dns_cache.hash);
+
+    ogs_thread_mutex_lock(&dns_cache.mutex);
+    dns_cache.positive_ttl = positive_ttl;
+    dns_cache.negative_ttl = negative_ttl;
+    ogs_thread_mutex_unlock(&dns_cache.mutex);
+}
+
+void ogs_dns_cache_flush(void)
+{
+    ogs_assert(dns_cache.hash);
+
+    ogs_thread_mutex_lock(&dns_cache.mutex);
+    dns_cache_purge(0);
+    ogs_thread_mutex_unlock(&dns_cache.mutex);
+}
+
+static int copyaddrinfo_with_port(
+        ogs_sockaddr_t **dst, const ogs_sockaddr_t *src, uint16_t port)
+{
+    ogs_sockaddr_t *addr = NULL;
+    int rv;
+
+    rv = ogs_copyaddrinfo(dst, src);
+    if (rv != OGS_OK) {
+        ogs_freeaddrinfo(*dst);
+        *dst = NULL;
+        return rv;
+    }
+
+    for (addr = *dst; addr; addr = addr->next)
+        addr->ogs_sin_port = htobe16(port);
+
+    return OGS_OK;
+}
+
+int ogs_getaddrinfo_cached(ogs_sockaddr_t **sa_list,
+        int family, const char *hostname, uint16_t port, int flags)
+{
+    int rv;
+    char *key = NULL;
+    ogs_sockaddr_t tmp, *resolved = NULL;
+    dns_cache_entry_t *entry = NULL;
+    ogs_time_t now;
+
+    ogs_assert(sa_list);
+    *sa_list = NULL;
+
+    /* Nothing to cache for wildcard addresses or IP literals */
+    if (!dns_cache.hash || !hostname ||
+        ogs_inet_pton(AF_INET, hostname, &tmp) == OGS_OK ||
+        ogs_inet_pton(AF_INET6, hostname, &tmp) == OGS_OK)
+        return ogs_getaddrinfo(sa_list, family, hostname, port, flags);
+
+    key = ogs_msprintf("%d:%x:%s", family, flags, hostname);
+    if (!key) {
+        ogs_error("ogs_msprintf() failed");
+        return OGS_ERROR;
+    }
+
+    now = ogs_get_monotonic_time();
+
+    ogs_thread_mutex_lock(&dns_cache.mutex);
+    entry = ogs_hash_get(dns_cache.hash, key, strlen(key));
+    if (entry && entry->expires > now) {
+        if (entry->sa_list)
+            rv = copyaddrinfo_with_port(sa_list, entry->sa_list, port);
+        else
+            rv = OGS_ERROR;
+        ogs_thread_mutex_unlock(&dns_cache.mutex);
+
+        if (rv != OGS_OK)
+            ogs_debug("[%s] cached lookup failure", hostname);
+
+        ogs_free(key);
+        return rv;
+    }
+    ogs_thread_mutex_unlock(&dns_cache.mutex);
+
+    /* Do not hold the lock while the resolver is running */
+    rv = ogs_getaddrinfo(&resolved, family, hostname, 0, flags);
+    if (rv != OGS_OK) {
+        ogs_freeaddrinfo(resolved);
+        resolved = NULL;
+    }
+
+    if (resolved) {
+        int rv2 = copyaddrinfo_with_port(sa_list, resolved, port);
+        if (rv2 != OGS_OK) {
+            ogs_freeaddrinfo(resolved);
+            ogs_free(key);
+            return rv2;
+        }
+    }
+
+    ogs_thread_mutex_lock(&dns_cache.mutex);
+
+    entry = ogs_hash_get(dns_cache.hash, key, strlen(key));
+    if (entry) {
+        ogs_hash_set(dns_cache.hash, entry->key, strlen(entry->key), NULL);
+        dns_cache_entry_free(entry);
+    }
+
+    if (ogs_hash_count(dns_cache.hash) >= OGS_DNS_CACHE_MAX_ENTRIES)
+        dns_cache_purge(now);
+
+    if (ogs_hash_count(dns_cache.hash) < OGS_DNS_CACHE_MAX_ENTRIES) {
+        entry = ogs_calloc(1, sizeof(*entry));
+        ogs_assert(entry);
+
+        entry->key = key;
+        entry->sa_list = resolved;
+        entry->expires = now + (resolved ?
+                dns_cache.positive_ttl : dns_cache.negative_ttl);
+
+        ogs_hash_set(dns_cache.hash, entry->key, strlen(entry->key), entry);
+    } else {
+        ogs_warn("DNS cache is full [%d]", OGS_DNS_CACHE_MAX_ENTRIES);
+        ogs_freeaddrinfo(resolved);
+        ogs_free(key);
+    }
+
+    ogs_thread_mutex_unlock(&dns_cache.mutex);
+
+    return rv;
+}
+
 int ogs_sortaddrinfo(ogs_sockaddr_t **sa_list, int family)
 {
     ogs_sockaddr_t *head = NULL, *addr = NULL, *new = NULL, *old = NULL;
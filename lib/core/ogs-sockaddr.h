@@ -84,6 +84,27 @@ int ogs_getaddrinfo(ogs_sockaddr_t **sa_list,
         int family, const char *hostname, uint16_t port, int flags);
 int ogs_freeaddrinfo(ogs_sockaddr_t *sa_list);
 
+/*
+ * Same as ogs_getaddrinfo(), but hostnames are answered from a shared
+ * cache when possible, so that NF event loops do not hit the (blocking)
+ * resolver for every PFCP peer lookup. A miss or an expired entry still
+ * calls ogs_getaddrinfo() in the caller's thread. Successful lookups
+ * are kept for OGS_DNS_CACHE_POSITIVE_TTL, failed ones for
+ * OGS_DNS_CACHE_NEGATIVE_TTL, unless overridden with
+ * ogs_dns_cache_set_ttl() (see time.dns_cache in the configuration).
+ */
+#define OGS_DNS_CACHE_POSITIVE_TTL ogs_time_from_sec(60)
+#define OGS_DNS_CACHE_NEGATIVE_TTL ogs_time_from_sec(5)
+#define OGS_DNS_CACHE_MAX_ENTRIES 1024
+
+void ogs_dns_cache_init(void);
+void ogs_dns_cache_final(void);
+void ogs_dns_cache_set_ttl(ogs_time_t positive_ttl, ogs_time_t negative_ttl);
+void ogs_dns_cache_flush(void);
+
+int ogs_getaddrinfo_cached(ogs_sockaddr_t **sa_list,
+        int family, const char *hostname, uint16_t port, int flags);
+
 int ogs_addaddrinfo(ogs_sockaddr_t **sa_list,
         int family, const char *hostname, uint16_t port, int flags);
 int ogs_copyaddrinfo(
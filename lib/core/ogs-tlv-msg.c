@@ -95,11 +95,71 @@ static uint8_t tlv_ctype2mode(ogs_tlv_type_e ctype, uint8_t msg_mode)
     }
 }
 
-static ogs_tlv_t *tlv_add_leaf(
-        ogs_tlv_t *parent_tlv, ogs_tlv_t *tlv, ogs_tlv_desc_t *desc, void *msg, uint8_t msg_mode)
+static uint32_t tlv_header_length(uint8_t mode)
 {
-    uint8_t tlv_mode = tlv_ctype2mode(desc->ctype, msg_mode);
+    switch(mode) {
+    case OGS_TLV_MODE_T1_L1:
+        return 2;
+    case OGS_TLV_MODE_T1_L2:
+        return 3;
+    case OGS_TLV_MODE_T1_L2_I1:
+    case OGS_TLV_MODE_T2_L2:
+        return 4;
+    case OGS_TLV_MODE_T1:
+        return 1;
+    default:
+        ogs_assert_if_reached();
+        break;
+    }
 
+    return 0;
+}
+
+static uint8_t *tlv_put_header(uint8_t *pos, uint8_t mode,
+        uint32_t type, uint32_t length, uint8_t instance)
+{
+    switch(mode) {
+    case OGS_TLV_MODE_T1_L1:
+        *(pos++) = type & 0xFF;
+        *(pos++) = length & 0xFF;
+        break;
+    case OGS_TLV_MODE_T1_L2:
+        *(pos++) = type & 0xFF;
+        *(pos++) = (length >> 8) & 0xFF;
+        *(pos++) = length & 0xFF;
+        break;
+    case OGS_TLV_MODE_T1_L2_I1:
+        *(pos++) = type & 0xFF;
+        *(pos++) = (length >> 8) & 0xFF;
+        *(pos++) = length & 0xFF;
+        *(pos++) = instance & 0xFF;
+        break;
+    case OGS_TLV_MODE_T2_L2:
+        *(pos++) = (type >> 8) & 0xFF;
+        *(pos++) = type & 0xFF;
+        *(pos++) = (length >> 8) & 0xFF;
+        *(pos++) = length & 0xFF;
+        break;
+    case OGS_TLV_MODE_T1:
+        *(pos++) = type & 0xFF;
+        break;
+    default:
+        ogs_assert_if_reached();
+        break;
+    }
+
+    return pos;
+}
+
+/*
+ * Encodes the value part of a leaf IE at 'pos' and returns its length.
+ * If 'pos' is NULL, only the length is computed.
+ *
+ * Integers are written in network byte order without touching
+ * the message structure, so the same message can be built twice.
+ */
+static int tlv_put_leaf(uint8_t *pos, ogs_tlv_desc_t *desc, void *msg)
+{
     switch (desc->ctype) {
     case OGS_TLV_UINT8:
     case OGS_TLV_INT8:
@@ -107,22 +167,10 @@ static ogs_tlv_t *tlv_add_leaf(
     case OGS_TV_INT8:
     {
         ogs_tlv_uint8_t *v = (ogs_tlv_uint8_t *)msg;
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 1, desc->instance, &v->u8);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 1, desc->instance, &v->u8);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
-        break;
+
+        if (pos)
+            pos[0] = v->u8;
+        return 1;
     }
     case OGS_TLV_UINT16:
     case OGS_TLV_INT16:
@@ -131,24 +179,11 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint16_t *v = (ogs_tlv_uint16_t *)msg;
 
-        v->u16 = htobe16(v->u16);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 2, desc->instance, &v->u16);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 2, desc->instance, &v->u16);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
+        if (pos) {
+            pos[0] = (v->u16 >> 8) & 0xFF;
+            pos[1] = v->u16 & 0xFF;
         }
-        break;
+        return 2;
     }
     case OGS_TLV_UINT24:
     case OGS_TLV_INT24:
@@ -157,25 +192,12 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint24_t *v = (ogs_tlv_uint24_t *)msg;
 
-        v->u24 = v->u24 << 8;
-        v->u24 = htobe32(v->u24);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 3, desc->instance, &v->u24);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 3, desc->instance, &v->u24);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
+        if (pos) {
+            pos[0] = (v->u24 >> 16) & 0xFF;
+            pos[1] = (v->u24 >> 8) & 0xFF;
+            pos[2] = v->u24 & 0xFF;
         }
-        break;
+        return 3;
     }
     case OGS_TLV_UINT32:
     case OGS_TLV_INT32:
@@ -184,46 +206,24 @@ static ogs_tlv_t *tlv_add_leaf(
     {
         ogs_tlv_uint32_t *v = (ogs_tlv_uint32_t *)msg;
 
-        v->u32 = htobe32(v->u32);
-
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 4, desc->instance, &v->u32);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 4, desc->instance, &v->u32);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
+        if (pos) {
+            pos[0] = (v->u32 >> 24) & 0xFF;
+            pos[1] = (v->u32 >> 16) & 0xFF;
+            pos[2] = (v->u32 >> 8) & 0xFF;
+            pos[3] = v->u32 & 0xFF;
         }
-        break;
+        return 4;
     }
     case OGS_TLV_FIXED_STR:
     case OGS_TV_FIXED_STR:
     {
         ogs_tlv_octet_t *v = (ogs_tlv_octet_t *)msg;
 
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, desc->length, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, desc->length, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
+        if (pos && desc->length) {
+            ogs_assert(v->data);
+            memcpy(pos, v->data, desc->length);
         }
-        break;
+        return desc->length;
     }
     case OGS_TLV_VAR_STR:
     {
@@ -232,73 +232,93 @@ static ogs_tlv_t *tlv_add_leaf(
         if (v->len == 0) {
             ogs_error("No TLV length - [%s] T:%d I:%d (vsz=%d)",
                     desc->name, desc->type, desc->instance, desc->vsize);
-            return NULL;
+            return -1;
         }
 
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, v->len, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, v->len, desc->instance, v->data);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
+        if (pos) {
+            ogs_assert(v->data);
+            memcpy(pos, v->data, v->len);
         }
-        break;
+        return v->len;
     }
     case OGS_TLV_NULL:
     case OGS_TV_NULL:
-    {
-        if (parent_tlv) {
-            tlv = ogs_tlv_embed(parent_tlv, tlv_mode,
-                    desc->type, 0, desc->instance, NULL);
-            if (!tlv) {
-                ogs_error("ogs_tlv_embed()");
-                return NULL;
-            }
-        } else {
-            tlv = ogs_tlv_add(tlv, tlv_mode,
-                    desc->type, 0, desc->instance, NULL);
-            if (!tlv) {
-                ogs_error("ogs_tlv_add()");
-                return NULL;
-            }
-        }
-        break;
-    }
+        return 0;
     default:
         ogs_error("Unknown type [%d]", desc->ctype);
-        return NULL;
+        return -1;
     }
+}
+
+static int tlv_put_compound(uint8_t *pos, uint32_t *count,
+        ogs_tlv_desc_t *parent_desc, void *msg, int depth, uint8_t mode);
+
+/*
+ * Encodes one IE (header and value) at 'pos' and returns the number of
+ * bytes it takes. If 'pos' is NULL, only the length is computed.
+ * The header size depends only on the mode, so the value can be written
+ * first and the header filled in afterwards with the final length.
+ */
+static int tlv_put_element(uint8_t *pos, uint32_t *count,
+        ogs_tlv_desc_t *desc, uint8_t *p, int depth, uint8_t mode)
+{
+    uint8_t tlv_mode = tlv_ctype2mode(desc->ctype, mode);
+    uint32_t hlen = tlv_header_length(tlv_mode);
+    uint32_t emb_count = 0;
+    int vlen;
+    char indent[17] = "                "; /* 16 spaces */
 
-    return tlv;
+    indent[depth*2] = 0;
+
+    if (desc->ctype == OGS_TLV_COMPOUND) {
+        if (pos)
+            ogs_trace("BUILD %sC [%s] T:%d I:%d (vsz=%d) off:%p ",
+                    indent, desc->name, desc->type, desc->instance,
+                    desc->vsize, p);
+
+        vlen = tlv_put_compound(pos ? pos + hlen : NULL, &emb_count,
+                desc, p + sizeof(ogs_tlv_presence_t), depth + 1, mode);
+        if (vlen < 0 || emb_count == 0) {
+            ogs_error("tlv_put_compound() failed");
+            return -1;
+        }
+        *count += 1 + emb_count;
+    } else {
+        if (pos)
+            ogs_trace("BUILD %sL [%s] T:%d L:%d I:%d "
+                    "(cls:%d vsz:%d) off:%p ",
+                    indent, desc->name, desc->type, desc->length,
+                    desc->instance, desc->ctype, desc->vsize, p);
+
+        vlen = tlv_put_leaf(pos ? pos + hlen : NULL, desc, p);
+        if (vlen < 0) {
+            ogs_error("tlv_put_leaf() failed");
+            return -1;
+        }
+        *count += 1;
+    }
+
+    if (pos)
+        tlv_put_header(pos, tlv_mode,
+                desc->type, vlen, desc->instance);
+
+    return hlen + vlen;
 }
 
-static uint32_t tlv_add_compound(ogs_tlv_t **root, ogs_tlv_t *parent_tlv,
+static int tlv_put_compound(uint8_t *pos, uint32_t *count,
         ogs_tlv_desc_t *parent_desc, void *msg, int depth, uint8_t mode)
 {
     ogs_tlv_presence_t *presence_p;
     ogs_tlv_desc_t *desc = NULL, *next_desc = NULL;
-    ogs_tlv_t *tlv = NULL, *emb_tlv = NULL;
     uint8_t *p = msg;
-    uint32_t offset = 0, count = 0;
+    uint32_t offset = 0, length = 0;
     int i, j, r;
-    char indent[17] = "                "; /* 16 spaces */
 
-    ogs_assert(root);
+    ogs_assert(count);
     ogs_assert(parent_desc);
     ogs_assert(msg);
 
     ogs_assert(depth <= 8);
-    indent[depth*2] = 0;
-
-    *root = NULL;
 
     for (i = 0, desc = parent_desc->child_descs[i]; desc != NULL;
             i++, desc = parent_desc->child_descs[i]) {
@@ -311,46 +331,11 @@ static uint32_t tlv_add_compound(ogs_tlv_t **root, ogs_tlv_t *parent_tlv,
                 if (*presence_p == 0)
                     break;
 
-                if (desc->ctype == OGS_TLV_COMPOUND) {
-                    ogs_trace("BUILD %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->instance,
-                            desc->vsize, p + offset2);
-
-                    if (parent_tlv)
-                        tlv = ogs_tlv_embed(parent_tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-                    else
-                        tlv = ogs_tlv_add(tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-
-                    r = tlv_add_compound(&emb_tlv, tlv, desc,
-                            p + offset2 + sizeof(ogs_tlv_presence_t),
-                            depth + 1, mode);
-                    if (r <= 0 || !emb_tlv) {
-                        ogs_error("tlv_add_compound() failed");
-                        return 0;
-                    }
-                    count += 1 + r;
-                } else {
-                    ogs_trace("BUILD %sL#%d [%s] T:%d L:%d I:%d "
-                            "(cls:%d vsz:%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->length,
-                            desc->instance, desc->ctype, desc->vsize,
-                            p + offset2);
-
-                    tlv = tlv_add_leaf(parent_tlv, tlv, desc,
-                            p + offset2, mode);
-                    if (!tlv) {
-                        ogs_error("tlv_add_leaf() failed");
-                        return 0;
-                    }
-                    count++;
-                }
-
-                if (*root == NULL)
-                    *root = tlv;
+                r = tlv_put_element(pos ? pos + length : NULL, count,
+                        desc, p + offset2, depth, mode);
+                if (r < 0)
+                    return -1;
+                length += r;
 
                 offset2 += desc->vsize;
             }
@@ -360,57 +345,29 @@ static uint32_t tlv_add_compound(ogs_tlv_t **root, ogs_tlv_t *parent_tlv,
             presence_p = (ogs_tlv_presence_t *)(p + offset);
 
             if (*presence_p) {
-                if (desc->ctype == OGS_TLV_COMPOUND) {
-                    ogs_trace("BUILD %sC#%d [%s] T:%d I:%d (vsz=%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->instance,
-                            desc->vsize, p + offset);
-
-                    if (parent_tlv)
-                        tlv = ogs_tlv_embed(parent_tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-                    else
-                        tlv = ogs_tlv_add(tlv,
-                                tlv_ctype2mode(desc->ctype, mode),
-                                desc->type, 0, desc->instance, NULL);
-
-                    r = tlv_add_compound(&emb_tlv, tlv, desc,
-                            p + offset + sizeof(ogs_tlv_presence_t),
-                            depth + 1, mode);
-                    if (r <= 0 || !emb_tlv) {
-                        ogs_error("tlv_add_compound() failed");
-                        return 0;
-                    }
-                    count += 1 + r;
-                } else {
-                    ogs_trace("BUILD %sL#%d [%s] T:%d L:%d I:%d "
-                            "(cls:%d vsz:%d) off:%p ",
-                            indent, i, desc->name, desc->type, desc->length,
-                            desc->instance, desc->ctype, desc->vsize,
-                            p + offset);
-
-                    tlv = tlv_add_leaf(parent_tlv, tlv, desc, p + offset, mode);
-                    if (!tlv) {
-                        ogs_error("tlv_add_leaf() failed");
-                        return 0;
-                    }
-                    count++;
-                }
-
-                if (*root == NULL)
-                    *root = tlv;
+                r = tlv_put_element(pos ? pos + length : NULL, count,
+                        desc, p + offset, depth, mode);
+                if (r < 0)
+                    return -1;
+                length += r;
             }
             offset += desc->vsize;
         }
     }
 
-    return count;
+    return length;
 }
 
+/*
+ * The message is encoded straight from its descriptor into the packet
+ * buffer. A first walk with no output computes the exact length so that
+ * the buffer can be allocated once; the second walk writes the bytes.
+ * No intermediate ogs_tlv_t tree is built.
+ */
 ogs_pkbuf_t *ogs_tlv_build_msg(ogs_tlv_desc_t *desc, void *msg, int mode)
 {
-    ogs_tlv_t *root = NULL;
-    uint32_t r, length, rendlen;
+    uint32_t count = 0;
+    int length = 0, rendlen;
     ogs_pkbuf_t *pkbuf = NULL;
 
     ogs_assert(desc);
@@ -419,16 +376,13 @@ ogs_pkbuf_t *ogs_tlv_build_msg(ogs_tlv_desc_t *desc, void *msg, int mode)
     ogs_assert(desc->ctype == OGS_TLV_MESSAGE);
 
     if (desc->child_descs[0]) {
-        r = tlv_add_compound(&root, NULL, desc, msg, 0, mode);
-        if (r <= 0 || !root) {
-            ogs_error("tlv_add_compound() failed");
+        length = tlv_put_compound(NULL, &count, desc, msg, 0, mode);
+        if (length < 0 || count == 0) {
+            ogs_error("tlv_put_compound() failed");
             return NULL;
         }
-
-        length = ogs_tlv_calc_length(root);
-    } else {
-        length = 0;
     }
+
     pkbuf = ogs_pkbuf_alloc(NULL, OGS_TLV_MAX_HEADROOM+length);
     if (!pkbuf) {
         ogs_error("ogs_pkbuf_alloc() failed");
@@ -438,14 +392,14 @@ ogs_pkbuf_t *ogs_tlv_build_msg(ogs_tlv_desc_t *desc, void *msg, int mode)
     ogs_pkbuf_put(pkbuf, length);
 
     if (desc->child_descs[0]) {
-        rendlen = ogs_tlv_render(root, pkbuf->data, length);
+        count = 0;
+        rendlen = tlv_put_compound(pkbuf->data, &count, desc, msg, 0, mode);
         if (rendlen != length) {
-            ogs_error("ogs_tlv_render[rendlen:%d != length:%d] failed",
+            ogs_error("tlv_put_compound[rendlen:%d != length:%d] failed",
                     rendlen, length);
+            ogs_pkbuf_free(pkbuf);
             return NULL;
         }
-
-        ogs_tlv_free_all(root);
     }
 
     return pkbuf;
@@ -36,6 +36,20 @@
 extern "C" {
 #endif
 
+/*
+ * Expanded AES-128 key schedule and CMAC subkeys (K1, K2).
+ * They only depend on the key, so they can be computed once with
+ * ogs_aes_cmac_setup() and reused for every message under that key.
+ */
+typedef struct ogs_aes_cmac_ctx_s {
+    uint32_t rk[OGS_AES_RKLENGTH(128)];
+    int nrounds;
+    uint8_t k1[16];
+    uint8_t k2[16];
+} ogs_aes_cmac_ctx_t;
+
+void ogs_aes_cmac_setup(ogs_aes_cmac_ctx_t *ctx, const uint8_t *key);
+
 /**
  * Caculate CMAC value
  *
@@ -49,6 +63,8 @@ extern "C" {
  */
 int ogs_aes_cmac_calculate(uint8_t *cmac, const uint8_t *key,
         const uint8_t *msg, const uint32_t len);
+int ogs_aes_cmac_calculate_with_ctx(uint8_t *cmac,
+        const ogs_aes_cmac_ctx_t *ctx, const uint8_t *msg, const uint32_t len);
 
 /**
  * Verify CMAC value
@@ -1420,23 +1420,33 @@ int ogs_aes_ctr128_encrypt(const uint8_t *key,
         uint8_t *ivec, const uint8_t *in, const uint32_t inlen,
         uint8_t *out)
 {
-    uint8_t ecount_buf[16];
-    uint32_t len = inlen;
-
     uint32_t rk[OGS_AES_RKLENGTH(OGS_AES_MAX_KEY_BITS)];
     int nrounds;
 
+    ogs_assert(key);
+
+    nrounds = ogs_aes_setup_enc(rk, key, 128);
+
+    return ogs_aes_ctr128_encrypt_with_rk(rk, nrounds, ivec, in, inlen, out);
+}
+
+int ogs_aes_ctr128_encrypt_with_rk(const uint32_t *rk, int nrounds,
+        uint8_t *ivec, const uint8_t *in, const uint32_t inlen,
+        uint8_t *out)
+{
+    uint8_t ecount_buf[16];
+    uint32_t len = inlen;
+
     uint32_t n = 0;
     size_t l = 0;
 
-    ogs_assert(key);
+    ogs_assert(rk);
     ogs_assert(ivec);
     ogs_assert(in);
     ogs_assert(len);
     ogs_assert(out);
 
     memset(ecount_buf, 0, 16);
-    nrounds = ogs_aes_setup_enc(rk, key, 128);
 
     while (n && len) 
     {
@@ -554,6 +554,8 @@ int ogs_gtp_context_parse_config(const char *local, const char *remote)
 
                             } while (ogs_yaml_iter_type(&server_array) ==
                                     YAML_SEQUENCE_NODE);
+                        } else if (!strcmp(gtpu_key, "batch")) {
+                            self.batch = ogs_yaml_iter_bool(&gtpu_iter);
                         } else
                             ogs_warn("unknown key `%s`", gtpu_key);
                     }
@@ -20,6 +20,8 @@
 #ifndef OGS_GTP_H
 #define OGS_GTP_H
 
+#include "gtp/gtp-config.h"
+
 #include "ipfw/ogs-ipfw.h"
 #include "proto/ogs-proto.h"
 #include "app/ogs-app.h"
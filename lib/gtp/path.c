@@ -129,6 +129,258 @@ int ogs_gtp_sendto(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf)
     return OGS_OK;
 }
 
+#if HAVE_RECVMMSG
+/*
+ * Receive buffers left unused by the previous ogs_gtpu_recvmmsg().
+ * They are handed out again on the next wakeup, so only the pkbufs
+ * the caller actually consumed have to be allocated.
+ */
+static struct {
+    ogs_pkbuf_pool_t *pool;
+    int headroom;
+    int num;
+    ogs_pkbuf_t *pkbuf[OGS_GTPU_MAX_RECV_BATCH];
+} recvq;
+#endif
+
+/*
+ * ogs_gtpu_recvmmsg
+ *
+ * Drains up to 'max' GTP-U datagrams queued on the socket 'fd' with
+ * a single system call where recvmmsg() is available. Each pkbuf is taken
+ * from 'pool' with 'headroom' bytes reserved in front of the datagram,
+ * so that a new header can be pushed without copying the payload.
+ *
+ * Returns the number of datagrams stored in 'pkbuf' and 'from'.
+ */
+int ogs_gtpu_recvmmsg(ogs_socket_t fd,
+        ogs_pkbuf_pool_t *pool, int headroom,
+        ogs_pkbuf_t *pkbuf[], ogs_sockaddr_t from[], int max)
+{
+#if HAVE_RECVMMSG
+    struct mmsghdr msg[OGS_GTPU_MAX_RECV_BATCH];
+    struct iovec iov[OGS_GTPU_MAX_RECV_BATCH];
+    ogs_pkbuf_t *recvbuf[OGS_GTPU_MAX_RECV_BATCH];
+    int i, n, num = 0;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(pkbuf);
+    ogs_assert(from);
+    ogs_assert(max > 0 && max <= OGS_GTPU_MAX_RECV_BATCH);
+
+    if (recvq.pool != pool || recvq.headroom != headroom) {
+        ogs_gtpu_recvbuf_flush();
+        recvq.pool = pool;
+        recvq.headroom = headroom;
+    }
+
+    memset(msg, 0, sizeof(msg[0]) * max);
+    for (i = 0; i < max; i++) {
+        if (recvq.num) {
+            recvbuf[i] = recvq.pkbuf[--recvq.num];
+        } else {
+            recvbuf[i] = ogs_pkbuf_alloc(pool, OGS_MAX_PKT_LEN);
+            if (recvbuf[i] == NULL) {
+                ogs_error("ogs_pkbuf_alloc() failed");
+                break;
+            }
+            ogs_pkbuf_reserve(recvbuf[i], headroom);
+            ogs_pkbuf_put(recvbuf[i], OGS_MAX_PKT_LEN-headroom);
+        }
+
+        iov[i].iov_base = recvbuf[i]->data;
+        iov[i].iov_len = recvbuf[i]->len;
+
+        memset(&from[i], 0, sizeof(from[i]));
+        msg[i].msg_hdr.msg_name = &from[i].sa;
+        msg[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+        msg[i].msg_hdr.msg_iov = &iov[i];
+        msg[i].msg_hdr.msg_iovlen = 1;
+    }
+    max = i;
+
+    n = max ? recvmmsg(fd, msg, max, MSG_DONTWAIT, NULL) : 0;
+    if (n < 0) {
+        if (ogs_socket_errno != OGS_EAGAIN)
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "recvmmsg() failed");
+        n = 0;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (msg[i].msg_len == 0) {
+            recvq.pkbuf[recvq.num++] = recvbuf[i];
+            continue;
+        }
+        ogs_pkbuf_trim(recvbuf[i], msg[i].msg_len);
+
+        if (num != i)
+            memcpy(&from[num], &from[i], sizeof(from[num]));
+        pkbuf[num++] = recvbuf[i];
+    }
+    /* Untouched buffers are kept for the next call */
+    for (i = n; i < max; i++)
+        recvq.pkbuf[recvq.num++] = recvbuf[i];
+
+    return num;
+#else
+    ssize_t size;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(pkbuf);
+    ogs_assert(from);
+    ogs_assert(max > 0);
+
+    pkbuf[0] = ogs_pkbuf_alloc(pool, OGS_MAX_PKT_LEN);
+    if (pkbuf[0] == NULL) {
+        ogs_error("ogs_pkbuf_alloc() failed");
+        return 0;
+    }
+    ogs_pkbuf_reserve(pkbuf[0], headroom);
+    ogs_pkbuf_put(pkbuf[0], OGS_MAX_PKT_LEN-headroom);
+
+    size = ogs_recvfrom(fd, pkbuf[0]->data, pkbuf[0]->len, 0, &from[0]);
+    if (size <= 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "ogs_recv() failed");
+        ogs_pkbuf_free(pkbuf[0]);
+        return 0;
+    }
+    ogs_pkbuf_trim(pkbuf[0], size);
+
+    return 1;
+#endif
+}
+
+/*
+ * Returns the receive buffers kept by ogs_gtpu_recvmmsg() to their pool.
+ * Must be called before that pool is destroyed.
+ */
+void ogs_gtpu_recvbuf_flush(void)
+{
+#if HAVE_RECVMMSG
+    while (recvq.num)
+        ogs_pkbuf_free(recvq.pkbuf[--recvq.num]);
+    recvq.pool = NULL;
+#endif
+}
+
+/*
+ * G-PDUs held until ogs_gtpu_flush()
+ * when 'gtpu.batch' is enabled in the configuration.
+ */
+static struct {
+    int num;
+    struct {
+        ogs_socket_t fd;
+        ogs_sockaddr_t addr;
+        ogs_pkbuf_t *pkbuf;
+    } msg[OGS_GTPU_MAX_SEND_BATCH];
+} sendq;
+
+/*
+ * Sends a GTP-U packet to the peer and frees the pkbuf.
+ *
+ * If 'gtpu.batch' is enabled, the pkbuf is queued instead and sent
+ * by the next ogs_gtpu_flush() together with the other queued packets.
+ */
+int ogs_gtpu_sendto(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf)
+{
+    int rv;
+
+    ogs_assert(gnode);
+    ogs_assert(gnode->sock);
+    ogs_assert(pkbuf);
+
+    if (ogs_gtp_self()->batch) {
+        if (sendq.num == OGS_GTPU_MAX_SEND_BATCH)
+            ogs_gtpu_flush();
+
+        sendq.msg[sendq.num].fd = gnode->sock->fd;
+        memcpy(&sendq.msg[sendq.num].addr, &gnode->addr, sizeof(gnode->addr));
+        sendq.msg[sendq.num].pkbuf = pkbuf;
+        sendq.num++;
+
+        return OGS_OK;
+    }
+
+    rv = ogs_gtp_sendto(gnode, pkbuf);
+    ogs_pkbuf_free(pkbuf);
+
+    return rv;
+}
+
+void ogs_gtpu_flush(void)
+{
+    char buf[OGS_ADDRSTRLEN];
+    int i;
+#if HAVE_SENDMMSG
+    struct mmsghdr msg[OGS_GTPU_MAX_SEND_BATCH];
+    struct iovec iov[OGS_GTPU_MAX_SEND_BATCH];
+    int j, k, n;
+#endif
+
+    if (sendq.num == 0)
+        return;
+
+#if HAVE_SENDMMSG
+    memset(msg, 0, sizeof(msg[0]) * sendq.num);
+    for (i = 0; i < sendq.num; i++) {
+        iov[i].iov_base = sendq.msg[i].pkbuf->data;
+        iov[i].iov_len = sendq.msg[i].pkbuf->len;
+
+        msg[i].msg_hdr.msg_name = &sendq.msg[i].addr.sa;
+        msg[i].msg_hdr.msg_namelen = ogs_sockaddr_len(&sendq.msg[i].addr);
+        msg[i].msg_hdr.msg_iov = &iov[i];
+        msg[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    /* One system call for each run of packets on the same socket */
+    for (i = 0; i < sendq.num; i = j) {
+        for (j = i + 1; j < sendq.num; j++)
+            if (sendq.msg[j].fd != sendq.msg[i].fd)
+                break;
+
+        /*
+         * sendmmsg() stops at the first message it cannot send. Resume
+         * from there; when the failing message comes first, its error
+         * is reported and only that message is skipped.
+         */
+        for (k = i; k < j; k += n) {
+            n = sendmmsg(sendq.msg[k].fd, &msg[k], j - k, 0);
+            if (n > 0)
+                continue;
+
+            if (ogs_socket_errno != OGS_EAGAIN)
+                ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                        "sendmmsg(%u, %u) failed [%s]:%u",
+                        sendq.msg[k].fd, sendq.msg[k].pkbuf->len,
+                        OGS_ADDR(&sendq.msg[k].addr, buf),
+                        OGS_PORT(&sendq.msg[k].addr));
+            n = 1;
+        }
+    }
+#else
+    for (i = 0; i < sendq.num; i++) {
+        ssize_t sent = ogs_sendto(sendq.msg[i].fd,
+                sendq.msg[i].pkbuf->data, sendq.msg[i].pkbuf->len, 0,
+                &sendq.msg[i].addr);
+        if (sent < 0 || sent != sendq.msg[i].pkbuf->len) {
+            if (ogs_socket_errno != OGS_EAGAIN)
+                ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                        "ogs_sendto(%u, %u) failed [%s]:%u",
+                        sendq.msg[i].fd, sendq.msg[i].pkbuf->len,
+                        OGS_ADDR(&sendq.msg[i].addr, buf),
+                        OGS_PORT(&sendq.msg[i].addr));
+        }
+    }
+#endif
+
+    for (i = 0; i < sendq.num; i++)
+        ogs_pkbuf_free(sendq.msg[i].pkbuf);
+    sendq.num = 0;
+}
+
 void ogs_gtp_send_error_message(
         ogs_gtp_xact_t *xact, uint32_t teid, uint8_t type, uint8_t cause_value)
 {
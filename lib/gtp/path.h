@@ -28,6 +28,11 @@
 extern "C" {
 #endif
 
+/* GTP-U datagrams drained from a socket per wakeup */
+#define OGS_GTPU_MAX_RECV_BATCH 32
+/* G-PDUs held before 'gtpu.batch' forces a flush */
+#define OGS_GTPU_MAX_SEND_BATCH 64
+
 #define OGS_SETUP_GTPC_SERVER \
     do { \
         ogs_gtp_self()->gtpc_sock = \
@@ -68,6 +73,13 @@ int ogs_gtp_connect(ogs_sock_t *ipv4, ogs_sock_t *ipv6, ogs_gtp_node_t *gnode);
 int ogs_gtp_send(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf);
 int ogs_gtp_sendto(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf);
 
+int ogs_gtpu_recvmmsg(ogs_socket_t fd,
+        ogs_pkbuf_pool_t *pool, int headroom,
+        ogs_pkbuf_t *pkbuf[], ogs_sockaddr_t from[], int max);
+void ogs_gtpu_recvbuf_flush(void);
+int ogs_gtpu_sendto(ogs_gtp_node_t *gnode, ogs_pkbuf_t *pkbuf);
+void ogs_gtpu_flush(void);
+
 void ogs_gtp_send_error_message(
         ogs_gtp_xact_t *xact, uint32_t teid, uint8_t type, uint8_t cause_value);
 
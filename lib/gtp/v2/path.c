@@ -19,59 +19,70 @@
 
 #include "ogs-gtp.h"
 
-int ogs_gtp2_send_user_plane(
-        ogs_gtp_node_t *gnode,
-        ogs_gtp2_header_desc_t *header_desc,
-        ogs_pkbuf_t *pkbuf)
+static void header_desc_to_header(ogs_gtp2_header_desc_t *header_desc,
+        ogs_gtp2_header_t *gtp_hdesc, ogs_gtp2_extension_header_t *ext_hdesc)
 {
-    char buf[OGS_ADDRSTRLEN];
-    int rv, i;
-
-    ogs_gtp2_header_t gtp_hdesc;
-    ogs_gtp2_extension_header_t ext_hdesc;
+    int i;
 
     ogs_assert(header_desc);
+    ogs_assert(gtp_hdesc);
+    ogs_assert(ext_hdesc);
 
-    memset(&gtp_hdesc, 0, sizeof(gtp_hdesc));
-    memset(&ext_hdesc, 0, sizeof(ext_hdesc));
+    memset(gtp_hdesc, 0, sizeof(*gtp_hdesc));
+    memset(ext_hdesc, 0, sizeof(*ext_hdesc));
 
-    gtp_hdesc.flags = header_desc->flags;
-    gtp_hdesc.type = header_desc->type;
-    gtp_hdesc.teid = header_desc->teid;
+    gtp_hdesc->flags = header_desc->flags;
+    gtp_hdesc->type = header_desc->type;
+    gtp_hdesc->teid = header_desc->teid;
 
     i = 0;
 
     if (header_desc->qos_flow_identifier) {
-        ext_hdesc.array[i].type =
+        ext_hdesc->array[i].type =
             OGS_GTP2_EXTENSION_HEADER_TYPE_PDU_SESSION_CONTAINER;
-        ext_hdesc.array[i].len = 1;
-        ext_hdesc.array[i].pdu_type = header_desc->pdu_type;
-        ext_hdesc.array[i].qos_flow_identifier =
+        ext_hdesc->array[i].len = 1;
+        ext_hdesc->array[i].pdu_type = header_desc->pdu_type;
+        ext_hdesc->array[i].qos_flow_identifier =
             header_desc->qos_flow_identifier;
         i++;
     }
 
     if (header_desc->udp.presence == true) {
-        ext_hdesc.array[i].type = OGS_GTP2_EXTENSION_HEADER_TYPE_UDP_PORT;
-        ext_hdesc.array[i].len = 1;
-        ext_hdesc.array[i].udp_port = htobe16(header_desc->udp.port);
+        ext_hdesc->array[i].type = OGS_GTP2_EXTENSION_HEADER_TYPE_UDP_PORT;
+        ext_hdesc->array[i].len = 1;
+        ext_hdesc->array[i].udp_port = htobe16(header_desc->udp.port);
         i++;
     }
 
     if (header_desc->pdcp_number_presence == true) {
-        ext_hdesc.array[i].type = OGS_GTP2_EXTENSION_HEADER_TYPE_PDCP_NUMBER;
-        ext_hdesc.array[i].len = 1;
-        ext_hdesc.array[i].pdcp_number = htobe16(header_desc->pdcp_number);
+        ext_hdesc->array[i].type = OGS_GTP2_EXTENSION_HEADER_TYPE_PDCP_NUMBER;
+        ext_hdesc->array[i].len = 1;
+        ext_hdesc->array[i].pdcp_number = htobe16(header_desc->pdcp_number);
         i++;
     }
+}
 
+int ogs_gtp2_send_user_plane(
+        ogs_gtp_node_t *gnode,
+        ogs_gtp2_header_desc_t *header_desc,
+        ogs_pkbuf_t *pkbuf)
+{
+    char buf[OGS_ADDRSTRLEN];
+    int rv;
+
+    ogs_gtp2_header_t gtp_hdesc;
+    ogs_gtp2_extension_header_t ext_hdesc;
+
+    ogs_assert(header_desc);
+
+    header_desc_to_header(header_desc, &gtp_hdesc, &ext_hdesc);
     ogs_gtp2_fill_header(&gtp_hdesc, &ext_hdesc, pkbuf);
 
     ogs_trace("SEND GTP-U[%d] to Peer[%s] : TEID[0x%x]",
             header_desc->type,
             OGS_ADDR(&gnode->addr, buf), header_desc->teid);
 
-    rv = ogs_gtp_sendto(gnode, pkbuf);
+    rv = ogs_gtpu_sendto(gnode, pkbuf);
     if (rv != OGS_OK) {
         if (ogs_socket_errno != OGS_EAGAIN) {
             ogs_error("SEND GTP-U[%d] to Peer[%s] : TEID[0x%x]",
@@ -80,7 +91,73 @@ int ogs_gtp2_send_user_plane(
         }
     }
 
+    return rv;
+}
+
+void ogs_gtp2_build_header_template(
+        ogs_gtp2_header_template_t *tmpl,
+        ogs_gtp2_header_desc_t *header_desc)
+{
+    ogs_gtp2_header_t gtp_hdesc;
+    ogs_gtp2_extension_header_t ext_hdesc;
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    ogs_assert(tmpl);
+    ogs_assert(header_desc);
+
+    header_desc_to_header(header_desc, &gtp_hdesc, &ext_hdesc);
+
+    /* Encode the header on an empty payload and keep the bytes */
+    pkbuf = ogs_pkbuf_alloc(NULL, OGS_GTP2_HEADER_TEMPLATE_LEN);
+    ogs_assert(pkbuf);
+    ogs_pkbuf_reserve(pkbuf, OGS_GTP2_HEADER_TEMPLATE_LEN);
+
+    ogs_gtp2_fill_header(&gtp_hdesc, &ext_hdesc, pkbuf);
+    ogs_assert(pkbuf->len <= OGS_GTP2_HEADER_TEMPLATE_LEN);
+
+    memcpy(tmpl->data, pkbuf->data, pkbuf->len);
+    tmpl->len = pkbuf->len;
+
     ogs_pkbuf_free(pkbuf);
+}
+
+int ogs_gtp2_send_user_plane_with_template(
+        ogs_gtp_node_t *gnode,
+        ogs_gtp2_header_template_t *tmpl,
+        ogs_pkbuf_t *pkbuf)
+{
+    char buf[OGS_ADDRSTRLEN];
+    int rv;
+
+    ogs_gtp2_header_t *gtp_h = NULL;
+    uint8_t type;
+    uint32_t teid;
+
+    ogs_assert(gnode);
+    ogs_assert(tmpl);
+    ogs_assert(tmpl->len >= OGS_GTPV1U_HEADER_LEN);
+    ogs_assert(pkbuf);
+
+    ogs_assert(ogs_pkbuf_push(pkbuf, tmpl->len));
+    memcpy(pkbuf->data, tmpl->data, tmpl->len);
+
+    gtp_h = (ogs_gtp2_header_t *)pkbuf->data;
+    gtp_h->length = htobe16(pkbuf->len - OGS_GTPV1U_HEADER_LEN);
+
+    /* The pkbuf is no longer ours once it is handed to ogs_gtpu_sendto() */
+    type = gtp_h->type;
+    teid = be32toh(gtp_h->teid);
+
+    ogs_trace("SEND GTP-U[%d] to Peer[%s] : TEID[0x%x]",
+            type, OGS_ADDR(&gnode->addr, buf), teid);
+
+    rv = ogs_gtpu_sendto(gnode, pkbuf);
+    if (rv != OGS_OK) {
+        if (ogs_socket_errno != OGS_EAGAIN) {
+            ogs_error("SEND GTP-U[%d] to Peer[%s] : TEID[0x%x]",
+                type, OGS_ADDR(&gnode->addr, buf), teid);
+        }
+    }
 
     return rv;
 }
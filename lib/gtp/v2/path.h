@@ -35,6 +35,14 @@ int ogs_gtp2_send_user_plane(
         ogs_gtp2_header_desc_t *header_desc,
         ogs_pkbuf_t *pkbuf);
 
+void ogs_gtp2_build_header_template(
+        ogs_gtp2_header_template_t *tmpl,
+        ogs_gtp2_header_desc_t *header_desc);
+int ogs_gtp2_send_user_plane_with_template(
+        ogs_gtp_node_t *gnode,
+        ogs_gtp2_header_template_t *tmpl,
+        ogs_pkbuf_t *pkbuf);
+
 ogs_pkbuf_t *ogs_gtp2_handle_echo_req(ogs_pkbuf_t *pkb);
 void ogs_gtp2_send_error_message(
         ogs_gtp_xact_t *xact, uint32_t teid, uint8_t type, uint8_t cause_value);
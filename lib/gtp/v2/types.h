@@ -95,6 +95,18 @@ typedef struct ogs_gtp2_header_desc_s {
     uint16_t pdcp_number;
 } ogs_gtp2_header_desc_t;
 
+/*
+ * GTP-U header (with extension headers) pre-built from a header_desc.
+ * Only the Length field has to be patched for each packet.
+ */
+#define OGS_GTP2_HEADER_TEMPLATE_LEN \
+    (OGS_GTPV1U_HEADER_LEN + OGS_GTPV1U_EXTENSION_HEADER_LEN + \
+     OGS_GTP2_NUM_OF_EXTENSION_HEADER * OGS_GTP2_MAX_EXTENSION_HEADER_LEN)
+typedef struct ogs_gtp2_header_template_s {
+    uint8_t len;
+    uint8_t data[OGS_GTP2_HEADER_TEMPLATE_LEN];
+} ogs_gtp2_header_template_t;
+
 /* 8.4 Cause */
 #define OGS_GTP2_CAUSE_UNDEFINED_VALUE 0
 #define OGS_GTP2_CAUSE_LOCAL_DETACH 2
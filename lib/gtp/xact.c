@@ -32,6 +32,7 @@ static int ogs_gtp_xact_initialized = 0;
 static uint32_t g_xact_id = 0;
 
 static OGS_POOL(pool, ogs_gtp_xact_t);
+static ogs_hash_t *xact_hash = NULL;
 
 static ogs_gtp_xact_t *ogs_gtp_xact_remote_create(ogs_gtp_node_t *gnode, uint8_t gtp_version, uint32_t sqn);
 static ogs_gtp_xact_stage_t ogs_gtp2_xact_get_stage(uint8_t type, uint32_t xid);
@@ -43,11 +44,50 @@ static void response_timeout(void *data);
 static void holding_timeout(void *data);
 static void peer_timeout(void *data);
 
+static void xact_hash_add(ogs_gtp_xact_t *xact)
+{
+    ogs_gtp_xact_t *old = NULL;
+
+    xact->key.gnode = xact->gnode;
+    xact->key.xid = xact->xid;
+    xact->key.org = xact->org;
+    xact->key.gtp_version = xact->gtp_version;
+
+    /* A reused sequence number takes over the index entry */
+    old = ogs_hash_get(xact_hash, &xact->key, sizeof(xact->key));
+    if (old)
+        ogs_hash_set(xact_hash, &old->key, sizeof(old->key), NULL);
+
+    ogs_hash_set(xact_hash, &xact->key, sizeof(xact->key), xact);
+}
+
+static void xact_hash_remove(ogs_gtp_xact_t *xact)
+{
+    if (ogs_hash_get(xact_hash, &xact->key, sizeof(xact->key)) == xact)
+        ogs_hash_set(xact_hash, &xact->key, sizeof(xact->key), NULL);
+}
+
+static ogs_gtp_xact_t *xact_hash_find(ogs_gtp_node_t *gnode,
+        uint8_t gtp_version, uint8_t org, uint32_t xid)
+{
+    ogs_gtp_xact_key_t key;
+
+    memset(&key, 0, sizeof(key));
+    key.gnode = gnode;
+    key.xid = xid;
+    key.org = org;
+    key.gtp_version = gtp_version;
+
+    return ogs_hash_get(xact_hash, &key, sizeof(key));
+}
+
 int ogs_gtp_xact_init(void)
 {
     ogs_assert(ogs_gtp_xact_initialized == 0);
 
     ogs_pool_init(&pool, ogs_app()->pool.xact);
+    xact_hash = ogs_hash_make();
+    ogs_assert(xact_hash);
 
     g_xact_id = 0;
 
@@ -60,6 +100,7 @@ void ogs_gtp_xact_final(void)
 {
     ogs_assert(ogs_gtp_xact_initialized == 1);
 
+    ogs_hash_destroy(xact_hash);
     ogs_pool_final(&pool);
 
     ogs_gtp_xact_initialized = 0;
@@ -106,6 +147,7 @@ ogs_gtp_xact_t *ogs_gtp1_xact_local_create(ogs_gtp_node_t *gnode,
     xact->holding_rcount = ogs_local_conf()->time.message.gtp.n3_holding_rcount;
 
     ogs_list_add(&xact->gnode->local_list, xact);
+    xact_hash_add(xact);
 
     rv = ogs_gtp1_xact_update_tx(xact, hdesc, pkbuf);
     if (rv != OGS_OK) {
@@ -168,6 +210,7 @@ ogs_gtp_xact_t *ogs_gtp_xact_local_create(ogs_gtp_node_t *gnode,
     ogs_assert(xact->tm_peer);
 
     ogs_list_add(&xact->gnode->local_list, xact);
+    xact_hash_add(xact);
 
     rv = ogs_gtp_xact_update_tx(xact, hdesc, pkbuf);
     if (rv != OGS_OK) {
@@ -219,6 +262,7 @@ static ogs_gtp_xact_t *ogs_gtp_xact_remote_create(ogs_gtp_node_t *gnode, uint8_t
     ogs_assert(xact->tm_peer);
 
     ogs_list_add(&xact->gnode->remote_list, xact);
+    xact_hash_add(xact);
 
     ogs_debug("[%d] REMOTE Create  peer [%s]:%d",
             xact->xid,
@@ -875,7 +919,7 @@ int ogs_gtp1_xact_receive(
     uint8_t type;
     uint32_t sqn, xid;
     ogs_gtp_xact_stage_t stage;
-    ogs_list_t *list = NULL;
+    uint8_t org;
     ogs_gtp_xact_t *new = NULL;
 
     ogs_assert(gnode);
@@ -894,19 +938,19 @@ int ogs_gtp1_xact_receive(
 
     switch (stage) {
     case GTP_XACT_INITIAL_STAGE:
-        list = &gnode->remote_list;
+        org = OGS_GTP_REMOTE_ORIGINATOR;
         break;
     case GTP_XACT_INTERMEDIATE_STAGE:
-        list = &gnode->local_list;
+        org = OGS_GTP_LOCAL_ORIGINATOR;
         break;
     case GTP_XACT_FINAL_STAGE:
         /* For types which are replies to replies, the xact is never locally
          * created during transmit, but actually during rx of the initial req, hence
          * it is never placed in the local_list, but in the remote_list. */
         if (type == OGS_GTP1_SGSN_CONTEXT_ACKNOWLEDGE_TYPE)
-            list = &gnode->remote_list;
+            org = OGS_GTP_REMOTE_ORIGINATOR;
         else
-            list = &gnode->local_list;
+            org = OGS_GTP_LOCAL_ORIGINATOR;
         break;
     default:
         ogs_error("[%d] Unexpected type %u from GTPv1 peer [%s]:%d",
@@ -914,17 +958,14 @@ int ogs_gtp1_xact_receive(
         return OGS_ERROR;
     }
 
-    ogs_assert(list);
-    ogs_list_for_each(list, new) {
-        if (new->gtp_version == 1 && new->xid == xid) {
-            ogs_debug("[%d] %s Find GTPv%u peer [%s]:%d",
-                    new->xid,
-                    new->org == OGS_GTP_LOCAL_ORIGINATOR ? "LOCAL " : "REMOTE",
-                    new->gtp_version,
-                    OGS_ADDR(&gnode->addr, buf),
-                    OGS_PORT(&gnode->addr));
-            break;
-        }
+    new = xact_hash_find(gnode, 1, org, xid);
+    if (new) {
+        ogs_debug("[%d] %s Find GTPv%u peer [%s]:%d",
+                new->xid,
+                new->org == OGS_GTP_LOCAL_ORIGINATOR ? "LOCAL " : "REMOTE",
+                new->gtp_version,
+                OGS_ADDR(&gnode->addr, buf),
+                OGS_PORT(&gnode->addr));
     }
 
     if (!new) {
@@ -962,7 +1003,7 @@ int ogs_gtp_xact_receive(
     uint8_t type;
     uint32_t sqn, xid;
     ogs_gtp_xact_stage_t stage;
-    ogs_list_t *list = NULL;
+    uint8_t org;
     ogs_gtp_xact_t *new = NULL;
 
     ogs_assert(gnode);
@@ -978,22 +1019,22 @@ int ogs_gtp_xact_receive(
 
     switch (stage) {
     case GTP_XACT_INITIAL_STAGE:
-        list = &gnode->remote_list;
+        org = OGS_GTP_REMOTE_ORIGINATOR;
         break;
     case GTP_XACT_INTERMEDIATE_STAGE:
-        list = &gnode->local_list;
+        org = OGS_GTP_LOCAL_ORIGINATOR;
         break;
     case GTP_XACT_FINAL_STAGE:
         if (xid & OGS_GTP_CMD_XACT_ID) {
             if (type == OGS_GTP2_MODIFY_BEARER_FAILURE_INDICATION_TYPE ||
                 type == OGS_GTP2_DELETE_BEARER_FAILURE_INDICATION_TYPE ||
                 type == OGS_GTP2_BEARER_RESOURCE_FAILURE_INDICATION_TYPE) {
-                list = &gnode->local_list;
+                org = OGS_GTP_LOCAL_ORIGINATOR;
             } else {
-                list = &gnode->remote_list;
+                org = OGS_GTP_REMOTE_ORIGINATOR;
             }
         } else {
-            list = &gnode->local_list;
+            org = OGS_GTP_LOCAL_ORIGINATOR;
         }
         break;
     default:
@@ -1002,17 +1043,14 @@ int ogs_gtp_xact_receive(
         return OGS_ERROR;
     }
 
-    ogs_assert(list);
-    ogs_list_for_each(list, new) {
-        if (new->gtp_version == 2 && new->xid == xid) {
-            ogs_debug("[%d] %s Find GTPv%u peer [%s]:%d",
-                    new->xid,
-                    new->org == OGS_GTP_LOCAL_ORIGINATOR ? "LOCAL " : "REMOTE",
-                    new->gtp_version,
-                    OGS_ADDR(&gnode->addr, buf),
-                    OGS_PORT(&gnode->addr));
-            break;
-        }
+    new = xact_hash_find(gnode, 2, org, xid);
+    if (new) {
+        ogs_debug("[%d] %s Find GTPv%u peer [%s]:%d",
+                new->xid,
+                new->org == OGS_GTP_LOCAL_ORIGINATOR ? "LOCAL " : "REMOTE",
+                new->gtp_version,
+                OGS_ADDR(&gnode->addr, buf),
+                OGS_PORT(&gnode->addr));
     }
 
     if (!new) {
@@ -1230,6 +1268,7 @@ static int ogs_gtp_xact_delete(ogs_gtp_xact_t *xact)
     if (assoc_xact)
         ogs_gtp_xact_deassociate(xact, assoc_xact);
 
+    xact_hash_remove(xact);
     ogs_list_remove(xact->org == OGS_GTP_LOCAL_ORIGINATOR ?
             &xact->gnode->local_list : &xact->gnode->remote_list, xact);
     ogs_pool_id_free(&pool, xact);
@@ -53,6 +53,16 @@ extern "C" {
 #define OGS_GTP1_MIN_XACT_ID             0
 #define OGS_GTP1_MAX_XACT_ID             65535
 
+/**
+ * Key of the transaction index
+ */
+typedef struct ogs_gtp_xact_key_s {
+    ogs_gtp_node_t  *gnode;
+    uint32_t        xid;
+    uint8_t         org;
+    uint8_t         gtp_version;
+} ogs_gtp_xact_key_t;
+
 /**
  * Transaction context
  */
@@ -91,6 +101,7 @@ typedef struct ogs_gtp_xact_s {
 
     uint32_t        xid;            /**< Transaction ID */
     ogs_gtp_node_t  *gnode;         /**< Relevant GTP node context */
+    ogs_gtp_xact_key_t key;         /**< Key in the transaction index */
 
     void (*cb)(ogs_gtp_xact_t *, void *); /**< Local timer expiration handler */
     void            *data;          /**< Transaction Data */
@@ -29,10 +29,128 @@
 
 #define MAX_NUM_OF_TOKEN 32
 #define MAX_NUM_OF_RULE_BUFFER 1024
+#define MAX_NUM_OF_CACHED_RULE 4096
 
 void compile_rule(char *av[], uint32_t *rbuf, int *rbufsize, void *tstate);
 
+/*
+ * Compiled rules keyed by the normalized flow-description.
+ *
+ * The same few SDF filters are installed for a large number of sessions,
+ * so a compiled rule is kept here and copied out on the next request
+ * instead of running the ipfw parser again. The result only depends on
+ * the text, and callers keep their own copy, so no reference counting
+ * is needed. The cache is bounded; once full, new rules are compiled
+ * without being cached.
+ */
+typedef struct ipfw_rule_cache_s {
+    char *flow_description;
+    ogs_ipfw_rule_t rule;
+} ipfw_rule_cache_t;
+
+static ogs_hash_t *rule_cache_hash = NULL;
+static int num_of_cached_rule = 0;
+
+static int compile_flow_description(
+        ogs_ipfw_rule_t *ipfw_rule, char *flow_description);
+
+void ogs_ipfw_rule_cache_init(void)
+{
+    ogs_assert(rule_cache_hash == NULL);
+
+    rule_cache_hash = ogs_hash_make();
+    ogs_assert(rule_cache_hash);
+    num_of_cached_rule = 0;
+}
+
+static int rule_cache_free(void *rec, const void *key, int klen,
+        const void *value)
+{
+    ipfw_rule_cache_t *entry = (ipfw_rule_cache_t *)value;
+
+    ogs_assert(entry);
+    ogs_free(entry->flow_description);
+    ogs_free(entry);
+
+    return 1;
+}
+
+void ogs_ipfw_rule_cache_final(void)
+{
+    ogs_assert(rule_cache_hash);
+
+    ogs_hash_do(rule_cache_free, NULL, rule_cache_hash);
+    ogs_hash_destroy(rule_cache_hash);
+    rule_cache_hash = NULL;
+    num_of_cached_rule = 0;
+}
+
+/* Collapse runs of spaces so that equivalent descriptions share a key */
+static char *normalize_flow_description(const char *flow_description)
+{
+    char *normalized = NULL, *p = NULL;
+    const char *s = NULL;
+
+    normalized = ogs_calloc(1, strlen(flow_description) + 1);
+    ogs_assert(normalized);
+
+    p = normalized;
+    for (s = flow_description; *s; s++) {
+        if (*s == ' ') {
+            if (p != normalized && *(p-1) != ' ')
+                *p++ = ' ';
+            continue;
+        }
+        *p++ = *s;
+    }
+    if (p != normalized && *(p-1) == ' ')
+        p--;
+    *p = '\0';
+
+    return normalized;
+}
+
 int ogs_ipfw_compile_rule(ogs_ipfw_rule_t *ipfw_rule, char *flow_description)
+{
+    ipfw_rule_cache_t *entry = NULL;
+    char *normalized = NULL;
+    int rv;
+
+    ogs_assert(ipfw_rule);
+    ogs_assert(flow_description);
+
+    if (!rule_cache_hash)
+        return compile_flow_description(ipfw_rule, flow_description);
+
+    normalized = normalize_flow_description(flow_description);
+
+    entry = ogs_hash_get(rule_cache_hash, normalized, OGS_HASH_KEY_STRING);
+    if (entry) {
+        memcpy(ipfw_rule, &entry->rule, sizeof(ogs_ipfw_rule_t));
+        ogs_free(normalized);
+        return OGS_OK;
+    }
+
+    rv = compile_flow_description(ipfw_rule, normalized);
+    if (rv != OGS_OK || num_of_cached_rule >= MAX_NUM_OF_CACHED_RULE) {
+        ogs_free(normalized);
+        return rv;
+    }
+
+    entry = ogs_calloc(1, sizeof(*entry));
+    ogs_assert(entry);
+    entry->flow_description = normalized;
+    memcpy(&entry->rule, ipfw_rule, sizeof(ogs_ipfw_rule_t));
+
+    ogs_hash_set(rule_cache_hash,
+            entry->flow_description, OGS_HASH_KEY_STRING, entry);
+    num_of_cached_rule++;
+
+    return OGS_OK;
+}
+
+static int compile_flow_description(
+        ogs_ipfw_rule_t *ipfw_rule, char *flow_description)
 {
     char *token, *dir;
     char *saveptr;
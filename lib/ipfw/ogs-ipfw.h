@@ -61,6 +61,9 @@ typedef struct ogs_ipfw_rule_s {
     uint32_t sdf_filter_id;
 } ogs_ipfw_rule_t;
 
+void ogs_ipfw_rule_cache_init(void);
+void ogs_ipfw_rule_cache_final(void);
+
 int ogs_ipfw_compile_rule(ogs_ipfw_rule_t *ipfw_rule, char *flow_description);
 char *ogs_ipfw_encode_flow_description(ogs_ipfw_rule_t *ipfw_rule);
 
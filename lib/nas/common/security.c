@@ -19,6 +19,17 @@
 
 #include "ogs-nas-common.h"
 
+/* COUNT | BEARER | DIRECTION | 0 ... of 128-EIA2 and 128-EEA2 */
+static void aes_ivec_build(uint8_t *ivec, int len,
+        uint32_t count, uint8_t bearer, uint8_t direction)
+{
+    count = htonl(count);
+
+    memset(ivec, 0, len);
+    memcpy(ivec + 0, &count, sizeof(count));
+    ivec[4] = (bearer << 3) | (direction << 2);
+}
+
 void ogs_nas_mac_calculate(uint8_t algorithm_identity,
         uint8_t *knas_int, uint32_t count, uint8_t bearer, 
         uint8_t direction, ogs_pkbuf_t *pkbuf, uint8_t *mac)
@@ -41,14 +52,10 @@ void ogs_nas_mac_calculate(uint8_t algorithm_identity,
                 pkbuf->data, (pkbuf->len << 3), mac);
         break;
     case OGS_NAS_SECURITY_ALGORITHMS_128_EIA2:
-        count = htonl(count);
-
         ogs_pkbuf_push(pkbuf, 8);
 
         ivec = pkbuf->data;
-        memset(ivec, 0, 8);
-        memcpy(ivec + 0, &count, sizeof(count));
-        ivec[4] = (bearer << 3) | (direction << 2);
+        aes_ivec_build(ivec, 8, count, bearer, direction);
 
         ogs_aes_cmac_calculate(cmac, knas_int, pkbuf->data, pkbuf->len);
         memcpy(mac, cmac, 4);
@@ -96,11 +103,7 @@ void ogs_nas_encrypt(uint8_t algorithm_identity,
 #endif
         break;
     case OGS_NAS_SECURITY_ALGORITHMS_128_EEA2:
-        count = htonl(count);
-
-        memset(ivec, 0, 16);
-        memcpy(ivec + 0, &count, sizeof(count));
-        ivec[4] = (bearer << 3) | (direction << 2);
+        aes_ivec_build(ivec, 16, count, bearer, direction);
         ogs_aes_ctr128_encrypt(knas_enc, ivec, 
                 pkbuf->data, pkbuf->len, pkbuf->data);
         break;
@@ -116,3 +119,80 @@ void ogs_nas_encrypt(uint8_t algorithm_identity,
         break;
     }
 }
+
+void ogs_nas_mac_calculate_cached(ogs_nas_security_cache_t *cache,
+        uint8_t algorithm_identity,
+        uint8_t *knas_int, uint32_t count, uint8_t bearer,
+        uint8_t direction, ogs_pkbuf_t *pkbuf, uint8_t *mac)
+{
+    uint8_t *ivec = NULL;
+    uint8_t cmac[16];
+
+    ogs_assert(cache);
+
+    if (algorithm_identity != OGS_NAS_SECURITY_ALGORITHMS_128_EIA2) {
+        ogs_nas_mac_calculate(algorithm_identity,
+                knas_int, count, bearer, direction, pkbuf, mac);
+        return;
+    }
+
+    ogs_assert(knas_int);
+    ogs_assert(bearer <= 0x1f);
+    ogs_assert(direction == 0 || direction == 1);
+    ogs_assert(pkbuf);
+    ogs_assert(pkbuf->data);
+    ogs_assert(pkbuf->len);
+    ogs_assert(mac);
+
+    if (cache->int_valid == false ||
+        memcmp(cache->knas_int, knas_int, OGS_KEY_LEN) != 0) {
+        memcpy(cache->knas_int, knas_int, OGS_KEY_LEN);
+        ogs_aes_cmac_setup(&cache->cmac, knas_int);
+        cache->int_valid = true;
+    }
+
+    ogs_pkbuf_push(pkbuf, 8);
+
+    ivec = pkbuf->data;
+    aes_ivec_build(ivec, 8, count, bearer, direction);
+
+    ogs_aes_cmac_calculate_with_ctx(cmac, &cache->cmac,
+            pkbuf->data, pkbuf->len);
+    memcpy(mac, cmac, 4);
+
+    ogs_pkbuf_pull(pkbuf, 8);
+}
+
+void ogs_nas_encrypt_cached(ogs_nas_security_cache_t *cache,
+        uint8_t algorithm_identity,
+        uint8_t *knas_enc, uint32_t count, uint8_t bearer,
+        uint8_t direction, ogs_pkbuf_t *pkbuf)
+{
+    uint8_t ivec[16];
+
+    ogs_assert(cache);
+
+    if (algorithm_identity != OGS_NAS_SECURITY_ALGORITHMS_128_EEA2) {
+        ogs_nas_encrypt(algorithm_identity,
+                knas_enc, count, bearer, direction, pkbuf);
+        return;
+    }
+
+    ogs_assert(knas_enc);
+    ogs_assert(bearer <= 0x1f);
+    ogs_assert(direction == 0 || direction == 1);
+    ogs_assert(pkbuf);
+    ogs_assert(pkbuf->data);
+    ogs_assert(pkbuf->len);
+
+    if (cache->enc_valid == false ||
+        memcmp(cache->knas_enc, knas_enc, OGS_KEY_LEN) != 0) {
+        memcpy(cache->knas_enc, knas_enc, OGS_KEY_LEN);
+        cache->enc_nrounds = ogs_aes_setup_enc(cache->enc_rk, knas_enc, 128);
+        cache->enc_valid = true;
+    }
+
+    aes_ivec_build(ivec, 16, count, bearer, direction);
+    ogs_aes_ctr128_encrypt_with_rk(cache->enc_rk, cache->enc_nrounds,
+            ivec, pkbuf->data, pkbuf->len, pkbuf->data);
+}
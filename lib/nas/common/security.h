@@ -39,6 +39,36 @@ void ogs_nas_encrypt(uint8_t algorithm_identity,
     uint8_t *knas_enc, uint32_t count, uint8_t bearer, 
     uint8_t direction, ogs_pkbuf_t *pkbuf);
 
+/*
+ * Per-UE cache of the AES key schedules used by 128-EIA2/128-EEA2.
+ *
+ * The schedules are derived from KNASint/KNASenc which only change on
+ * a new security context, so the UE context keeps this cache and the
+ * *_cached() variants reuse it for every NAS PDU. The key is compared
+ * on each call, so the cache never has to be invalidated explicitly.
+ * A zeroed structure is a valid empty cache.
+ */
+typedef struct ogs_nas_security_cache_s {
+    bool int_valid;
+    uint8_t knas_int[OGS_KEY_LEN];
+    ogs_aes_cmac_ctx_t cmac;
+
+    bool enc_valid;
+    uint8_t knas_enc[OGS_KEY_LEN];
+    uint32_t enc_rk[OGS_AES_RKLENGTH(128)];
+    int enc_nrounds;
+} ogs_nas_security_cache_t;
+
+void ogs_nas_mac_calculate_cached(ogs_nas_security_cache_t *cache,
+    uint8_t algorithm_identity,
+    uint8_t *knas_int, uint32_t count, uint8_t bearer,
+    uint8_t direction, ogs_pkbuf_t *pkbuf, uint8_t *mac);
+
+void ogs_nas_encrypt_cached(ogs_nas_security_cache_t *cache,
+    uint8_t algorithm_identity,
+    uint8_t *knas_enc, uint32_t count, uint8_t bearer,
+    uint8_t direction, ogs_pkbuf_t *pkbuf);
+
 #ifdef __cplusplus
 }
 #endif
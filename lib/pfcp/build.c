@@ -305,6 +305,57 @@ ogs_pkbuf_t *ogs_pfcp_up_build_association_setup_response(uint8_t type,
     return pkbuf;
 }
 
+static struct {
+    uint32_t seqn;
+    uint8_t metric;
+} lcibuf;
+
+void ogs_pfcp_build_load_control_information(
+        ogs_pfcp_tlv_load_control_information_t *message,
+        uint32_t seqn, uint8_t metric)
+{
+    ogs_assert(message);
+
+    lcibuf.seqn = htobe32(seqn);
+    lcibuf.metric = metric;
+
+    message->presence = 1;
+    message->load_control_sequence_number.presence = 1;
+    message->load_control_sequence_number.data = &lcibuf.seqn;
+    message->load_control_sequence_number.len = sizeof(lcibuf.seqn);
+    message->load_metric.presence = 1;
+    message->load_metric.data = &lcibuf.metric;
+    message->load_metric.len = sizeof(lcibuf.metric);
+}
+
+static struct {
+    uint32_t seqn;
+    uint8_t metric;
+    uint8_t timer;
+} ocibuf;
+
+void ogs_pfcp_build_overload_control_information(
+        ogs_pfcp_tlv_overload_control_information_t *message,
+        uint32_t seqn, uint8_t reduction, uint8_t timer)
+{
+    ogs_assert(message);
+
+    ocibuf.seqn = htobe32(seqn);
+    ocibuf.metric = reduction;
+    ocibuf.timer = timer;
+
+    message->presence = 1;
+    message->overload_control_sequence_number.presence = 1;
+    message->overload_control_sequence_number.data = &ocibuf.seqn;
+    message->overload_control_sequence_number.len = sizeof(ocibuf.seqn);
+    message->overload_reduction_metric.presence = 1;
+    message->overload_reduction_metric.data = &ocibuf.metric;
+    message->overload_reduction_metric.len = sizeof(ocibuf.metric);
+    message->period_of_validity.presence = 1;
+    message->period_of_validity.data = &ocibuf.timer;
+    message->period_of_validity.len = sizeof(ocibuf.timer);
+}
+
 static struct {
     ogs_pfcp_f_teid_t f_teid;
     char dnn[OGS_MAX_DNN_LEN+1];
@@ -331,6 +382,7 @@ void ogs_pfcp_build_create_pdr(
     ogs_pfcp_tlv_create_pdr_t *message, int i, ogs_pfcp_pdr_t *pdr)
 {
     ogs_pfcp_far_t *far = NULL;
+    ogs_pfcp_rule_t *rule = NULL;
     ogs_pfcp_sdf_filter_t pfcp_sdf_filter[OGS_MAX_NUM_OF_FLOW_IN_PDR];
     int j = 0;
     int len = 0;
@@ -392,6 +444,41 @@ void ogs_pfcp_build_create_pdr(
                 &pfcp_sdf_filter[j], pdrbuf[i].sdf_filter[j], len);
     }
 
+    /*
+     * The UP function keeps the received SDF Filters as rules only,
+     * e.g. when the UPF writes a session to its session store.
+     */
+    if (pdr->num_of_flow == 0) {
+        j = 0;
+        ogs_list_for_each(&pdr->rule_list, rule) {
+            if (j == OGS_MAX_NUM_OF_FLOW_IN_PDR)
+                break;
+            if (!rule->flow_description && !rule->bid)
+                continue;
+
+            if (rule->flow_description) {
+                pfcp_sdf_filter[j].fd = 1;
+                pfcp_sdf_filter[j].flow_description_len =
+                        strlen(rule->flow_description);
+                pfcp_sdf_filter[j].flow_description = rule->flow_description;
+            }
+            if (rule->bid) {
+                pfcp_sdf_filter[j].bid = 1;
+                pfcp_sdf_filter[j].sdf_filter_id = rule->sdf_filter_id;
+            }
+
+            len = sizeof(ogs_pfcp_sdf_filter_t) +
+                    pfcp_sdf_filter[j].flow_description_len;
+
+            message->pdi.sdf_filter[j].presence = 1;
+            pdrbuf[i].sdf_filter[j] = ogs_calloc(1, len);
+            ogs_assert(pdrbuf[i].sdf_filter[j]);
+            ogs_pfcp_build_sdf_filter(&message->pdi.sdf_filter[j],
+                    &pfcp_sdf_filter[j], pdrbuf[i].sdf_filter[j], len);
+            j++;
+        }
+    }
+
     if (pdr->ue_ip_addr_len) {
         message->pdi.ue_ip_address.presence = 1;
         message->pdi.ue_ip_address.data = &pdr->ue_ip_addr;
@@ -35,6 +35,13 @@ ogs_pkbuf_t *ogs_pfcp_up_build_association_setup_request(uint8_t type);
 ogs_pkbuf_t *ogs_pfcp_up_build_association_setup_response(uint8_t type,
         uint8_t cause);
 
+void ogs_pfcp_build_load_control_information(
+        ogs_pfcp_tlv_load_control_information_t *message,
+        uint32_t seqn, uint8_t metric);
+void ogs_pfcp_build_overload_control_information(
+        ogs_pfcp_tlv_overload_control_information_t *message,
+        uint32_t seqn, uint8_t reduction, uint8_t timer);
+
 void ogs_pfcp_pdrbuf_init(void);
 void ogs_pfcp_pdrbuf_clear(void);
 
@@ -17,6 +17,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <ctype.h>
+
 #include "app/ogs-app.h"
 #include "ogs-pfcp.h"
 
@@ -39,6 +41,7 @@ static OGS_POOL(ogs_pfcp_rule_pool, ogs_pfcp_rule_t);
 
 static OGS_POOL(ogs_pfcp_dev_pool, ogs_pfcp_dev_t);
 static OGS_POOL(ogs_pfcp_subnet_pool, ogs_pfcp_subnet_t);
+static OGS_POOL(ogs_pfcp_ue_ip_pool, ogs_pfcp_ue_ip_t);
 
 void ogs_pfcp_context_init(void)
 {
@@ -50,6 +53,12 @@ void ogs_pfcp_context_init(void)
 
     self.local_recovery = ogs_time_ntp32_now();
 
+    /* The other half of the packet pool is left for forwarding */
+    self.buffer.max = ogs_max(ogs_app()->pool.packet / 2, 1);
+    ogs_list_init(&self.buffer.far_list);
+
+    ogs_ipfw_rule_cache_init();
+
     ogs_log_install_domain(&__ogs_pfcp_domain, "pfcp", ogs_core()->log.level);
 
     ogs_pool_init(&ogs_pfcp_node_pool, ogs_app()->pool.nf);
@@ -80,6 +89,8 @@ void ogs_pfcp_context_init(void)
 
     ogs_pool_init(&ogs_pfcp_dev_pool, OGS_MAX_NUM_OF_DEV);
     ogs_pool_init(&ogs_pfcp_subnet_pool, OGS_MAX_NUM_OF_SUBNET);
+    /* IPv4 and IPv6 address per session */
+    ogs_pool_init(&ogs_pfcp_ue_ip_pool, ogs_app()->pool.sess * 2);
 
     self.object_teid_hash = ogs_hash_make();
     ogs_assert(self.object_teid_hash);
@@ -87,6 +98,8 @@ void ogs_pfcp_context_init(void)
     ogs_assert(self.far_f_teid_hash);
     self.far_teid_hash = ogs_hash_make();
     ogs_assert(self.far_teid_hash);
+    self.subnet_dnn_hash = ogs_hash_make();
+    ogs_assert(self.subnet_dnn_hash);
 
     context_initialized = 1;
 }
@@ -101,12 +114,17 @@ void ogs_pfcp_context_final(void)
     ogs_hash_destroy(self.far_f_teid_hash);
     ogs_assert(self.far_teid_hash);
     ogs_hash_destroy(self.far_teid_hash);
+    ogs_assert(self.subnet_dnn_hash);
+    ogs_hash_destroy(self.subnet_dnn_hash);
+
+    ogs_ipfw_rule_cache_final();
 
     ogs_pfcp_dev_remove_all();
     ogs_pfcp_subnet_remove_all();
 
     ogs_pool_final(&ogs_pfcp_dev_pool);
     ogs_pool_final(&ogs_pfcp_subnet_pool);
+    ogs_pool_final(&ogs_pfcp_ue_ip_pool);
     ogs_pool_final(&ogs_pfcp_rule_pool);
 
     ogs_pool_final(&ogs_pfcp_pdr_pool);
@@ -447,6 +465,8 @@ int ogs_pfcp_context_parse_config(const char *local, const char *remote)
 
                             } while (ogs_yaml_iter_type(&server_array) ==
                                     YAML_SEQUENCE_NODE);
+                        } else if (!strcmp(pfcp_key, "batch")) {
+                            self.batch = ogs_yaml_iter_bool(&pfcp_iter);
                         } else if (!strcmp(pfcp_key, "client")) {
                             ogs_yaml_iter_t client_iter;
                             ogs_yaml_iter_recurse(&pfcp_iter, &client_iter);
@@ -905,6 +925,8 @@ ogs_pfcp_node_t *ogs_pfcp_node_new(ogs_sockaddr_t *config_addr)
     ogs_list_init(&node->local_list);
     ogs_list_init(&node->remote_list);
 
+    ogs_list_init(&node->sess_list);
+
     ogs_list_init(&node->gtpu_resource_list);
 
     return node;
@@ -1133,6 +1155,33 @@ void ogs_pfcp_node_remove_all(ogs_list_t *list)
         ogs_pfcp_node_remove(list, node);
 }
 
+uint8_t ogs_pfcp_node_load_metric(ogs_pfcp_node_t *node)
+{
+    ogs_assert(node);
+
+    if (node->load.presence == false)
+        return 0;
+
+    return node->load.metric;
+}
+
+uint8_t ogs_pfcp_node_overload_reduction(ogs_pfcp_node_t *node)
+{
+    ogs_assert(node);
+
+    if (node->overload.presence == false)
+        return 0;
+
+    if (node->overload.expires &&
+        node->overload.expires <= ogs_get_monotonic_time()) {
+        node->overload.reduction = 0;
+        node->overload.expires = 0;
+        return 0;
+    }
+
+    return node->overload.reduction;
+}
+
 /******************************************************************************
  * Compare two node IDs for equality. Returns true if they match, else false.
  ******************************************************************************/
@@ -1864,7 +1913,6 @@ ogs_pfcp_far_t *ogs_pfcp_far_find_by_teid(uint32_t teid)
 
 void ogs_pfcp_far_remove(ogs_pfcp_far_t *far)
 {
-    int i;
     ogs_pfcp_sess_t *sess = NULL;
 
     ogs_assert(far);
@@ -1884,8 +1932,7 @@ void ogs_pfcp_far_remove(ogs_pfcp_far_t *far)
     if (far->dnn)
         ogs_free(far->dnn);
 
-    for (i = 0; i < far->num_of_buffered_packet; i++)
-        ogs_pkbuf_free(far->buffered_packet[i]);
+    ogs_pfcp_far_drop_buffered_packet(far);
 
     if (far->id_node)
         ogs_pool_free(&far->sess->far_id_pool, far->id_node);
@@ -1903,6 +1950,94 @@ void ogs_pfcp_far_remove_all(ogs_pfcp_sess_t *sess)
         ogs_pfcp_far_remove(far);
 }
 
+/*
+ * A buffered packet is charged for the buffer it holds rather than its
+ * length, since a small packet pins a whole cluster of the packet pool.
+ *
+ * Each FAR keeps at most OGS_MAX_PACKET_BUFFER_SIZE_PER_UE and drops its
+ * oldest packets to make room. All FARs together keep at most half of
+ * the packet pool; past that, the oldest packets of the FAR that has
+ * been buffering the longest are evicted.
+ */
+static unsigned int buffered_packet_size(ogs_pkbuf_t *pkbuf)
+{
+    return pkbuf->end - pkbuf->head;
+}
+
+void ogs_pfcp_far_buffer_packet(ogs_pfcp_far_t *far, ogs_pkbuf_t *pkbuf)
+{
+    ogs_pfcp_far_t *victim = NULL;
+    unsigned int size;
+
+    ogs_assert(far);
+    ogs_assert(pkbuf);
+
+    size = buffered_packet_size(pkbuf);
+    if (size > OGS_MAX_PACKET_BUFFER_SIZE_PER_UE) {
+        ogs_pkbuf_free(pkbuf);
+        return;
+    }
+
+    while (far->buffered_size + size > OGS_MAX_PACKET_BUFFER_SIZE_PER_UE)
+        ogs_pkbuf_free(ogs_pfcp_far_unbuffer_packet(far));
+
+    if (far->num_of_buffered_packet == 0)
+        ogs_list_add(&self.buffer.far_list, &far->buffer_lnode);
+
+    ogs_list_add(&far->buffered_list, pkbuf);
+    far->num_of_buffered_packet++;
+    far->buffered_size += size;
+    self.buffer.num++;
+
+    while (self.buffer.num > self.buffer.max) {
+        if (!victim || victim->num_of_buffered_packet == 0) {
+            victim = ogs_list_entry(ogs_list_first(&self.buffer.far_list),
+                    ogs_pfcp_far_t, buffer_lnode);
+            ogs_assert(victim);
+        }
+
+        ogs_pkbuf_free(ogs_pfcp_far_unbuffer_packet(victim));
+    }
+}
+
+ogs_pkbuf_t *ogs_pfcp_far_unbuffer_packet(ogs_pfcp_far_t *far)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+    unsigned int size;
+
+    ogs_assert(far);
+
+    pkbuf = ogs_list_first(&far->buffered_list);
+    if (!pkbuf)
+        return NULL;
+
+    ogs_list_remove(&far->buffered_list, pkbuf);
+
+    size = buffered_packet_size(pkbuf);
+
+    ogs_assert(far->num_of_buffered_packet);
+    far->num_of_buffered_packet--;
+    ogs_assert(far->buffered_size >= size);
+    far->buffered_size -= size;
+    ogs_assert(self.buffer.num > 0);
+    self.buffer.num--;
+
+    if (far->num_of_buffered_packet == 0)
+        ogs_list_remove(&self.buffer.far_list, &far->buffer_lnode);
+
+    return pkbuf;
+}
+
+void ogs_pfcp_far_drop_buffered_packet(ogs_pfcp_far_t *far)
+{
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    ogs_assert(far);
+
+    while ((pkbuf = ogs_pfcp_far_unbuffer_packet(far)))
+        ogs_pkbuf_free(pkbuf);
+}
+
 ogs_pfcp_urr_t *ogs_pfcp_urr_add(ogs_pfcp_sess_t *sess)
 {
     ogs_pfcp_urr_t *urr = NULL;
@@ -2073,6 +2208,92 @@ void ogs_pfcp_qer_remove_all(ogs_pfcp_sess_t *sess)
         ogs_pfcp_qer_remove(qer);
 }
 
+/* Bucket depth : 100ms worth of traffic, but at least a few full packets */
+#define POLICER_BURST_USEC (100 * 1000)
+#define POLICER_MIN_BURST (4 * OGS_MAX_PKT_LEN)
+
+/*
+ * An MBR of up to 2^40 kbps is about 2^47 bytes per second. Clamping the
+ * rate to 2^43 bytes (~70 Tbps) keeps rate * elapsed below 2^63 for any
+ * elapsed time under one second, so the refill cannot overflow.
+ */
+#define POLICER_MAX_RATE (1ULL << 43)
+
+static void policer_setup(ogs_pfcp_policer_t *policer, uint64_t bitrate)
+{
+    ogs_assert(policer);
+
+    policer->rate = ogs_min(bitrate / 8, POLICER_MAX_RATE);
+    if (policer->rate == 0) {
+        memset(policer, 0, sizeof(*policer));
+        return;
+    }
+
+    policer->burst = ogs_max(POLICER_MIN_BURST,
+            policer->rate * POLICER_BURST_USEC / OGS_USEC_PER_SEC);
+
+    /* A new bucket starts full; an updated one keeps its credit */
+    if (policer->last == 0 || policer->tokens > policer->burst)
+        policer->tokens = policer->burst;
+}
+
+void ogs_pfcp_qer_policer_setup(ogs_pfcp_qer_t *qer)
+{
+    ogs_assert(qer);
+
+    policer_setup(&qer->policer.uplink, qer->mbr.uplink);
+    policer_setup(&qer->policer.downlink, qer->mbr.downlink);
+}
+
+static bool policer_conform(
+        ogs_pfcp_policer_t *policer, size_t size, ogs_time_t now)
+{
+    ogs_time_t elapsed;
+    uint64_t credit;
+
+    elapsed = now - policer->last;
+
+    if (policer->last == 0 || elapsed >= OGS_USEC_PER_SEC) {
+        /* Idle for long enough to refill any bucket */
+        policer->tokens = policer->burst;
+        policer->remainder = 0;
+    } else if (elapsed > 0) {
+        /* rate <= 2^43 and elapsed < 2^20, see POLICER_MAX_RATE */
+        credit = policer->rate * elapsed + policer->remainder;
+        policer->tokens += credit / OGS_USEC_PER_SEC;
+        policer->remainder = credit % OGS_USEC_PER_SEC;
+        if (policer->tokens > policer->burst) {
+            policer->tokens = policer->burst;
+            policer->remainder = 0;
+        }
+    }
+    policer->last = now;
+
+    if (policer->tokens < size)
+        return false;
+
+    policer->tokens -= size;
+    return true;
+}
+
+/*
+ * 'now' is the monotonic time of the receive batch the packet belongs to,
+ * so the clock is read once per batch rather than once per packet.
+ */
+bool ogs_pfcp_qer_police(ogs_pfcp_qer_t *qer,
+        bool is_uplink, size_t size, ogs_time_t now)
+{
+    ogs_pfcp_policer_t *policer = NULL;
+
+    ogs_assert(qer);
+
+    policer = is_uplink ? &qer->policer.uplink : &qer->policer.downlink;
+    if (policer->rate == 0)
+        return true;
+
+    return policer_conform(policer, size, now);
+}
+
 ogs_pfcp_bar_t *ogs_pfcp_bar_new(ogs_pfcp_sess_t *sess)
 {
     ogs_pfcp_bar_t *bar = NULL;
@@ -2156,6 +2377,8 @@ void ogs_pfcp_rule_remove(ogs_pfcp_rule_t *rule)
     ogs_assert(pdr);
 
     ogs_list_remove(&pdr->rule_list, rule);
+    if (rule->flow_description)
+        ogs_free(rule->flow_description);
     ogs_pool_free(&ogs_pfcp_rule_pool, rule);
 }
 
@@ -2169,26 +2392,225 @@ void ogs_pfcp_rule_remove_all(ogs_pfcp_pdr_t *pdr)
         ogs_pfcp_rule_remove(rule);
 }
 
+/*
+ * Subnets that serve a DNN, in configuration order. Subnets without a DNN
+ * are shared by every group, and subnet_group[0] holds only those.
+ */
+typedef struct subnet_group_s {
+    char                dnn[OGS_MAX_DNN_LEN+1];
+    int                 num_of_subnet;
+    ogs_pfcp_subnet_t   *subnet[OGS_MAX_NUM_OF_SUBNET];
+} subnet_group_t;
+
+static subnet_group_t subnet_group[OGS_MAX_NUM_OF_SUBNET+1];
+static int num_of_subnet_group;
+
+static void subnet_group_build(void)
+{
+    ogs_pfcp_subnet_t *subnet = NULL, *member = NULL;
+    subnet_group_t *group = NULL;
+    int i;
+
+    ogs_hash_clear(self.subnet_dnn_hash);
+    memset(subnet_group, 0, sizeof(subnet_group));
+    num_of_subnet_group = 1;
+
+    ogs_list_for_each(&self.subnet_list, subnet) {
+        if (strlen(subnet->dnn) == 0) {
+            group = &subnet_group[0];
+            group->subnet[group->num_of_subnet++] = subnet;
+            continue;
+        }
+
+        for (i = 0; subnet->dnn[i]; i++)
+            subnet_group[num_of_subnet_group].dnn[i] =
+                tolower((unsigned char)subnet->dnn[i]);
+        subnet_group[num_of_subnet_group].dnn[i] = 0;
+
+        if (ogs_hash_get(self.subnet_dnn_hash,
+                    subnet_group[num_of_subnet_group].dnn, OGS_HASH_KEY_STRING))
+            continue;
+
+        group = &subnet_group[num_of_subnet_group++];
+        ogs_list_for_each(&self.subnet_list, member) {
+            if (strlen(member->dnn) == 0 ||
+                ogs_strcasecmp(member->dnn, group->dnn) == 0)
+                group->subnet[group->num_of_subnet++] = member;
+        }
+        ogs_hash_set(self.subnet_dnn_hash,
+                group->dnn, OGS_HASH_KEY_STRING, group);
+    }
+}
+
+static subnet_group_t *subnet_group_find(const char *dnn)
+{
+    subnet_group_t *group = NULL;
+    char key[OGS_MAX_DNN_LEN+1];
+    int i;
+
+    if (dnn) {
+        for (i = 0; dnn[i] && i < OGS_MAX_DNN_LEN; i++)
+            key[i] = tolower((unsigned char)dnn[i]);
+        key[i] = 0;
+
+        group = ogs_hash_get(self.subnet_dnn_hash, key, OGS_HASH_KEY_STRING);
+        if (group)
+            return group;
+    }
+
+    return &subnet_group[0];
+}
+
+static void subnet_group_remove(ogs_pfcp_subnet_t *subnet)
+{
+    subnet_group_t *group = NULL;
+    int i, j;
+
+    for (i = 0; i < num_of_subnet_group; i++) {
+        group = &subnet_group[i];
+        for (j = 0; j < group->num_of_subnet; j++) {
+            if (group->subnet[j] == subnet) {
+                memmove(&group->subnet[j], &group->subnet[j+1],
+                    (group->num_of_subnet-j-1) * sizeof(group->subnet[0]));
+                group->num_of_subnet--;
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * IPv4 blocks count addresses. IPv6 blocks count 64bit prefixes,
+ * so only addr[0] and addr[1] take part in the arithmetic.
+ */
+static uint64_t ue_ip_to_u64(int family, const uint32_t *addr)
+{
+    if (family == AF_INET)
+        return be32toh(addr[0]);
+
+    return ((uint64_t)be32toh(addr[0]) << 32) | be32toh(addr[1]);
+}
+
+static void ue_ip_from_u64(int family, uint64_t value, uint32_t *addr)
+{
+    if (family == AF_INET) {
+        addr[0] = htobe32((uint32_t)value);
+    } else {
+        addr[0] = htobe32((uint32_t)(value >> 32));
+        addr[1] = htobe32((uint32_t)value);
+    }
+}
+
+static int ue_ip_index(ogs_pfcp_subnet_t *subnet, const uint32_t *addr)
+{
+    uint64_t value, start;
+    int i;
+
+    ogs_assert(subnet);
+    ogs_assert(addr);
+
+    value = ue_ip_to_u64(subnet->family, addr);
+    for (i = 0; i < subnet->num_of_block; i++) {
+        start = ue_ip_to_u64(subnet->family, subnet->block[i].start);
+        if (value >= start && value - start < subnet->block[i].count)
+            return subnet->block[i].first + (int)(value - start);
+    }
+
+    return -1;
+}
+
+/*
+ * A static address that is already set in the bitmap is shared rather
+ * than rejected, e.g. while the old session of a restarted peer is still
+ * around. The bit stays set until the last holder releases it.
+ */
+typedef struct ue_ip_shared_s {
+    int index;
+    int count;                      /* Holders besides the first one */
+} ue_ip_shared_t;
+
+static void ue_ip_share(ogs_pfcp_subnet_t *subnet, int index)
+{
+    ue_ip_shared_t *shared = NULL;
+
+    ogs_assert(subnet);
+
+    if (!subnet->shared) {
+        subnet->shared = ogs_hash_make();
+        ogs_assert(subnet->shared);
+    }
+
+    shared = ogs_hash_get(subnet->shared, &index, sizeof(index));
+    if (!shared) {
+        shared = ogs_calloc(1, sizeof(*shared));
+        ogs_assert(shared);
+        shared->index = index;
+        ogs_hash_set(subnet->shared,
+                &shared->index, sizeof(shared->index), shared);
+    }
+    shared->count++;
+}
+
+/* Clears the bit of 'index' unless another holder still uses it */
+static void ue_ip_release(ogs_pfcp_subnet_t *subnet, int index)
+{
+    ue_ip_shared_t *shared = NULL;
+
+    ogs_assert(subnet);
+
+    if (subnet->shared)
+        shared = ogs_hash_get(subnet->shared, &index, sizeof(index));
+    if (!shared) {
+        ogs_bitmap_clear(&subnet->bitmap, index);
+        return;
+    }
+
+    if (--shared->count == 0) {
+        ogs_hash_set(subnet->shared,
+                &shared->index, sizeof(shared->index), NULL);
+        ogs_free(shared);
+    }
+}
+
+static void ue_ip_from_index(
+        ogs_pfcp_subnet_t *subnet, int index, uint32_t *addr)
+{
+    uint64_t start;
+    int i, offset;
+
+    ogs_assert(subnet);
+    ogs_assert(addr);
+
+    for (i = 0; i < subnet->num_of_block; i++) {
+        if (index < subnet->block[i].first + subnet->block[i].count)
+            break;
+    }
+    ogs_assert(i < subnet->num_of_block);
+
+    offset = index - subnet->block[i].first;
+    start = ue_ip_to_u64(subnet->family, subnet->block[i].start);
+
+    memset(addr, 0, sizeof(uint32_t) * 4);
+    ue_ip_from_u64(subnet->family, start + offset, addr);
+
+    /* Allocate Full IPv6 Address */
+    if (subnet->family == AF_INET6)
+        addr[3] = htobe32(offset + 1);
+}
+
 int ogs_pfcp_ue_pool_generate(void)
 {
     int i, rv;
     ogs_pfcp_subnet_t *subnet = NULL;
 
     ogs_list_for_each(&self.subnet_list, subnet) {
-        int maxbytes = 0;
-        int lastindex = 0;
-        uint32_t start[4], end[4], broadcast[4];
+        uint32_t broadcast[4];
+        uint64_t start, end;
         int rangeindex, num_of_range;
-        int poolindex;
-        int inc;
-
-        if (subnet->family == AF_INET) {
-            maxbytes = 4;
-            lastindex = 0;
-        } else if (subnet->family == AF_INET6) {
-            maxbytes = 8; /* Default Prefixlen 64bits */
-            lastindex = 1;
-        } else {
+        int size, index;
+
+        /* IPv6 uses the default prefixlen of 64 bits */
+        if (subnet->family != AF_INET && subnet->family != AF_INET6) {
             /* subnet->family might be AF_UNSPEC. So, skip it */
             continue;
         }
@@ -2200,7 +2622,8 @@ int ogs_pfcp_ue_pool_generate(void)
         num_of_range = subnet->num_of_range;
         if (!num_of_range) num_of_range = 1;
 
-        poolindex = 0;
+        size = 0;
+        subnet->num_of_block = 0;
         for (rangeindex = 0; rangeindex < num_of_range; rangeindex++) {
 
             if (subnet->num_of_range &&
@@ -2208,9 +2631,9 @@ int ogs_pfcp_ue_pool_generate(void)
                 ogs_ipsubnet_t low;
                 rv = ogs_ipsubnet(&low, subnet->range[rangeindex].low, NULL);
                 ogs_assert(rv == OGS_OK);
-                memcpy(start, low.sub, maxbytes);
+                start = ue_ip_to_u64(subnet->family, low.sub);
             } else {
-                memcpy(start, subnet->sub.sub, maxbytes);
+                start = ue_ip_to_u64(subnet->family, subnet->sub.sub);
             }
 
             if (subnet->num_of_range &&
@@ -2218,52 +2641,98 @@ int ogs_pfcp_ue_pool_generate(void)
                 ogs_ipsubnet_t high;
                 rv = ogs_ipsubnet(&high, subnet->range[rangeindex].high, NULL);
                 ogs_assert(rv == OGS_OK);
-                high.sub[lastindex] += htobe32(1);
-                memcpy(end, high.sub, maxbytes);
+                end = ue_ip_to_u64(subnet->family, high.sub) + 1;
             } else {
-                memcpy(end, broadcast, maxbytes);
+                end = ue_ip_to_u64(subnet->family, broadcast);
             }
 
-            inc = 0;
-            while(poolindex < ogs_app()->pool.sess) {
-                ogs_pfcp_ue_ip_t *ue_ip = NULL;
+            if (end <= start)
+                continue;
 
-                ue_ip = &subnet->pool.array[poolindex];
-                ogs_assert(ue_ip);
-                memset(ue_ip, 0, sizeof *ue_ip);
-                ue_ip->subnet = subnet;
+            if (end - start > OGS_MAX_NUM_OF_UE_IP_IN_SUBNET - size) {
+                ogs_warn("UE pool [%s] limited to %d addresses",
+                        subnet->dnn, OGS_MAX_NUM_OF_UE_IP_IN_SUBNET);
+                end = start + (OGS_MAX_NUM_OF_UE_IP_IN_SUBNET - size);
+                if (end <= start)
+                    break;
+            }
 
-                memcpy(ue_ip->addr, start, maxbytes);
-                ue_ip->addr[lastindex] += htobe32(inc);
-                inc++;
+            memset(subnet->block[subnet->num_of_block].start, 0,
+                    sizeof(subnet->block[0].start));
+            ue_ip_from_u64(subnet->family, start,
+                    subnet->block[subnet->num_of_block].start);
+            subnet->block[subnet->num_of_block].first = size;
+            subnet->block[subnet->num_of_block].count = (int)(end - start);
+            size += subnet->block[subnet->num_of_block].count;
+            subnet->num_of_block++;
+        }
 
-                if (memcmp(ue_ip->addr, end, maxbytes) == 0)
-                    break;
+        if (size == 0) {
+            ogs_debug("UE pool [%s] has no address", subnet->dnn);
+            continue;
+        }
+
+        rv = ogs_bitmap_init(&subnet->bitmap, size);
+        if (rv != OGS_OK) {
+            ogs_error("ogs_bitmap_init() failed [size:%d]", size);
+            return OGS_ERROR;
+        }
 
-                /* Exclude Network Address */
-                if (memcmp(ue_ip->addr, subnet->sub.sub, maxbytes) == 0)
-                    continue;
+        /* Exclude Network Address and TUN IP Address */
+        memset(&subnet->stats, 0, sizeof(subnet->stats));
+        index = ue_ip_index(subnet, subnet->sub.sub);
+        if (index >= 0 &&
+            ogs_bitmap_set(&subnet->bitmap, index) == true)
+            subnet->stats.reserved++;
+        index = ue_ip_index(subnet, subnet->gw.sub);
+        if (index >= 0 &&
+            ogs_bitmap_set(&subnet->bitmap, index) == true)
+            subnet->stats.reserved++;
+
+        ogs_info("UE pool [%s] %d addresses (%d reserved)",
+                subnet->dnn, size, subnet->stats.reserved);
+    }
+
+    subnet_group_build();
 
-                /* Exclude TUN IP Address */
-                if (memcmp(ue_ip->addr, subnet->gw.sub, maxbytes) == 0)
-                    continue;
+    return OGS_OK;
+}
 
-                /* Allocate Full IPv6 Address */
-                if (lastindex == 1)
-                    ue_ip->addr[3] += htobe32(inc);
+static ogs_pfcp_subnet_t *find_subnet(
+        subnet_group_t *group, int family, uint32_t *addr)
+{
+    ogs_pfcp_subnet_t *subnet = NULL, *found = NULL;
+    int i;
 
-                ogs_trace("[%d] - %x:%x:%x:%x",
-                        poolindex,
-                        ue_ip->addr[0], ue_ip->addr[1],
-                        ue_ip->addr[2], ue_ip->addr[3]);
+    ogs_assert(group);
+    ogs_assert(family == AF_INET || family == AF_INET6);
 
-                poolindex++;
-            }
+    for (i = 0; i < group->num_of_subnet; i++) {
+        subnet = group->subnet[i];
+
+        if (subnet->family == AF_UNSPEC) {
+            /* Address is not managed here, but the device is */
+            if (addr && !found)
+                found = subnet;
+            continue;
+        }
+        if (subnet->family != family)
+            continue;
+
+        /* A static address goes to the subnet that holds it */
+        if (addr) {
+            if (ue_ip_index(subnet, addr) >= 0)
+                return subnet;
+            if (!found)
+                found = subnet;
+            continue;
         }
-        subnet->pool.size = subnet->pool.avail = poolindex;
+
+        if (ogs_bitmap_avail(&subnet->bitmap))
+            return subnet;
     }
 
-    return OGS_OK;
+    return found;
 }
 
 ogs_pfcp_ue_ip_t *ogs_pfcp_ue_ip_alloc(
@@ -2271,6 +2740,9 @@ ogs_pfcp_ue_ip_t *ogs_pfcp_ue_ip_alloc(
 {
     ogs_pfcp_subnet_t *subnet = NULL;
     ogs_pfcp_ue_ip_t *ue_ip = NULL;
+    uint32_t static_addr[4];
+    bool static_ip = false;
+    int index = -1;
 
     uint8_t zero[16];
     size_t maxbytes = 0;
@@ -2286,38 +2758,67 @@ ogs_pfcp_ue_ip_t *ogs_pfcp_ue_ip_alloc(
         return NULL;
     }
 
-    if (dnn)
-        subnet = ogs_pfcp_find_subnet_by_dnn(family, dnn);
-    else
-        subnet = ogs_pfcp_find_subnet(family);
+    /* if assigning a static IP, do so. If not, assign dynamically! */
+    if (memcmp(addr, zero, maxbytes) != 0) {
+        static_ip = true;
+        memset(static_addr, 0, sizeof static_addr);
+        memcpy(static_addr, addr, maxbytes);
+    }
 
+    subnet = find_subnet(subnet_group_find(dnn), family,
+            static_ip ? static_addr : NULL);
     if (subnet == NULL) {
         ogs_error("All IP addresses in all subnets are occupied");
         *cause_value = OGS_PFCP_CAUSE_NO_RESOURCES_AVAILABLE;
         return NULL;
     }
 
-    /* if assigning a static IP, do so. If not, assign dynamically! */
-    if (memcmp(addr, zero, maxbytes) != 0) {
-        ue_ip = ogs_calloc(1, sizeof(ogs_pfcp_ue_ip_t));
-        if (!ue_ip) {
-            ogs_error("All dynamic addresses are occupied");
-            *cause_value = OGS_PFCP_CAUSE_ALL_DYNAMIC_ADDRESS_ARE_OCCUPIED;
-            return NULL;
+    if (static_ip) {
+        if (subnet->family != AF_UNSPEC) {
+            index = ue_ip_index(subnet, static_addr);
+            if (index >= 0 &&
+                ogs_bitmap_set(&subnet->bitmap, index) == false) {
+                ogs_warn("Static IP already in use [%08x:%08x:%08x:%08x]",
+                        be32toh(static_addr[0]), be32toh(static_addr[1]),
+                        be32toh(static_addr[2]), be32toh(static_addr[3]));
+                ue_ip_share(subnet, index);
+            }
         }
-
-        ue_ip->subnet = subnet;
-        ue_ip->static_ip = true;
-        memcpy(ue_ip->addr, addr, maxbytes);
     } else {
-        ogs_pool_alloc(&subnet->pool, &ue_ip);
-        if (!ue_ip) {
+        index = ogs_bitmap_alloc(&subnet->bitmap);
+        if (index < 0) {
             ogs_error("No resources available");
+            subnet->stats.failure++;
             *cause_value = OGS_PFCP_CAUSE_NO_RESOURCES_AVAILABLE;
             return NULL;
         }
     }
 
+    ogs_pool_alloc(&ogs_pfcp_ue_ip_pool, &ue_ip);
+    if (!ue_ip) {
+        ogs_error("ogs_pool_alloc() failed");
+        if (index >= 0)
+            ue_ip_release(subnet, index);
+        subnet->stats.failure++;
+        *cause_value = static_ip ?
+            OGS_PFCP_CAUSE_ALL_DYNAMIC_ADDRESS_ARE_OCCUPIED :
+            OGS_PFCP_CAUSE_NO_RESOURCES_AVAILABLE;
+        return NULL;
+    }
+    memset(ue_ip, 0, sizeof *ue_ip);
+
+    ue_ip->subnet = subnet;
+    ue_ip->static_ip = static_ip;
+    ue_ip->index = index;
+
+    if (static_ip) {
+        memcpy(ue_ip->addr, static_addr, sizeof(ue_ip->addr));
+        subnet->stats.static_alloc++;
+    } else {
+        ue_ip_from_index(subnet, index, ue_ip->addr);
+        subnet->stats.alloc++;
+    }
+
     return ue_ip;
 }
 
@@ -2330,11 +2831,10 @@ void ogs_pfcp_ue_ip_free(ogs_pfcp_ue_ip_t *ue_ip)
 
     ogs_assert(subnet);
 
-    if (ue_ip->static_ip) {
-        ogs_free(ue_ip);
-    } else {
-        ogs_pool_free(&subnet->pool, ue_ip);
-    }
+    if (ue_ip->index >= 0)
+        ue_ip_release(subnet, ue_ip->index);
+
+    ogs_pool_free(&ogs_pfcp_ue_ip_pool, ue_ip);
 }
 
 ogs_pfcp_dev_t *ogs_pfcp_dev_add(const char *ifname)
@@ -2455,8 +2955,6 @@ ogs_pfcp_subnet_t *ogs_pfcp_subnet_add(
     if (dnn)
         ogs_cpystrn(subnet->dnn, dnn, OGS_MAX_DNN_LEN);
 
-    ogs_pool_init(&subnet->pool, ogs_app()->pool.sess);
-
     ogs_list_add(&self.subnet_list, subnet);
 
     return subnet;
@@ -2467,8 +2965,16 @@ void ogs_pfcp_subnet_remove(ogs_pfcp_subnet_t *subnet)
     ogs_assert(subnet);
 
     ogs_list_remove(&self.subnet_list, subnet);
+    subnet_group_remove(subnet);
+
+    ogs_bitmap_final(&subnet->bitmap);
+    if (subnet->shared) {
+        ogs_hash_index_t *hi = NULL;
 
-    ogs_pool_final(&subnet->pool);
+        for (hi = ogs_hash_first(subnet->shared); hi; hi = ogs_hash_next(hi))
+            ogs_free(ogs_hash_this_val(hi));
+        ogs_hash_destroy(subnet->shared);
+    }
 
     ogs_pool_free(&ogs_pfcp_subnet_pool, subnet);
 }
@@ -2483,36 +2989,14 @@ void ogs_pfcp_subnet_remove_all(void)
 
 ogs_pfcp_subnet_t *ogs_pfcp_find_subnet(int family)
 {
-    ogs_pfcp_subnet_t *subnet = NULL;
-
-    ogs_assert(family == AF_INET || family == AF_INET6);
-
-    ogs_list_for_each(&self.subnet_list, subnet) {
-        if ((subnet->family == AF_UNSPEC || subnet->family == family) &&
-            (strlen(subnet->dnn) == 0) &&
-            subnet->pool.avail)
-            break;
-    }
-
-    return subnet;
+    return find_subnet(subnet_group_find(NULL), family, NULL);
 }
 
 ogs_pfcp_subnet_t *ogs_pfcp_find_subnet_by_dnn(int family, const char *dnn)
 {
-    ogs_pfcp_subnet_t *subnet = NULL;
-
     ogs_assert(dnn);
-    ogs_assert(family == AF_INET || family == AF_INET6);
-
-    ogs_list_for_each(&self.subnet_list, subnet) {
-        if ((subnet->family == AF_UNSPEC || subnet->family == family) &&
-            (strlen(subnet->dnn) == 0 ||
-                (strlen(subnet->dnn) && ogs_strcasecmp(subnet->dnn, dnn) == 0)) &&
-            subnet->pool.avail)
-            break;
-    }
 
-    return subnet;
+    return find_subnet(subnet_group_find(dnn), family, NULL);
 }
 
 void ogs_pfcp_pool_init(ogs_pfcp_sess_t *sess)
@@ -38,6 +38,7 @@ extern "C" {
 
 #define OGS_MAX_NUM_OF_DEV      16
 #define OGS_MAX_NUM_OF_SUBNET   16
+#define OGS_MAX_NUM_OF_UE_IP_IN_SUBNET (1 << 24)
 
 typedef struct ogs_pfcp_node_s ogs_pfcp_node_t;
 
@@ -57,6 +58,8 @@ typedef struct ogs_pfcp_context_s {
 
     uint32_t        local_recovery; /* UTC time */
 
+    bool            batch;          /* Flush sendto() at end of event loop */
+
     /* CP Function Features */
     ogs_pfcp_cp_function_features_t cp_function_features;
     /* UP Function Features */
@@ -68,10 +71,18 @@ typedef struct ogs_pfcp_context_s {
 
     ogs_list_t      dev_list;       /* Tun Device List */
     ogs_list_t      subnet_list;    /* UE Subnet List */
+    ogs_hash_t      *subnet_dnn_hash; /* hash table for UE Subnet(DNN) */
 
     ogs_hash_t      *object_teid_hash; /* hash table for PFCP OBJ(TEID) */
     ogs_hash_t      *far_f_teid_hash;  /* hash table for FAR(TEID+ADDR) */
     ogs_hash_t      *far_teid_hash; /* hash table for FAR(TEID) */
+
+    /* Downlink packets buffered for idle UEs */
+    struct {
+        int         num;        /* Packets buffered by all FARs */
+        int         max;        /* Share of the packet pool */
+        ogs_list_t  far_list;   /* FARs holding packets, oldest first */
+    } buffer;
 } ogs_pfcp_context_t;
 
 #define OGS_SETUP_PFCP_NODE(__cTX, __pNODE) \
@@ -102,6 +113,8 @@ typedef struct ogs_pfcp_node_s {
     ogs_list_t      local_list;
     ogs_list_t      remote_list;
 
+    ogs_list_t      sess_list;      /* Sessions served by this node */
+
     ogs_fsm_t       sm;             /* A state machine */
     ogs_timer_t     *t_association; /* timer to retry to associate peer node */
     ogs_timer_t     *t_no_heartbeat; /* heartbeat timer to check aliveness */
@@ -122,6 +135,20 @@ typedef struct ogs_pfcp_node_s {
 
     ogs_pfcp_up_function_features_t up_function_features;
     int up_function_features_len;
+
+    /* Load Control Information (TS29.244 Ch 6.2.3) */
+    struct {
+        bool        presence;
+        uint32_t    seqn;
+        uint8_t     metric;         /* 0 ~ 100 */
+    } load;
+    /* Overload Control Information (TS29.244 Ch 6.2.4) */
+    struct {
+        bool        presence;
+        uint32_t    seqn;
+        uint8_t     reduction;      /* 0 ~ 100 */
+        ogs_time_t  expires;        /* 0 means no expiration */
+    } overload;
 } ogs_pfcp_node_t;
 
 typedef enum {
@@ -258,10 +285,23 @@ typedef struct ogs_pfcp_far_s {
     ogs_pfcp_outer_header_creation_t outer_header_creation;
     int                     outer_header_creation_len;
 
+    /*
+     * G-PDU header pre-built by ogs_pfcp_send_g_pdu().
+     * Rebuilt whenever the TEID or the QFI it was built for changes.
+     */
+    struct {
+        bool                valid;
+        uint32_t            teid;
+        uint8_t             qfi;
+        ogs_gtp2_header_template_t hdr;
+    } gtpu_template;
+
     ogs_pfcp_smreq_flags_t  smreq_flags;
 
     uint32_t                num_of_buffered_packet;
-    ogs_pkbuf_t             *buffered_packet[OGS_MAX_NUM_OF_PACKET_BUFFER];
+    size_t                  buffered_size;
+    ogs_list_t              buffered_list;  /* pkbuf list, oldest first */
+    ogs_lnode_t             buffer_lnode;   /* A node of buffer.far_list */
 
     struct {
         bool prepared;
@@ -301,6 +341,20 @@ typedef struct ogs_pfcp_urr_s {
     ogs_pfcp_sess_t         *sess;
 } ogs_pfcp_urr_t;
 
+/*
+ * Token bucket used to police the MBR of a QER.
+ *
+ * Tokens are counted in bytes and refilled from the elapsed time
+ * when a packet arrives, so no timer is needed per bucket.
+ */
+typedef struct ogs_pfcp_policer_s {
+    uint64_t                rate;       /* Bytes per second, 0 : unpoliced */
+    uint64_t                burst;      /* Bucket depth in bytes */
+    uint64_t                tokens;     /* Available bytes */
+    uint64_t                remainder;  /* Sub-byte credit (byte-usec) */
+    ogs_time_t              last;       /* Last refill time */
+} ogs_pfcp_policer_t;
+
 typedef struct ogs_pfcp_qer_s {
     ogs_lnode_t             lnode;
 
@@ -311,6 +365,11 @@ typedef struct ogs_pfcp_qer_s {
     ogs_pfcp_bitrate_t      mbr;
     ogs_pfcp_bitrate_t      gbr;
 
+    struct {
+        ogs_pfcp_policer_t  uplink;
+        ogs_pfcp_policer_t  downlink;
+    } policer;
+
     uint8_t                 qfi;
 
     ogs_pfcp_sess_t         *sess;
@@ -345,6 +404,8 @@ typedef struct ogs_pfcp_subnet_s ogs_pfcp_subnet_t;
 typedef struct ogs_pfcp_ue_ip_s {
     uint32_t        addr[4];
     bool            static_ip;
+    int             index;          /* Bit in subnet->bitmap, or -1
+                                       if outside the subnet ranges */
 
     /* Related Context */
     ogs_pfcp_subnet_t    *subnet;
@@ -377,7 +438,28 @@ typedef struct ogs_pfcp_subnet_s {
 
     int             family;         /* AF_INET or AF_INET6 */
     uint8_t         prefixlen;      /* prefixlen */
-    OGS_POOL(pool, ogs_pfcp_ue_ip_t);
+
+    /*
+     * One bit per address. The ranges are laid out back to back, so bit N
+     * is address 'N - block.first' of the block that holds it. Dynamic and
+     * static addresses are reserved in the same bitmap.
+     */
+    ogs_bitmap_t    bitmap;
+    ogs_hash_t      *shared;        /* Index -> extra static holders */
+    struct {
+        uint32_t    start[4];       /* First address (IPv6: 64bit prefix) */
+        int         first;          /* Bit of 'start' */
+        int         count;
+    } block[OGS_MAX_NUM_OF_SUBNET_RANGE];
+    int             num_of_block;
+
+    /* Exported as the ue_pool_* metrics of the SMF and the UPF */
+    struct {
+        int         reserved;       /* Network and gateway address */
+        uint64_t    alloc;          /* Dynamic addresses handed out */
+        uint64_t    static_alloc;   /* Static addresses reserved */
+        uint64_t    failure;        /* Requests with no address left */
+    } stats;
 
     ogs_pfcp_dev_t  *dev;           /* Related Context */
 } ogs_pfcp_subnet_t;
@@ -398,6 +480,7 @@ ED6(uint8_t     spare1:3;,
     };
 
     ogs_ipfw_rule_t ipfw;
+    char *flow_description;         /* As received in the SDF Filter */
     uint32_t sdf_filter_id;
 
     /* Related Context */
@@ -420,6 +503,9 @@ int ogs_pfcp_node_merge(ogs_pfcp_node_t *node,
     ogs_pfcp_node_id_t *node_id, ogs_sockaddr_t *from);
 void ogs_pfcp_node_remove(ogs_list_t *list, ogs_pfcp_node_t *node);
 void ogs_pfcp_node_remove_all(ogs_list_t *list);
+
+uint8_t ogs_pfcp_node_load_metric(ogs_pfcp_node_t *node);
+uint8_t ogs_pfcp_node_overload_reduction(ogs_pfcp_node_t *node);
 bool ogs_pfcp_node_id_compare(
         const ogs_pfcp_node_id_t *id1, const ogs_pfcp_node_id_t *id2);
 
@@ -474,6 +560,10 @@ ogs_pfcp_far_t *ogs_pfcp_far_find_by_teid(uint32_t teid);
 void ogs_pfcp_far_remove(ogs_pfcp_far_t *far);
 void ogs_pfcp_far_remove_all(ogs_pfcp_sess_t *sess);
 
+void ogs_pfcp_far_buffer_packet(ogs_pfcp_far_t *far, ogs_pkbuf_t *pkbuf);
+ogs_pkbuf_t *ogs_pfcp_far_unbuffer_packet(ogs_pfcp_far_t *far);
+void ogs_pfcp_far_drop_buffered_packet(ogs_pfcp_far_t *far);
+
 ogs_pfcp_urr_t *ogs_pfcp_urr_add(ogs_pfcp_sess_t *sess);
 ogs_pfcp_urr_t *ogs_pfcp_urr_find(
         ogs_pfcp_sess_t *sess, ogs_pfcp_urr_id_t id);
@@ -489,6 +579,9 @@ ogs_pfcp_qer_t *ogs_pfcp_qer_find_or_add(
         ogs_pfcp_sess_t *sess, ogs_pfcp_qer_id_t id);
 void ogs_pfcp_qer_remove(ogs_pfcp_qer_t *qer);
 void ogs_pfcp_qer_remove_all(ogs_pfcp_sess_t *sess);
+void ogs_pfcp_qer_policer_setup(ogs_pfcp_qer_t *qer);
+bool ogs_pfcp_qer_police(ogs_pfcp_qer_t *qer,
+        bool is_uplink, size_t size, ogs_time_t now);
 
 ogs_pfcp_bar_t *ogs_pfcp_bar_new(ogs_pfcp_sess_t *sess);
 void ogs_pfcp_bar_delete(ogs_pfcp_bar_t *bar);
@@ -105,6 +105,10 @@ bool ogs_pfcp_cp_handle_association_setup_request(
 
     ogs_gtpu_resource_remove_all(&node->gtpu_resource_list);
 
+    /* Load/Overload sequence numbers restart with a new association */
+    memset(&node->load, 0, sizeof(node->load));
+    memset(&node->overload, 0, sizeof(node->overload));
+
     for (i = 0; i < OGS_MAX_NUM_OF_GTPU_RESOURCE; i++) {
         ogs_pfcp_tlv_user_plane_ip_resource_information_t *message =
             &req->user_plane_ip_resource_information[i];
@@ -152,6 +156,10 @@ bool ogs_pfcp_cp_handle_association_setup_response(
 
     ogs_gtpu_resource_remove_all(&node->gtpu_resource_list);
 
+    /* Load/Overload sequence numbers restart with a new association */
+    memset(&node->load, 0, sizeof(node->load));
+    memset(&node->overload, 0, sizeof(node->overload));
+
     for (i = 0; i < OGS_MAX_NUM_OF_GTPU_RESOURCE; i++) {
         ogs_pfcp_tlv_user_plane_ip_resource_information_t *message =
             &rsp->user_plane_ip_resource_information[i];
@@ -184,6 +192,107 @@ bool ogs_pfcp_cp_handle_association_setup_response(
     return true;
 }
 
+static bool seqn_is_newer(bool presence, uint32_t old, uint32_t seqn)
+{
+    /* TS29.244 Ch 6.2.3.3.2: compared with wrap-around */
+    return presence == false || (int32_t)(seqn - old) > 0;
+}
+
+static ogs_time_t timer_to_usec(uint8_t timer)
+{
+    uint8_t unit = (timer >> 5) & 0x07;
+    uint8_t value = timer & 0x1f;
+
+    /* TS29.244 Ch 8.2.30 Timer */
+    switch (unit) {
+    case 0: return ogs_time_from_sec(value * 2);
+    case 1: return ogs_time_from_sec(value * 60);
+    case 2: return ogs_time_from_sec(value * 600);
+    case 3: return ogs_time_from_sec(value * 3600);
+    case 4: return ogs_time_from_sec(value * 36000);
+    case 7: return 0;   /* Infinite */
+    default: return ogs_time_from_sec(value * 60);
+    }
+}
+
+void ogs_pfcp_cp_handle_load_control_information(ogs_pfcp_node_t *node,
+        ogs_pfcp_tlv_load_control_information_t *message)
+{
+    uint32_t seqn;
+    uint8_t metric;
+
+    ogs_assert(node);
+    ogs_assert(message);
+
+    if (message->presence == 0)
+        return;
+
+    if (message->load_control_sequence_number.presence == 0 ||
+        message->load_control_sequence_number.len != 4 ||
+        message->load_metric.presence == 0 ||
+        message->load_metric.len != 1) {
+        ogs_error("Invalid Load Control Information");
+        return;
+    }
+
+    memcpy(&seqn, message->load_control_sequence_number.data, 4);
+    seqn = be32toh(seqn);
+    metric = *(uint8_t *)message->load_metric.data;
+
+    if (seqn_is_newer(node->load.presence, node->load.seqn, seqn) == false)
+        return;
+
+    node->load.presence = true;
+    node->load.seqn = seqn;
+    node->load.metric = ogs_min(metric, 100);
+
+    ogs_debug("[%s] Load Metric [%d]",
+            ogs_sockaddr_to_string_static(node->addr_list), node->load.metric);
+}
+
+void ogs_pfcp_cp_handle_overload_control_information(ogs_pfcp_node_t *node,
+        ogs_pfcp_tlv_overload_control_information_t *message)
+{
+    uint32_t seqn;
+    uint8_t reduction;
+    ogs_time_t validity;
+
+    ogs_assert(node);
+    ogs_assert(message);
+
+    if (message->presence == 0)
+        return;
+
+    if (message->overload_control_sequence_number.presence == 0 ||
+        message->overload_control_sequence_number.len != 4 ||
+        message->overload_reduction_metric.presence == 0 ||
+        message->overload_reduction_metric.len != 1 ||
+        message->period_of_validity.presence == 0 ||
+        message->period_of_validity.len != 1) {
+        ogs_error("Invalid Overload Control Information");
+        return;
+    }
+
+    memcpy(&seqn, message->overload_control_sequence_number.data, 4);
+    seqn = be32toh(seqn);
+    reduction = *(uint8_t *)message->overload_reduction_metric.data;
+    validity = timer_to_usec(*(uint8_t *)message->period_of_validity.data);
+
+    if (seqn_is_newer(
+            node->overload.presence, node->overload.seqn, seqn) == false)
+        return;
+
+    node->overload.presence = true;
+    node->overload.seqn = seqn;
+    node->overload.reduction = ogs_min(reduction, 100);
+    node->overload.expires =
+        validity ? ogs_get_monotonic_time() + validity : 0;
+
+    ogs_debug("[%s] Overload Reduction Metric [%d]",
+            ogs_sockaddr_to_string_static(node->addr_list),
+            node->overload.reduction);
+}
+
 bool ogs_pfcp_up_handle_association_setup_request(
         ogs_pfcp_node_t *node, ogs_pfcp_xact_t *xact,
         ogs_pfcp_association_setup_request_t *req)
@@ -280,11 +389,7 @@ bool ogs_pfcp_up_handle_pdr(
             report->type.downlink_data_report = 1;
         }
 
-        if (far->num_of_buffered_packet < OGS_MAX_NUM_OF_PACKET_BUFFER) {
-            far->buffered_packet[far->num_of_buffered_packet++] = sendbuf;
-        } else {
-            ogs_pkbuf_free(sendbuf);
-        }
+        ogs_pfcp_far_buffer_packet(far, sendbuf);
     }
 
     return true;
@@ -471,7 +576,8 @@ ogs_pfcp_pdr_t *ogs_pfcp_handle_create_pdr(ogs_pfcp_sess_t *sess,
             rv = ogs_ipfw_compile_rule(&rule->ipfw, flow_description);
             ogs_assert(rv == OGS_OK);
 
-            ogs_free(flow_description);
+            /* Kept as received, so that the PDR can be built again */
+            rule->flow_description = flow_description;
 /*
  *
  * TS29.244 Ch 5.2.1A.2A
@@ -822,7 +928,8 @@ ogs_pfcp_pdr_t *ogs_pfcp_handle_update_pdr(ogs_pfcp_sess_t *sess,
                 rv = ogs_ipfw_compile_rule(&rule->ipfw, flow_description);
                 ogs_assert(rv == OGS_OK);
 
-                ogs_free(flow_description);
+                /* Kept as received, so that the PDR can be built again */
+                rule->flow_description = flow_description;
     /*
      *
      * TS29.244 Ch 5.2.1A.2A
@@ -959,6 +1066,7 @@ ogs_pfcp_far_t *ogs_pfcp_handle_create_far(ogs_pfcp_sess_t *sess,
 
     far->dst_if = 0;
     memset(&far->outer_header_creation, 0, sizeof(far->outer_header_creation));
+    far->gtpu_template.valid = false;
 
     if (far->dnn) {
         ogs_free(far->dnn);
@@ -1122,6 +1230,7 @@ ogs_pfcp_far_t *ogs_pfcp_handle_update_far(ogs_pfcp_sess_t *sess,
                             outer_header_creation->len));
             far->outer_header_creation.teid =
                     be32toh(far->outer_header_creation.teid);
+            far->gtpu_template.valid = false;
         }
     }
 
@@ -1208,6 +1317,8 @@ ogs_pfcp_qer_t *ogs_pfcp_handle_create_qer(ogs_pfcp_sess_t *sess,
     if (message->qos_flow_identifier.presence)
         qer->qfi = message->qos_flow_identifier.u8;
 
+    ogs_pfcp_qer_policer_setup(qer);
+
     return qer;
 }
 
@@ -1243,6 +1354,8 @@ ogs_pfcp_qer_t *ogs_pfcp_handle_update_qer(ogs_pfcp_sess_t *sess,
     if (message->guaranteed_bitrate.presence)
         ogs_pfcp_parse_bitrate(&qer->gbr, &message->guaranteed_bitrate);
 
+    ogs_pfcp_qer_policer_setup(qer);
+
     return qer;
 }
 
@@ -38,6 +38,11 @@ bool ogs_pfcp_cp_handle_association_setup_response(
         ogs_pfcp_node_t *node, ogs_pfcp_xact_t *xact,
         ogs_pfcp_association_setup_response_t *req);
 
+void ogs_pfcp_cp_handle_load_control_information(ogs_pfcp_node_t *node,
+        ogs_pfcp_tlv_load_control_information_t *message);
+void ogs_pfcp_cp_handle_overload_control_information(ogs_pfcp_node_t *node,
+        ogs_pfcp_tlv_overload_control_information_t *message);
+
 bool ogs_pfcp_up_handle_association_setup_request(
         ogs_pfcp_node_t *node, ogs_pfcp_xact_t *xact,
         ogs_pfcp_association_setup_request_t *req);
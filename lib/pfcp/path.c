@@ -40,43 +40,17 @@ ogs_sock_t *ogs_pfcp_server(ogs_socknode_t *node)
 #define MIN_PFCP_HEADER_LENGTH 12
 
 /*
- * ogs_pfcp_recvfrom
- *
- * Receives a PFCP message from the socket 'fd'. It allocates a pkbuf,
- * receives the message, trims the pkbuf, and verifies the header.
- * If any error occurs (e.g., too short message, unsupported version, or
- * incomplete message), the function frees the pkbuf and returns NULL.
- *
- * The sender's address is stored in 'from'.
- *
- * Returns a pointer to ogs_pkbuf_t on success, or NULL on failure.
+ * Verifies the header of a received PFCP message of 'size' bytes.
+ * If it is too short, of an unsupported version, or incomplete,
+ * the pkbuf is freed and false is returned.
  */
-ogs_pkbuf_t *ogs_pfcp_recvfrom(ogs_socket_t fd, ogs_sockaddr_t *from)
+static bool check_message(ogs_socket_t fd,
+        ogs_pkbuf_t *pkbuf, ssize_t size, ogs_sockaddr_t *from)
 {
-    ogs_pkbuf_t *pkbuf;
-    ssize_t size;
     ogs_pfcp_header_t *h;
     uint16_t pfcp_body_length;
     size_t expected_total_length;
 
-    ogs_assert(fd != INVALID_SOCKET);
-    ogs_assert(from);
-
-    /* Allocate buffer for maximum SDU length */
-    pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
-    if (pkbuf == NULL) {
-        ogs_error("ogs_pkbuf_alloc() failed");
-        return NULL;
-    }
-    ogs_pkbuf_put(pkbuf, OGS_MAX_SDU_LEN);
-
-    size = ogs_recvfrom(fd, pkbuf->data, pkbuf->len, 0, from);
-    if (size <= 0) {
-        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
-            "ogs_recvfrom() failed");
-        ogs_pkbuf_free(pkbuf);
-        return NULL;
-    }
     ogs_pkbuf_trim(pkbuf, size);
 
     /* Check that the data is at least as long as the header */
@@ -84,7 +58,7 @@ ogs_pkbuf_t *ogs_pfcp_recvfrom(ogs_socket_t fd, ogs_sockaddr_t *from)
         ogs_error("Received PFCP message too short: %ld bytes (min %d)",
             (long)size, MIN_PFCP_HEADER_LENGTH);
         ogs_pkbuf_free(pkbuf);
-        return NULL;
+        return false;
     }
 
     h = (ogs_pfcp_header_t *)pkbuf->data;
@@ -103,7 +77,7 @@ ogs_pkbuf_t *ogs_pfcp_recvfrom(ogs_socket_t fd, ogs_sockaddr_t *from)
                 "ogs_sendto() failed");
         }
         ogs_pkbuf_free(pkbuf);
-        return NULL;
+        return false;
     }
 
     /* Check total PFCP message length.
@@ -115,12 +89,237 @@ ogs_pkbuf_t *ogs_pfcp_recvfrom(ogs_socket_t fd, ogs_sockaddr_t *from)
         ogs_error("Invalid PFCP Header Length: expected %zu bytes, "
             "received %ld bytes", expected_total_length, (long)size);
         ogs_pkbuf_free(pkbuf);
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * ogs_pfcp_recvfrom
+ *
+ * Receives a PFCP message from the socket 'fd'. It allocates a pkbuf,
+ * receives the message, trims the pkbuf, and verifies the header.
+ * If any error occurs (e.g., too short message, unsupported version, or
+ * incomplete message), the function frees the pkbuf and returns NULL.
+ *
+ * The sender's address is stored in 'from'.
+ *
+ * Returns a pointer to ogs_pkbuf_t on success, or NULL on failure.
+ */
+ogs_pkbuf_t *ogs_pfcp_recvfrom(ogs_socket_t fd, ogs_sockaddr_t *from)
+{
+    ogs_pkbuf_t *pkbuf;
+    ssize_t size;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(from);
+
+    /* Allocate buffer for maximum SDU length */
+    pkbuf = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
+    if (pkbuf == NULL) {
+        ogs_error("ogs_pkbuf_alloc() failed");
+        return NULL;
+    }
+    ogs_pkbuf_put(pkbuf, OGS_MAX_SDU_LEN);
+
+    size = ogs_recvfrom(fd, pkbuf->data, pkbuf->len, 0, from);
+    if (size <= 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+            "ogs_recvfrom() failed");
+        ogs_pkbuf_free(pkbuf);
         return NULL;
     }
 
+    if (check_message(fd, pkbuf, size, from) == false)
+        return NULL;
+
     return pkbuf;
 }
 
+/*
+ * ogs_pfcp_recvmmsg
+ *
+ * Drains up to 'max' PFCP messages queued on the socket 'fd' with
+ * a single system call where recvmmsg() is available. Each message is
+ * verified as in ogs_pfcp_recvfrom(), and invalid ones are dropped.
+ *
+ * Returns the number of valid messages stored in 'pkbuf' and 'from'.
+ */
+int ogs_pfcp_recvmmsg(ogs_socket_t fd,
+        ogs_pkbuf_t *pkbuf[], ogs_sockaddr_t from[], int max)
+{
+#if HAVE_RECVMMSG
+    struct mmsghdr msg[OGS_PFCP_MAX_RECV_BATCH];
+    struct iovec iov[OGS_PFCP_MAX_RECV_BATCH];
+    ogs_pkbuf_t *recvbuf[OGS_PFCP_MAX_RECV_BATCH];
+    int i, n, num = 0;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    ogs_assert(pkbuf);
+    ogs_assert(from);
+    ogs_assert(max > 0 && max <= OGS_PFCP_MAX_RECV_BATCH);
+
+    memset(msg, 0, sizeof(msg[0]) * max);
+    for (i = 0; i < max; i++) {
+        /* Allocate buffer for maximum SDU length */
+        recvbuf[i] = ogs_pkbuf_alloc(NULL, OGS_MAX_SDU_LEN);
+        if (recvbuf[i] == NULL) {
+            ogs_error("ogs_pkbuf_alloc() failed");
+            break;
+        }
+        ogs_pkbuf_put(recvbuf[i], OGS_MAX_SDU_LEN);
+
+        iov[i].iov_base = recvbuf[i]->data;
+        iov[i].iov_len = recvbuf[i]->len;
+
+        memset(&from[i], 0, sizeof(from[i]));
+        msg[i].msg_hdr.msg_name = &from[i].sa;
+        msg[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+        msg[i].msg_hdr.msg_iov = &iov[i];
+        msg[i].msg_hdr.msg_iovlen = 1;
+    }
+    max = i;
+
+    n = max ? recvmmsg(fd, msg, max, MSG_DONTWAIT, NULL) : 0;
+    if (n < 0) {
+        if (ogs_socket_errno != OGS_EAGAIN)
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                "recvmmsg() failed");
+        n = 0;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (msg[i].msg_len == 0) {
+            ogs_pkbuf_free(recvbuf[i]);
+            continue;
+        }
+        if (check_message(fd, recvbuf[i], msg[i].msg_len, &from[i]) == false)
+            continue;
+
+        if (num != i)
+            memcpy(&from[num], &from[i], sizeof(from[num]));
+        pkbuf[num++] = recvbuf[i];
+    }
+    for (i = n; i < max; i++)
+        ogs_pkbuf_free(recvbuf[i]);
+
+    return num;
+#else
+    ogs_assert(max > 0);
+
+    pkbuf[0] = ogs_pfcp_recvfrom(fd, &from[0]);
+    return pkbuf[0] ? 1 : 0;
+#endif
+}
+
+/*
+ * Outgoing messages held until ogs_pfcp_flush()
+ * when 'pfcp.batch' is enabled in the configuration.
+ */
+static struct {
+    int num;
+    struct {
+        ogs_socket_t fd;
+        ogs_sockaddr_t addr;
+        ogs_pkbuf_t *pkbuf;
+    } msg[OGS_PFCP_MAX_SEND_BATCH];
+} sendq;
+
+static int enqueue_message(
+        ogs_socket_t fd, ogs_sockaddr_t *addr, ogs_pkbuf_t *pkbuf)
+{
+    ogs_pkbuf_t *copy = NULL;
+
+    if (sendq.num == OGS_PFCP_MAX_SEND_BATCH)
+        ogs_pfcp_flush();
+
+    /* The transaction keeps the original for retransmission */
+    copy = ogs_pkbuf_copy(pkbuf);
+    if (!copy) {
+        ogs_error("ogs_pkbuf_copy() failed");
+        return OGS_ERROR;
+    }
+
+    sendq.msg[sendq.num].fd = fd;
+    memcpy(&sendq.msg[sendq.num].addr, addr, sizeof(*addr));
+    sendq.msg[sendq.num].pkbuf = copy;
+    sendq.num++;
+
+    return OGS_OK;
+}
+
+void ogs_pfcp_flush(void)
+{
+    char buf[OGS_ADDRSTRLEN];
+    int i;
+#if HAVE_SENDMMSG
+    struct mmsghdr msg[OGS_PFCP_MAX_SEND_BATCH];
+    struct iovec iov[OGS_PFCP_MAX_SEND_BATCH];
+    int j, k, n;
+#endif
+
+    if (sendq.num == 0)
+        return;
+
+#if HAVE_SENDMMSG
+    memset(msg, 0, sizeof(msg[0]) * sendq.num);
+    for (i = 0; i < sendq.num; i++) {
+        iov[i].iov_base = sendq.msg[i].pkbuf->data;
+        iov[i].iov_len = sendq.msg[i].pkbuf->len;
+
+        msg[i].msg_hdr.msg_name = &sendq.msg[i].addr.sa;
+        msg[i].msg_hdr.msg_namelen = ogs_sockaddr_len(&sendq.msg[i].addr);
+        msg[i].msg_hdr.msg_iov = &iov[i];
+        msg[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    /* One system call for each run of messages on the same socket */
+    for (i = 0; i < sendq.num; i = j) {
+        for (j = i + 1; j < sendq.num; j++)
+            if (sendq.msg[j].fd != sendq.msg[i].fd)
+                break;
+
+        /*
+         * sendmmsg() stops at the first message it cannot send. Resume
+         * from there; when the failing message comes first, its error
+         * is reported and only that message is skipped.
+         */
+        for (k = i; k < j; k += n) {
+            n = sendmmsg(sendq.msg[k].fd, &msg[k], j - k, 0);
+            if (n > 0)
+                continue;
+
+            if (ogs_socket_errno != OGS_EAGAIN)
+                ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                        "sendmmsg(%u, %u) failed [%s]:%u",
+                        sendq.msg[k].fd, sendq.msg[k].pkbuf->len,
+                        OGS_ADDR(&sendq.msg[k].addr, buf),
+                        OGS_PORT(&sendq.msg[k].addr));
+            n = 1;
+        }
+    }
+#else
+    for (i = 0; i < sendq.num; i++) {
+        ssize_t sent = ogs_sendto(sendq.msg[i].fd,
+                sendq.msg[i].pkbuf->data, sendq.msg[i].pkbuf->len, 0,
+                &sendq.msg[i].addr);
+        if (sent < 0 || sent != sendq.msg[i].pkbuf->len) {
+            if (ogs_socket_errno != OGS_EAGAIN)
+                ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                        "ogs_sendto(%u, %u) failed [%s]:%u",
+                        sendq.msg[i].fd, sendq.msg[i].pkbuf->len,
+                        OGS_ADDR(&sendq.msg[i].addr, buf),
+                        OGS_PORT(&sendq.msg[i].addr));
+        }
+    }
+#endif
+
+    for (i = 0; i < sendq.num; i++)
+        ogs_pkbuf_free(sendq.msg[i].pkbuf);
+    sendq.num = 0;
+}
+
 int ogs_pfcp_sendto(ogs_pfcp_node_t *node, ogs_pkbuf_t *pkbuf)
 {
     ssize_t sent;
@@ -157,7 +356,12 @@ int ogs_pfcp_sendto(ogs_pfcp_node_t *node, ogs_pkbuf_t *pkbuf)
     } else
         ogs_assert_if_reached();
 
-    sent = ogs_sendto(sock->fd, pkbuf->data, pkbuf->len, 0, addr);
+    if (ogs_pfcp_self()->batch) {
+        if (enqueue_message(sock->fd, addr, pkbuf) != OGS_OK)
+            return OGS_ERROR;
+        sent = pkbuf->len;
+    } else
+        sent = ogs_sendto(sock->fd, pkbuf->data, pkbuf->len, 0, addr);
     if (sent < 0 || sent != pkbuf->len) {
         if (ogs_socket_errno != OGS_EAGAIN) {
             char buf[OGS_ADDRSTRLEN];
@@ -401,6 +605,7 @@ void ogs_pfcp_send_g_pdu(
 {
     ogs_gtp_node_t *gnode = NULL;
     ogs_pfcp_far_t *far = NULL;
+    uint8_t qfi;
 
     ogs_gtp2_header_desc_t header_desc;
 
@@ -425,15 +630,51 @@ void ogs_pfcp_send_g_pdu(
     ogs_assert(gnode);
     ogs_assert(gnode->sock);
 
+    qfi = (pdr->qer && pdr->qer->qfi) ? pdr->qer->qfi : 0;
+
+    /*
+     * Fast path: a plain G-PDU only depends on the TEID and the QFI,
+     * which change on PFCP Session Modification at most. Keep the
+     * encoded header in the FAR and just copy it in front of the packet.
+     */
+    if (sendhdr->type == OGS_GTPU_MSGTYPE_GPDU &&
+        sendhdr->udp.presence == false &&
+        sendhdr->pdcp_number_presence == false) {
+        if (far->gtpu_template.valid == false ||
+            far->gtpu_template.teid != far->outer_header_creation.teid ||
+            far->gtpu_template.qfi != qfi) {
+            memset(&header_desc, 0, sizeof(header_desc));
+
+            header_desc.type = OGS_GTPU_MSGTYPE_GPDU;
+            header_desc.teid = far->outer_header_creation.teid;
+
+            if (qfi) {
+                header_desc.pdu_type =
+                OGS_GTP2_EXTENSION_HEADER_PDU_TYPE_DL_PDU_SESSION_INFORMATION;
+                header_desc.qos_flow_identifier = qfi;
+            }
+
+            ogs_gtp2_build_header_template(
+                    &far->gtpu_template.hdr, &header_desc);
+            far->gtpu_template.teid = far->outer_header_creation.teid;
+            far->gtpu_template.qfi = qfi;
+            far->gtpu_template.valid = true;
+        }
+
+        ogs_gtp2_send_user_plane_with_template(
+                gnode, &far->gtpu_template.hdr, sendbuf);
+        return;
+    }
+
     memset(&header_desc, 0, sizeof(header_desc));
 
     header_desc.type = sendhdr->type;
     header_desc.teid = far->outer_header_creation.teid;
 
-    if (pdr->qer && pdr->qer->qfi) {
+    if (qfi) {
         header_desc.pdu_type =
             OGS_GTP2_EXTENSION_HEADER_PDU_TYPE_DL_PDU_SESSION_INFORMATION;
-        header_desc.qos_flow_identifier = pdr->qer->qfi;
+        header_desc.qos_flow_identifier = qfi;
     }
 
     if (sendhdr->udp.presence == true) {
@@ -498,23 +739,20 @@ int ogs_pfcp_send_end_marker(ogs_pfcp_pdr_t *pdr)
 void ogs_pfcp_send_buffered_packet(ogs_pfcp_pdr_t *pdr)
 {
     ogs_pfcp_far_t *far = NULL;
-    int i;
+    ogs_pkbuf_t *pkbuf = NULL;
 
     ogs_assert(pdr);
     far = pdr->far;
 
     if (far && far->gnode) {
         if (far->apply_action & OGS_PFCP_APPLY_ACTION_FORW) {
-            for (i = 0; i < far->num_of_buffered_packet; i++) {
-                ogs_gtp2_header_desc_t sendhdr;
+            ogs_gtp2_header_desc_t sendhdr;
 
-                memset(&sendhdr, 0, sizeof(sendhdr));
-                sendhdr.type = OGS_GTPU_MSGTYPE_GPDU;
+            memset(&sendhdr, 0, sizeof(sendhdr));
+            sendhdr.type = OGS_GTPU_MSGTYPE_GPDU;
 
-                ogs_pfcp_send_g_pdu(
-                        pdr, &sendhdr, far->buffered_packet[i]);
-            }
-            far->num_of_buffered_packet = 0;
+            while ((pkbuf = ogs_pfcp_far_unbuffer_packet(far)))
+                ogs_pfcp_send_g_pdu(pdr, &sendhdr, pkbuf);
         }
     }
 }
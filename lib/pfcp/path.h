@@ -53,12 +53,20 @@ extern "C" {
         \
     } while(0)
 
+/* Messages drained from a socket per wakeup */
+#define OGS_PFCP_MAX_RECV_BATCH 16
+/* Messages held before 'pfcp.batch' forces a flush */
+#define OGS_PFCP_MAX_SEND_BATCH 64
+
 typedef struct ogs_pfcp_xact_s ogs_pfcp_xact_t;
 
 ogs_sock_t *ogs_pfcp_server(ogs_socknode_t *node);
 int ogs_pfcp_sendto(ogs_pfcp_node_t *node, ogs_pkbuf_t *pkbuf);
 
 ogs_pkbuf_t *ogs_pfcp_recvfrom(ogs_socket_t fd, ogs_sockaddr_t *from);
+int ogs_pfcp_recvmmsg(ogs_socket_t fd,
+        ogs_pkbuf_t *pkbuf[], ogs_sockaddr_t from[], int max);
+void ogs_pfcp_flush(void);
 
 ogs_pkbuf_t *ogs_pfcp_handle_echo_req(ogs_pkbuf_t *pkt);
 
@@ -258,18 +258,18 @@ ogs_sockaddr_t *ogs_pfcp_node_id_to_addrinfo(const ogs_pfcp_node_id_t *node_id)
      *-----------------------------------------------*/
     case OGS_PFCP_NODE_ID_FQDN:
         /* If the FQDN is not empty, we attempt DNS resolution.
-         *  ogs_addaddrinfo() is a placeholder for your actual
-         *  DNS -> ogs_sockaddr_t function (often wraps getaddrinfo).
+         *  This runs on the PFCP event loop for every association,
+         *  so the answer is taken from the shared DNS cache when possible.
          */
         /* Port=0 or set as needed, family=AF_UNSPEC, flags=0. */
         if (ogs_fqdn_parse(fqdn, node_id->fqdn, strlen(node_id->fqdn)) <= 0) {
             ogs_error("ogs_fqdn_parse() error [%s]", node_id->fqdn);
             return NULL;
         }
-        ret = ogs_getaddrinfo(&p, AF_UNSPEC, fqdn, port, 0);
+        ret = ogs_getaddrinfo_cached(&p, AF_UNSPEC, fqdn, port, 0);
         if (ret != 0) {
             /* DNS resolution failed => *out remains NULL */
-            ogs_error("ogs_addaddrinfo() failed");
+            ogs_error("ogs_getaddrinfo_cached() failed [%s]", fqdn);
             return NULL;
         }
         /* If FQDN is empty, just return with no addresses. */
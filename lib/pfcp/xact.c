@@ -34,6 +34,7 @@ static int ogs_pfcp_xact_initialized = 0;
 static uint32_t g_xact_id = 0;
 
 static OGS_POOL(pool, ogs_pfcp_xact_t);
+static ogs_hash_t *xact_hash = NULL;
 
 static ogs_pfcp_xact_t *ogs_pfcp_xact_remote_create(
         ogs_pfcp_node_t *node, uint32_t sqn);
@@ -45,11 +46,48 @@ static void response_timeout(void *data);
 static void holding_timeout(void *data);
 static void delayed_commit_timeout(void *data);
 
+static void xact_hash_add(ogs_pfcp_xact_t *xact)
+{
+    ogs_pfcp_xact_t *old = NULL;
+
+    xact->key.node = xact->node;
+    xact->key.xid = xact->xid;
+    xact->key.org = xact->org;
+
+    /* A reused sequence number takes over the index entry */
+    old = ogs_hash_get(xact_hash, &xact->key, sizeof(xact->key));
+    if (old)
+        ogs_hash_set(xact_hash, &old->key, sizeof(old->key), NULL);
+
+    ogs_hash_set(xact_hash, &xact->key, sizeof(xact->key), xact);
+}
+
+static void xact_hash_remove(ogs_pfcp_xact_t *xact)
+{
+    if (ogs_hash_get(xact_hash, &xact->key, sizeof(xact->key)) == xact)
+        ogs_hash_set(xact_hash, &xact->key, sizeof(xact->key), NULL);
+}
+
+static ogs_pfcp_xact_t *xact_hash_find(
+        ogs_pfcp_node_t *node, uint8_t org, uint32_t xid)
+{
+    ogs_pfcp_xact_key_t key;
+
+    memset(&key, 0, sizeof(key));
+    key.node = node;
+    key.xid = xid;
+    key.org = org;
+
+    return ogs_hash_get(xact_hash, &key, sizeof(key));
+}
+
 int ogs_pfcp_xact_init(void)
 {
     ogs_assert(ogs_pfcp_xact_initialized == 0);
 
     ogs_pool_init(&pool, ogs_app()->pool.xact);
+    xact_hash = ogs_hash_make();
+    ogs_assert(xact_hash);
 
     g_xact_id = 0;
 
@@ -62,6 +100,7 @@ void ogs_pfcp_xact_final(void)
 {
     ogs_assert(ogs_pfcp_xact_initialized == 1);
 
+    ogs_hash_destroy(xact_hash);
     ogs_pool_final(&pool);
 
     ogs_pfcp_xact_initialized = 0;
@@ -105,6 +144,7 @@ ogs_pfcp_xact_t *ogs_pfcp_xact_local_create(ogs_pfcp_node_t *node,
 
     ogs_list_add(xact->org == OGS_PFCP_LOCAL_ORIGINATOR ?
             &xact->node->local_list : &xact->node->remote_list, xact);
+    xact_hash_add(xact);
 
     ogs_list_init(&xact->pdr_to_create_list);
 
@@ -152,6 +192,7 @@ static ogs_pfcp_xact_t *ogs_pfcp_xact_remote_create(
 
     ogs_list_add(xact->org == OGS_PFCP_LOCAL_ORIGINATOR ?
             &xact->node->local_list : &xact->node->remote_list, xact);
+    xact_hash_add(xact);
 
     ogs_debug("[%d] %s Create  peer %s",
             xact->xid,
@@ -685,7 +726,7 @@ int ogs_pfcp_xact_receive(
     uint8_t type;
     uint32_t sqn, xid;
     ogs_pfcp_xact_stage_t stage;
-    ogs_list_t *list = NULL;
+    uint8_t org;
     ogs_pfcp_xact_t *new = NULL;
 
     ogs_assert(node);
@@ -698,13 +739,13 @@ int ogs_pfcp_xact_receive(
 
     switch (stage) {
     case PFCP_XACT_INITIAL_STAGE:
-        list = &node->remote_list;
+        org = OGS_PFCP_REMOTE_ORIGINATOR;
         break;
     case PFCP_XACT_INTERMEDIATE_STAGE:
-        list = &node->local_list;
+        org = OGS_PFCP_LOCAL_ORIGINATOR;
         break;
     case PFCP_XACT_FINAL_STAGE:
-        list = &node->local_list;
+        org = OGS_PFCP_LOCAL_ORIGINATOR;
         break;
     default:
         ogs_error("[%d] Unexpected type %u from PFCP peer %s",
@@ -712,15 +753,12 @@ int ogs_pfcp_xact_receive(
         return OGS_ERROR;
     }
 
-    ogs_assert(list);
-    ogs_list_for_each(list, new) {
-        if (new->xid == xid) {
-            ogs_debug("[%d] %s Find    peer %s",
-                new->xid,
-                new->org == OGS_PFCP_LOCAL_ORIGINATOR ? "LOCAL " : "REMOTE",
-                ogs_sockaddr_to_string_static(node->addr_list));
-            break;
-        }
+    new = xact_hash_find(node, org, xid);
+    if (new) {
+        ogs_debug("[%d] %s Find    peer %s",
+            new->xid,
+            new->org == OGS_PFCP_LOCAL_ORIGINATOR ? "LOCAL " : "REMOTE",
+            ogs_sockaddr_to_string_static(node->addr_list));
     }
 
     if (!new) {
@@ -807,6 +845,7 @@ int ogs_pfcp_xact_delete(ogs_pfcp_xact_t *xact)
     if (xact->tm_delayed_commit)
         ogs_timer_delete(xact->tm_delayed_commit);
 
+    xact_hash_remove(xact);
     ogs_list_remove(xact->org == OGS_PFCP_LOCAL_ORIGINATOR ?
             &xact->node->local_list : &xact->node->remote_list, xact);
     ogs_pool_id_free(&pool, xact);
@@ -28,6 +28,15 @@
 extern "C" {
 #endif
 
+/**
+ * Key of the transaction index
+ */
+typedef struct ogs_pfcp_xact_key_s {
+    ogs_pfcp_node_t *node;
+    uint32_t        xid;
+    uint8_t         org;
+} ogs_pfcp_xact_key_t;
+
 /**
  * Transaction context
  */
@@ -46,6 +55,7 @@ typedef struct ogs_pfcp_xact_s {
 
     uint32_t        xid;            /**< Transaction ID */
     ogs_pfcp_node_t *node;          /**< Relevant PFCP node context */
+    ogs_pfcp_xact_key_t key;        /**< Key in the transaction index */
 
     /**< Local timer expiration handler & Data*/
     void (*cb)(ogs_pfcp_xact_t *, void *);
@@ -32,6 +32,8 @@ extern "C" {
 #define OGS_MAX_NUM_OF_BEARER           4   /* Num of Bearer per Session */
 #define OGS_BEARER_PER_UE               8   /* Num of Bearer per UE */
 #define OGS_MAX_NUM_OF_PACKET_BUFFER    64  /* Num of PacketBuffer per UE */
+/* Buffer space held by the packets buffered for an idle UE (in bytes) */
+#define OGS_MAX_PACKET_BUFFER_SIZE_PER_UE   (128*1024)
 
 /*
  * TS24.008
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-sbi.h"
+
+ogs_sbi_cache_t *ogs_sbi_cache_create(
+        int size, ogs_time_t ttl, ogs_sbi_cache_free_f free_cb)
+{
+    ogs_sbi_cache_t *cache = NULL;
+
+    ogs_assert(size > 0);
+    ogs_assert(free_cb);
+
+    cache = ogs_calloc(1, sizeof(*cache));
+    ogs_assert(cache);
+
+    cache->size = size;
+    cache->ttl = ttl;
+    cache->free_cb = free_cb;
+
+    ogs_pool_create(&cache->pool, size);
+    ogs_list_init(&cache->list);
+    cache->hash = ogs_hash_make();
+    ogs_assert(cache->hash);
+
+    return cache;
+}
+
+void ogs_sbi_cache_destroy(ogs_sbi_cache_t *cache)
+{
+    ogs_assert(cache);
+
+    ogs_debug("Cache [hit:%llu miss:%llu expired:%llu evicted:%llu]",
+            (unsigned long long)cache->stats.hit,
+            (unsigned long long)cache->stats.miss,
+            (unsigned long long)cache->stats.expired,
+            (unsigned long long)cache->stats.evicted);
+
+    ogs_sbi_cache_remove_all(cache);
+
+    ogs_hash_destroy(cache->hash);
+    ogs_pool_destroy(&cache->pool);
+
+    ogs_free(cache);
+}
+
+static void entry_remove(ogs_sbi_cache_t *cache, ogs_sbi_cache_entry_t *entry)
+{
+    ogs_assert(cache);
+    ogs_assert(entry);
+
+    ogs_list_remove(&cache->list, entry);
+    ogs_hash_set(cache->hash, entry->key, strlen(entry->key), NULL);
+
+    cache->free_cb(entry->data);
+    ogs_free(entry->key);
+
+    ogs_pool_free(&cache->pool, entry);
+}
+
+void *ogs_sbi_cache_get(ogs_sbi_cache_t *cache, const char *key)
+{
+    ogs_sbi_cache_entry_t *entry = NULL;
+
+    ogs_assert(cache);
+    ogs_assert(key);
+
+    entry = ogs_hash_get(cache->hash, key, strlen(key));
+    if (!entry) {
+        cache->stats.miss++;
+        return NULL;
+    }
+
+    if (cache->ttl && entry->expires < ogs_get_monotonic_time()) {
+        entry_remove(cache, entry);
+        cache->stats.expired++;
+        cache->stats.miss++;
+        return NULL;
+    }
+
+    ogs_list_remove(&cache->list, entry);
+    ogs_list_prepend(&cache->list, entry);
+
+    cache->stats.hit++;
+    return entry->data;
+}
+
+void ogs_sbi_cache_set(ogs_sbi_cache_t *cache, const char *key, void *data)
+{
+    ogs_sbi_cache_entry_t *entry = NULL;
+
+    ogs_assert(cache);
+    ogs_assert(key);
+    ogs_assert(data);
+
+    ogs_sbi_cache_remove(cache, key);
+
+    ogs_pool_alloc(&cache->pool, &entry);
+    if (!entry) {
+        entry = ogs_list_last(&cache->list);
+        ogs_assert(entry);
+        entry_remove(cache, entry);
+        cache->stats.evicted++;
+
+        ogs_pool_alloc(&cache->pool, &entry);
+        ogs_assert(entry);
+    }
+    memset(entry, 0, sizeof(*entry));
+
+    entry->key = ogs_strdup(key);
+    ogs_assert(entry->key);
+    entry->data = data;
+    entry->expires = ogs_get_monotonic_time() + cache->ttl;
+
+    ogs_list_prepend(&cache->list, entry);
+    ogs_hash_set(cache->hash, entry->key, strlen(entry->key), entry);
+}
+
+void ogs_sbi_cache_remove(ogs_sbi_cache_t *cache, const char *key)
+{
+    ogs_sbi_cache_entry_t *entry = NULL;
+
+    ogs_assert(cache);
+    ogs_assert(key);
+
+    entry = ogs_hash_get(cache->hash, key, strlen(key));
+    if (entry)
+        entry_remove(cache, entry);
+}
+
+void ogs_sbi_cache_remove_all(ogs_sbi_cache_t *cache)
+{
+    ogs_sbi_cache_entry_t *entry = NULL, *next_entry = NULL;
+
+    ogs_assert(cache);
+
+    ogs_list_for_each_safe(&cache->list, next_entry, entry)
+        entry_remove(cache, entry);
+}
+
+static int param_name_compare(const void *a, const void *b)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/*
+ * The key is the resource path and the query parameters of a request
+ * built by ogs_sbi_build_request(). Every hash table is seeded
+ * differently, so the parameters are sorted by name rather than taken
+ * in hash order.
+ */
+char *ogs_sbi_cache_key(ogs_sbi_request_t *request)
+{
+    ogs_hash_index_t *hi = NULL;
+    const char **name = NULL;
+    char *key = NULL;
+    int i, num_of_param = 0;
+
+    ogs_assert(request);
+    ogs_assert(request->h.method);
+    ogs_assert(request->h.service.name);
+    ogs_assert(request->h.api.version);
+
+    key = ogs_msprintf("%s /%s/%s", request->h.method,
+            request->h.service.name, request->h.api.version);
+    ogs_assert(key);
+
+    for (i = 0; i < OGS_SBI_MAX_NUM_OF_RESOURCE_COMPONENT &&
+                        request->h.resource.component[i]; i++) {
+        key = ogs_mstrcatf(key, "/%s", request->h.resource.component[i]);
+        ogs_assert(key);
+    }
+
+    if (request->http.params)
+        num_of_param = ogs_hash_count(request->http.params);
+    if (num_of_param == 0)
+        return key;
+
+    name = ogs_calloc(num_of_param, sizeof(*name));
+    ogs_assert(name);
+
+    for (i = 0, hi = ogs_hash_first(request->http.params);
+            hi && i < num_of_param; i++, hi = ogs_hash_next(hi))
+        name[i] = ogs_hash_this_key(hi);
+    num_of_param = i;
+
+    qsort(name, num_of_param, sizeof(*name), param_name_compare);
+
+    for (i = 0; i < num_of_param; i++) {
+        key = ogs_mstrcatf(key, "%c%s=%s", i ? '&' : '?', name[i],
+                (char *)ogs_hash_get(request->http.params,
+                    name[i], OGS_HASH_KEY_STRING));
+        ogs_assert(key);
+    }
+
+    ogs_free(name);
+
+    return key;
+}
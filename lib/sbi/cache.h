@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined(OGS_SBI_INSIDE) && !defined(OGS_SBI_COMPILATION)
+#error "This header cannot be included directly."
+#endif
+
+#ifndef OGS_SBI_CACHE_H
+#define OGS_SBI_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bounded LRU cache of decoded SBI data.
+ *
+ * An entry is looked up by the key of the request that fetched it
+ * (see ogs_sbi_cache_key()), so that a consumer can answer a repeated
+ * query without another round-trip to the producer. The least recently
+ * used entry is evicted when the cache is full, and an entry older than
+ * 'ttl' is dropped on lookup. A 'ttl' of zero never expires an entry.
+ */
+typedef void (*ogs_sbi_cache_free_f)(void *data);
+
+typedef struct ogs_sbi_cache_entry_s {
+    ogs_lnode_t     lnode;      /* most recently used first */
+
+    char            *key;
+    void            *data;
+    ogs_time_t      expires;
+} ogs_sbi_cache_entry_t;
+
+typedef struct ogs_sbi_cache_s {
+    int             size;
+    ogs_time_t      ttl;
+    ogs_sbi_cache_free_f free_cb;
+
+    OGS_POOL(pool, ogs_sbi_cache_entry_t);
+    ogs_list_t      list;
+    ogs_hash_t      *hash;
+
+    struct {
+        uint64_t    hit;
+        uint64_t    miss;
+        uint64_t    expired;
+        uint64_t    evicted;
+    } stats;
+} ogs_sbi_cache_t;
+
+ogs_sbi_cache_t *ogs_sbi_cache_create(
+        int size, ogs_time_t ttl, ogs_sbi_cache_free_f free_cb);
+void ogs_sbi_cache_destroy(ogs_sbi_cache_t *cache);
+
+void *ogs_sbi_cache_get(ogs_sbi_cache_t *cache, const char *key);
+void ogs_sbi_cache_set(ogs_sbi_cache_t *cache, const char *key, void *data);
+void ogs_sbi_cache_remove(ogs_sbi_cache_t *cache, const char *key);
+void ogs_sbi_cache_remove_all(ogs_sbi_cache_t *cache);
+
+char *ogs_sbi_cache_key(ogs_sbi_request_t *request);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGS_SBI_CACHE_H */
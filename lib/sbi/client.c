@@ -524,12 +524,17 @@ static connection_t *connection_add(
         curl_easy_setopt(conn->easy,
                 CURLOPT_CUSTOMREQUEST, request->h.method);
         if (request->http.content) {
-            conn->content = ogs_memdup(
-                    request->http.content, request->http.content_length);
-            if (!conn->content) {
-                ogs_error("conn->content is NULL");
-                connection_free(conn);
-                return NULL;
+            if (request->move_content == true) {
+                conn->content = request->http.content;
+                request->http.content = NULL;
+            } else {
+                conn->content = ogs_memdup(
+                        request->http.content, request->http.content_length);
+                if (!conn->content) {
+                    ogs_error("conn->content is NULL");
+                    connection_free(conn);
+                    return NULL;
+                }
             }
             curl_easy_setopt(conn->easy,
                     CURLOPT_POSTFIELDS, conn->content);
@@ -543,7 +548,7 @@ static connection_t *connection_add(
 #endif
             ogs_debug("SENDING...[%d]", (int)request->http.content_length);
             if (request->http.content_length)
-                ogs_debug("%s", request->http.content);
+                ogs_debug("%s", conn->content);
         }
     }
 
@@ -735,9 +740,9 @@ static void check_multi_info(ogs_sbi_client_t *client)
                         response->status, response->h.method, response->h.uri);
 
                 if (conn->memory) {
-                    response->http.content =
-                        ogs_memdup(conn->memory, conn->size + 1);
-                    ogs_assert(response->http.content);
+                    /* The body is NUL-terminated, see write_cb() */
+                    response->http.content = conn->memory;
+                    conn->memory = NULL;
                     response->http.content_length = conn->size;
                     ogs_assert(response->http.content_length);
                 }
@@ -117,6 +117,8 @@ void ogs_sbi_context_final(void)
     ogs_sbi_server_final();
     ogs_sbi_message_final();
 
+    ogs_sbi_suci_clear_hnet_key();
+
     context_initialized = 0;
 }
 
@@ -665,6 +667,7 @@ int ogs_sbi_context_parse_hnet_config(ogs_yaml_iter_t *root_iter)
     ogs_yaml_iter_recurse(root_iter, &hnet_array);
     do {
         uint8_t id = 0, scheme = 0;
+        uint8_t key[OGS_ECCKEY_LEN];
         const char *filename = NULL;
 
         if (ogs_yaml_iter_type(&hnet_array) == YAML_MAPPING_NODE) {
@@ -703,21 +706,17 @@ int ogs_sbi_context_parse_hnet_config(ogs_yaml_iter_t *root_iter)
             id <= OGS_HOME_NETWORK_PKI_VALUE_MAX &&
             filename) {
             if (scheme == OGS_PROTECTION_SCHEME_PROFILE_A) {
-                rv = ogs_pem_decode_curve25519_key(
-                        filename, self.hnet[id].key);
+                rv = ogs_pem_decode_curve25519_key(filename, key);
                 if (rv == OGS_OK) {
-                    self.hnet[id].avail = true;
-                    self.hnet[id].scheme = scheme;
+                    ogs_sbi_suci_set_hnet_key(id, scheme, key);
                 } else {
                     ogs_error("ogs_pem_decode_curve25519_key"
                             "[%s] failed", filename);
                 }
             } else if (scheme == OGS_PROTECTION_SCHEME_PROFILE_B) {
-                rv = ogs_pem_decode_secp256r1_key(
-                        filename, self.hnet[id].key);
+                rv = ogs_pem_decode_secp256r1_key(filename, key);
                 if (rv == OGS_OK) {
-                    self.hnet[id].avail = true;
-                    self.hnet[id].scheme = scheme;
+                    ogs_sbi_suci_set_hnet_key(id, scheme, key);
                 } else {
                     ogs_error("ogs_pem_decode_secp256r1_key[%s]"
                             " failed", filename);
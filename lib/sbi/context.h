@@ -63,6 +63,7 @@ typedef struct ogs_sbi_context_s {
         uint8_t avail;
         uint8_t scheme;
         uint8_t key[OGS_ECCKEY_LEN]; /* 32 bytes Private Key */
+        EVP_PKEY *pkey; /* Imported by ogs_sbi_suci_set_hnet_key() */
     } hnet[OGS_HOME_NETWORK_PKI_VALUE_MAX+1]; /* PKI Value : 1 ~ 254 */
 
     struct {
@@ -125,105 +125,31 @@ char *ogs_supi_from_suci(char *suci)
 
                     ogs_datum_t pubkey;
                     ogs_datum_t cipher_text;
-                    ogs_datum_t plain_text;
-                    char *plain_bcd;
-                    uint8_t mactag1[OGS_MACTAG_LEN], mactag2[OGS_MACTAG_LEN];
-
-                    uint8_t z[OGS_ECCKEY_LEN];
-
-                    uint8_t ek[OGS_KEY_LEN];
-                    uint8_t icb[OGS_IVEC_LEN];
-                    uint8_t mk[OGS_SHA256_DIGEST_SIZE];
-
-                    if (home_network_pki_value <
-                            OGS_HOME_NETWORK_PKI_VALUE_MIN ||
-                        home_network_pki_value >
-                            OGS_HOME_NETWORK_PKI_VALUE_MAX) {
-                        ogs_error("Invalid HNET PKI Value [%s]", array[6]);
-                        break;
-                    }
-
-                    if (!ogs_sbi_self()->hnet[home_network_pki_value].avail) {
-                        ogs_error("HNET PKI Value Not Avaiable [%s]", array[6]);
-                        break;
-                    }
-
-                    if (ogs_sbi_self()->hnet[home_network_pki_value].scheme
-                            != protection_scheme_id) {
-                        ogs_error("Scheme Not Matched [%d != %s]",
-                            ogs_sbi_self()->hnet[protection_scheme_id].scheme,
-                            array[5]);
-                        break;
-                    }
+                    uint8_t plain_text[OGS_MSIN_LEN];
+                    char plain_bcd[OGS_MSIN_LEN*2+1];
+                    uint8_t mactag[OGS_MACTAG_LEN];
 
                     if (parse_scheme_output(
                             array[5], array[7],
-                            &pubkey, &cipher_text, mactag1) != OGS_OK) {
+                            &pubkey, &cipher_text, mactag) != OGS_OK) {
                         ogs_error("parse_scheme_output[%s] failed", array[7]);
                         break;
                     }
 
-                    if (protection_scheme_id ==
-                            OGS_PROTECTION_SCHEME_PROFILE_A) {
-                        curve25519_donna(z,
-                            ogs_sbi_self()->hnet[home_network_pki_value].key,
-                            pubkey.data);
-                    } else if (protection_scheme_id ==
-                            OGS_PROTECTION_SCHEME_PROFILE_B) {
-                        if (ecdh_shared_secret(
-                                pubkey.data,
-                                ogs_sbi_self()->
-                                    hnet[home_network_pki_value].key,
-                                z) != 1) {
-                            ogs_error("ecdh_shared_secret() failed");
-                            ogs_log_hexdump(OGS_LOG_ERROR,
-                                    pubkey.data, OGS_ECCKEY_LEN);
-                            ogs_log_hexdump(OGS_LOG_ERROR,
-                                ogs_sbi_self()->
-                                    hnet[home_network_pki_value].key,
-                                    OGS_ECCKEY_LEN);
-                            goto cleanup;
-                        }
-                    } else
-                        ogs_assert_if_reached();
-
-                    ogs_kdf_ansi_x963(
-                        z, OGS_ECCKEY_LEN, pubkey.data, pubkey.size,
-                        ek, icb, mk);
-
-                    ogs_hmac_sha256(
-                            mk, OGS_SHA256_DIGEST_SIZE,
-                            cipher_text.data, cipher_text.size,
-                            mactag2, OGS_MACTAG_LEN);
-
-                    if (memcmp(mactag1, mactag2, OGS_MACTAG_LEN) != 0) {
-                        ogs_error("MAC-tag not matched");
-                        ogs_log_hexdump(OGS_LOG_ERROR, mactag1, OGS_MACTAG_LEN);
-                        ogs_log_hexdump(OGS_LOG_ERROR, mactag2, OGS_MACTAG_LEN);
+                    if (ogs_sbi_suci_deconceal(
+                            home_network_pki_value, protection_scheme_id,
+                            &pubkey, &cipher_text, mactag,
+                            plain_text) != OGS_OK) {
+                        ogs_error("ogs_sbi_suci_deconceal[%s] failed", suci);
                         goto cleanup;
                     }
 
-                    plain_text.size = cipher_text.size;
-                    plain_text.data = ogs_calloc(1, plain_text.size);
-                    ogs_assert(plain_text.data);
-
-                    ogs_aes_ctr128_encrypt(
-                            ek, icb, cipher_text.data, cipher_text.size,
-                            plain_text.data);
-
-                    plain_bcd = ogs_calloc(1, plain_text.size*2+1);
-                    ogs_assert(plain_bcd);
-
-                    ogs_buffer_to_bcd(
-                        plain_text.data, plain_text.size, plain_bcd);
+                    ogs_buffer_to_bcd(plain_text, cipher_text.size, plain_bcd);
 
                     supi = ogs_msprintf("imsi-%s%s%s",
                             array[2], array[3], plain_bcd);
                     ogs_assert(supi);
 
-                    if (plain_text.data)
-                        ogs_free(plain_text.data);
-                    ogs_free(plain_bcd);
 cleanup:
                     if (pubkey.data)
                         ogs_free(pubkey.data);
@@ -693,6 +693,10 @@ ogs_sbi_request_t *ogs_sbi_build_request(ogs_sbi_message_t *message)
         ogs_sbi_header_set(request->http.params,
                 OGS_SBI_PARAM_IPV6PREFIX, message->param.ipv6prefix);
     }
+    if (message->param.supi) {
+        ogs_sbi_header_set(request->http.params,
+                OGS_SBI_PARAM_SUPI, message->param.supi);
+    }
 
     if (build_content(&request->http, message) == false) {
         ogs_error("build_content() failed");
@@ -1017,6 +1021,8 @@ int ogs_sbi_parse_request(
             message->param.ipv4addr = ogs_hash_this_val(hi);
         } else if (!strcmp(ogs_hash_this_key(hi), OGS_SBI_PARAM_IPV6PREFIX)) {
             message->param.ipv6prefix = ogs_hash_this_val(hi);
+        } else if (!strcmp(ogs_hash_this_key(hi), OGS_SBI_PARAM_SUPI)) {
+            message->param.supi = ogs_hash_this_val(hi);
         }
     }
 
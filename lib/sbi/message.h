@@ -351,6 +351,7 @@ extern "C" {
 #define OGS_SBI_PARAM_FIELDS                        "fields"
 #define OGS_SBI_PARAM_IPV4ADDR                      "ipv4Addr"
 #define OGS_SBI_PARAM_IPV6PREFIX                    "ipv6Prefix"
+#define OGS_SBI_PARAM_SUPI                          "supi"
 
 #define OGS_SBI_PARAM_FIELDS_GPSIS                       "gpsis"
 #define OGS_SBI_PARAM_FIELDS_SUBSCRIBED_UE_AMBR          "subscribedUeAmbr"
@@ -508,6 +509,7 @@ typedef struct ogs_sbi_message_s {
 
         char *ipv4addr;
         char *ipv6prefix;
+        char *supi;
     } param;
 
     int res_status;
@@ -599,6 +601,12 @@ typedef struct ogs_sbi_request_s {
     ogs_sbi_header_t h;
     ogs_sbi_http_message_t http;
 
+    /*
+     * The client takes over http.content instead of copying it,
+     * and clears it in the request. Used by the SCP to forward a body.
+     */
+    bool move_content;
+
     /* Used in microhttpd */
     bool suspended;
     struct {
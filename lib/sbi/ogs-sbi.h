@@ -101,6 +101,8 @@
 #include "sbi/conv.h"
 #include "sbi/timer.h"
 #include "sbi/message.h"
+#include "sbi/cache.h"
+#include "sbi/suci.h"
 
 #include "sbi/server.h"
 #include "sbi/client.h"
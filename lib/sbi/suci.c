@@ -0,0 +1,459 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-sbi.h"
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/hmac.h>
+#endif
+
+static struct {
+    int num_of_worker;
+    ogs_thread_t *worker[OGS_SBI_SUCI_MAX_NUM_OF_WORKER];
+
+    ogs_thread_mutex_t mutex;
+    ogs_thread_cond_t cond;         /* A batch is posted or stopped */
+    ogs_thread_cond_t done_cond;    /* Every SUCI of the batch is done */
+
+    bool stop;
+
+    char **suci;
+    char **supi;
+    int num;
+    int next;
+    int done;
+} batch;
+
+static void worker_main(void *data)
+{
+    int i;
+
+    ogs_thread_mutex_lock(&batch.mutex);
+    for ( ;; ) {
+        while (!batch.stop && batch.next == batch.num)
+            ogs_thread_cond_wait(&batch.cond, &batch.mutex);
+
+        if (batch.stop)
+            break;
+
+        i = batch.next++;
+        ogs_thread_mutex_unlock(&batch.mutex);
+
+        batch.supi[i] = ogs_supi_from_suci(batch.suci[i]);
+
+        ogs_thread_mutex_lock(&batch.mutex);
+        if (++batch.done == batch.num)
+            ogs_thread_cond_signal(&batch.done_cond);
+    }
+    ogs_thread_mutex_unlock(&batch.mutex);
+}
+
+int ogs_sbi_suci_init(int num_of_worker)
+{
+    int i;
+
+    ogs_assert(batch.num_of_worker == 0);
+
+    if (num_of_worker <= 0)
+        return OGS_OK;
+
+    if (num_of_worker > OGS_SBI_SUCI_MAX_NUM_OF_WORKER) {
+        ogs_error("Too many SUCI workers [%d > %d]",
+                num_of_worker, OGS_SBI_SUCI_MAX_NUM_OF_WORKER);
+        return OGS_ERROR;
+    }
+
+    memset(&batch, 0, sizeof(batch));
+
+    ogs_thread_mutex_init(&batch.mutex);
+    ogs_thread_cond_init(&batch.cond);
+    ogs_thread_cond_init(&batch.done_cond);
+
+    for (i = 0; i < num_of_worker; i++) {
+        batch.worker[i] = ogs_thread_create(worker_main, NULL);
+        if (!batch.worker[i]) {
+            ogs_error("ogs_thread_create() failed");
+            ogs_sbi_suci_final();
+            return OGS_ERROR;
+        }
+        batch.num_of_worker++;
+    }
+
+    return OGS_OK;
+}
+
+void ogs_sbi_suci_final(void)
+{
+    int i;
+
+    if (batch.num_of_worker == 0)
+        return;
+
+    ogs_thread_mutex_lock(&batch.mutex);
+    batch.stop = true;
+    ogs_thread_cond_broadcast(&batch.cond);
+    ogs_thread_mutex_unlock(&batch.mutex);
+
+    for (i = 0; i < batch.num_of_worker; i++)
+        ogs_thread_destroy(batch.worker[i]);
+    batch.num_of_worker = 0;
+
+    ogs_thread_cond_destroy(&batch.done_cond);
+    ogs_thread_cond_destroy(&batch.cond);
+    ogs_thread_mutex_destroy(&batch.mutex);
+}
+
+void ogs_supi_from_suci_batch(char **suci, char **supi, int num)
+{
+    int i;
+
+    ogs_assert(suci);
+    ogs_assert(supi);
+
+    if (batch.num_of_worker == 0 || num <= 1) {
+        for (i = 0; i < num; i++)
+            supi[i] = ogs_supi_from_suci(suci[i]);
+        return;
+    }
+
+    ogs_thread_mutex_lock(&batch.mutex);
+
+    ogs_assert(batch.num == 0);
+    batch.suci = suci;
+    batch.supi = supi;
+    batch.next = 0;
+    batch.done = 0;
+    batch.num = num;
+    ogs_thread_cond_broadcast(&batch.cond);
+
+    /* The caller takes its share of the batch as well */
+    while (batch.next < batch.num) {
+        i = batch.next++;
+        ogs_thread_mutex_unlock(&batch.mutex);
+
+        supi[i] = ogs_supi_from_suci(suci[i]);
+
+        ogs_thread_mutex_lock(&batch.mutex);
+        batch.done++;
+    }
+
+    while (batch.done < batch.num)
+        ogs_thread_cond_wait(&batch.done_cond, &batch.mutex);
+
+    batch.suci = NULL;
+    batch.supi = NULL;
+    batch.num = batch.next = batch.done = 0;
+
+    ogs_thread_mutex_unlock(&batch.mutex);
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+static EVP_PKEY *secp256r1_key_new(
+        int selection, const char *name, uint8_t *key, size_t len)
+{
+    EVP_PKEY_CTX *ctx = NULL;
+    EVP_PKEY *pkey = NULL;
+    OSSL_PARAM params[3];
+    uint8_t priv[OGS_ECCKEY_LEN];
+
+    ctx = EVP_PKEY_CTX_new_from_name(NULL, "EC", NULL);
+    if (!ctx) {
+        ogs_error("EVP_PKEY_CTX_new_from_name() failed");
+        return NULL;
+    }
+
+    params[0] = OSSL_PARAM_construct_utf8_string(
+            OSSL_PKEY_PARAM_GROUP_NAME, (char *)"prime256v1", 0);
+    if (selection == EVP_PKEY_KEYPAIR) {
+        /* OSSL_PARAM carries integers in native byte order */
+        ogs_assert(len == OGS_ECCKEY_LEN);
+#if OGS_BYTE_ORDER == OGS_BIG_ENDIAN
+        memcpy(priv, key, OGS_ECCKEY_LEN);
+#else
+        {
+            int i;
+            for (i = 0; i < OGS_ECCKEY_LEN; i++)
+                priv[i] = key[OGS_ECCKEY_LEN-1-i];
+        }
+#endif
+        params[1] = OSSL_PARAM_construct_BN(
+                OSSL_PKEY_PARAM_PRIV_KEY, priv, sizeof(priv));
+    } else {
+        params[1] = OSSL_PARAM_construct_octet_string(
+                OSSL_PKEY_PARAM_PUB_KEY, key, len);
+    }
+    params[2] = OSSL_PARAM_construct_end();
+
+    if (EVP_PKEY_fromdata_init(ctx) <= 0 ||
+        EVP_PKEY_fromdata(ctx, &pkey, selection, params) <= 0) {
+        ogs_error("EVP_PKEY_fromdata(%s) failed", name);
+        pkey = NULL;
+    }
+
+    OPENSSL_cleanse(priv, sizeof(priv));
+    EVP_PKEY_CTX_free(ctx);
+
+    return pkey;
+}
+
+static int ecdh_derive(EVP_PKEY *priv, EVP_PKEY *peer, uint8_t *z)
+{
+    EVP_PKEY_CTX *ctx = NULL;
+    size_t len = OGS_ECCKEY_LEN;
+    int rv = OGS_ERROR;
+
+    ctx = EVP_PKEY_CTX_new(priv, NULL);
+    if (!ctx) {
+        ogs_error("EVP_PKEY_CTX_new() failed");
+        return OGS_ERROR;
+    }
+
+    /*
+     * The peer has already been checked to be on the curve when it was
+     * decoded, and both curves leave nothing more to validate
+     * (secp256r1 has cofactor 1, X25519 takes any u-coordinate).
+     * Skip the public key check which costs as much as the ECDH itself.
+     */
+    if (EVP_PKEY_derive_init(ctx) <= 0 ||
+        EVP_PKEY_derive_set_peer_ex(ctx, peer, 0) <= 0 ||
+        EVP_PKEY_derive(ctx, z, &len) <= 0 ||
+        len != OGS_ECCKEY_LEN) {
+        ogs_error("EVP_PKEY_derive() failed");
+        goto cleanup;
+    }
+
+    rv = OGS_OK;
+
+cleanup:
+    EVP_PKEY_CTX_free(ctx);
+    return rv;
+}
+
+static int deconceal(uint8_t id, uint8_t scheme,
+        ogs_datum_t *pubkey, ogs_datum_t *cipher_text, uint8_t *mactag,
+        uint8_t *plain_text)
+{
+    EVP_PKEY *peer = NULL;
+    EVP_CIPHER_CTX *cipher = NULL;
+    uint8_t z[OGS_ECCKEY_LEN];
+    uint8_t input[OGS_ECCKEY_LEN+4+OGS_ECCKEY_LEN+1];
+    uint8_t output[OGS_KEY_LEN+OGS_IVEC_LEN];
+    uint8_t mk[OGS_SHA256_DIGEST_SIZE];
+    uint8_t mac[OGS_SHA256_DIGEST_SIZE];
+    unsigned int mac_len = sizeof(mac);
+    uint32_t counter;
+    size_t input_len;
+    int len, rv = OGS_ERROR;
+
+    ogs_assert(ogs_sbi_self()->hnet[id].pkey);
+
+    if (scheme == OGS_PROTECTION_SCHEME_PROFILE_A)
+        peer = EVP_PKEY_new_raw_public_key(
+                EVP_PKEY_X25519, NULL, pubkey->data, pubkey->size);
+    else
+        peer = secp256r1_key_new(EVP_PKEY_PUBLIC_KEY,
+                "public", pubkey->data, pubkey->size);
+    if (!peer) {
+        ogs_error("Invalid ephemeral public key");
+        ogs_log_hexdump(OGS_LOG_ERROR, pubkey->data, pubkey->size);
+        return OGS_ERROR;
+    }
+
+    if (ecdh_derive(ogs_sbi_self()->hnet[id].pkey, peer, z) != OGS_OK)
+        goto cleanup;
+
+    /* ANSI-X9.63-KDF with SHA-256, see ogs_kdf_ansi_x963() */
+    ogs_assert(pubkey->size <= OGS_ECCKEY_LEN+1);
+    memcpy(input, z, OGS_ECCKEY_LEN);
+    memcpy(input+OGS_ECCKEY_LEN+4, pubkey->data, pubkey->size);
+    input_len = OGS_ECCKEY_LEN+4+pubkey->size;
+
+    counter = htobe32(1);
+    memcpy(input+OGS_ECCKEY_LEN, &counter, 4);
+    if (EVP_Digest(input, input_len, output, NULL, EVP_sha256(), NULL) != 1)
+        goto cleanup;
+    counter = htobe32(2);
+    memcpy(input+OGS_ECCKEY_LEN, &counter, 4);
+    if (EVP_Digest(input, input_len, mk, NULL, EVP_sha256(), NULL) != 1)
+        goto cleanup;
+
+    if (!HMAC(EVP_sha256(), mk, sizeof(mk),
+                cipher_text->data, cipher_text->size, mac, &mac_len)) {
+        ogs_error("HMAC() failed");
+        goto cleanup;
+    }
+    if (CRYPTO_memcmp(mactag, mac, OGS_MACTAG_LEN) != 0) {
+        ogs_error("MAC-tag not matched");
+        ogs_log_hexdump(OGS_LOG_ERROR, mactag, OGS_MACTAG_LEN);
+        ogs_log_hexdump(OGS_LOG_ERROR, mac, OGS_MACTAG_LEN);
+        goto cleanup;
+    }
+
+    cipher = EVP_CIPHER_CTX_new();
+    if (!cipher ||
+        EVP_DecryptInit_ex(cipher, EVP_aes_128_ctr(), NULL,
+            output, output+OGS_KEY_LEN) != 1 ||
+        EVP_DecryptUpdate(cipher, plain_text, &len,
+            cipher_text->data, cipher_text->size) != 1) {
+        ogs_error("AES-128-CTR failed");
+        goto cleanup;
+    }
+
+    rv = OGS_OK;
+
+cleanup:
+    OPENSSL_cleanse(z, sizeof(z));
+    OPENSSL_cleanse(input, sizeof(input));
+    OPENSSL_cleanse(output, sizeof(output));
+    OPENSSL_cleanse(mk, sizeof(mk));
+
+    EVP_CIPHER_CTX_free(cipher);
+    EVP_PKEY_free(peer);
+
+    return rv;
+}
+
+#else /* OPENSSL_VERSION_NUMBER >= 0x30000000L */
+
+static int deconceal(uint8_t id, uint8_t scheme,
+        ogs_datum_t *pubkey, ogs_datum_t *cipher_text, uint8_t *mactag,
+        uint8_t *plain_text)
+{
+    uint8_t mactag2[OGS_MACTAG_LEN];
+
+    uint8_t z[OGS_ECCKEY_LEN];
+
+    uint8_t ek[OGS_KEY_LEN];
+    uint8_t icb[OGS_IVEC_LEN];
+    uint8_t mk[OGS_SHA256_DIGEST_SIZE];
+
+    if (scheme == OGS_PROTECTION_SCHEME_PROFILE_A) {
+        curve25519_donna(z, ogs_sbi_self()->hnet[id].key, pubkey->data);
+    } else {
+        if (ecdh_shared_secret(
+                pubkey->data, ogs_sbi_self()->hnet[id].key, z) != 1) {
+            ogs_error("ecdh_shared_secret() failed");
+            ogs_log_hexdump(OGS_LOG_ERROR, pubkey->data, OGS_ECCKEY_LEN);
+            ogs_log_hexdump(OGS_LOG_ERROR,
+                    ogs_sbi_self()->hnet[id].key, OGS_ECCKEY_LEN);
+            return OGS_ERROR;
+        }
+    }
+
+    ogs_kdf_ansi_x963(
+        z, OGS_ECCKEY_LEN, pubkey->data, pubkey->size, ek, icb, mk);
+
+    ogs_hmac_sha256(
+            mk, OGS_SHA256_DIGEST_SIZE,
+            cipher_text->data, cipher_text->size,
+            mactag2, OGS_MACTAG_LEN);
+
+    if (memcmp(mactag, mactag2, OGS_MACTAG_LEN) != 0) {
+        ogs_error("MAC-tag not matched");
+        ogs_log_hexdump(OGS_LOG_ERROR, mactag, OGS_MACTAG_LEN);
+        ogs_log_hexdump(OGS_LOG_ERROR, mactag2, OGS_MACTAG_LEN);
+        return OGS_ERROR;
+    }
+
+    ogs_aes_ctr128_encrypt(
+            ek, icb, cipher_text->data, cipher_text->size, plain_text);
+
+    return OGS_OK;
+}
+
+#endif /* OPENSSL_VERSION_NUMBER >= 0x30000000L */
+
+int ogs_sbi_suci_set_hnet_key(uint8_t id, uint8_t scheme, uint8_t *key)
+{
+    ogs_assert(id >= OGS_HOME_NETWORK_PKI_VALUE_MIN &&
+                id <= OGS_HOME_NETWORK_PKI_VALUE_MAX);
+    ogs_assert(scheme == OGS_PROTECTION_SCHEME_PROFILE_A ||
+                scheme == OGS_PROTECTION_SCHEME_PROFILE_B);
+    ogs_assert(key);
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    {
+        EVP_PKEY *pkey = NULL;
+
+        if (scheme == OGS_PROTECTION_SCHEME_PROFILE_A)
+            pkey = EVP_PKEY_new_raw_private_key(
+                    EVP_PKEY_X25519, NULL, key, OGS_ECCKEY_LEN);
+        else
+            pkey = secp256r1_key_new(EVP_PKEY_KEYPAIR,
+                    "private", key, OGS_ECCKEY_LEN);
+        if (!pkey) {
+            ogs_error("Cannot import HNET PKI Value [%d]", id);
+            return OGS_ERROR;
+        }
+
+        if (ogs_sbi_self()->hnet[id].pkey)
+            EVP_PKEY_free(ogs_sbi_self()->hnet[id].pkey);
+        ogs_sbi_self()->hnet[id].pkey = pkey;
+    }
+#endif
+
+    memcpy(ogs_sbi_self()->hnet[id].key, key, OGS_ECCKEY_LEN);
+    ogs_sbi_self()->hnet[id].scheme = scheme;
+    ogs_sbi_self()->hnet[id].avail = true;
+
+    return OGS_OK;
+}
+
+void ogs_sbi_suci_clear_hnet_key(void)
+{
+    int i;
+
+    for (i = OGS_HOME_NETWORK_PKI_VALUE_MIN;
+            i <= OGS_HOME_NETWORK_PKI_VALUE_MAX; i++) {
+        if (ogs_sbi_self()->hnet[i].pkey)
+            EVP_PKEY_free(ogs_sbi_self()->hnet[i].pkey);
+        memset(&ogs_sbi_self()->hnet[i], 0, sizeof(ogs_sbi_self()->hnet[i]));
+    }
+}
+
+int ogs_sbi_suci_deconceal(uint8_t id, uint8_t scheme,
+        ogs_datum_t *pubkey, ogs_datum_t *cipher_text, uint8_t *mactag,
+        uint8_t *plain_text)
+{
+    ogs_assert(pubkey);
+    ogs_assert(cipher_text);
+    ogs_assert(mactag);
+    ogs_assert(plain_text);
+
+    if (id < OGS_HOME_NETWORK_PKI_VALUE_MIN ||
+        id > OGS_HOME_NETWORK_PKI_VALUE_MAX) {
+        ogs_error("Invalid HNET PKI Value [%d]", id);
+        return OGS_ERROR;
+    }
+
+    if (!ogs_sbi_self()->hnet[id].avail) {
+        ogs_error("HNET PKI Value Not Avaiable [%d]", id);
+        return OGS_ERROR;
+    }
+
+    if (ogs_sbi_self()->hnet[id].scheme != scheme) {
+        ogs_error("Scheme Not Matched [%d != %d]",
+                ogs_sbi_self()->hnet[id].scheme, scheme);
+        return OGS_ERROR;
+    }
+
+    return deconceal(id, scheme, pubkey, cipher_text, mactag, plain_text);
+}
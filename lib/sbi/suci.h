@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#if !defined(OGS_SBI_INSIDE) && !defined(OGS_SBI_COMPILATION)
+#error "This header cannot be included directly."
+#endif
+
+#ifndef OGS_SBI_SUCI_H
+#define OGS_SBI_SUCI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * SUCI de-concealment (TS33.501 Annex C.3)
+ *
+ * With OpenSSL 3.0 or later, the ECDH of Profile A (X25519) and
+ * Profile B (secp256r1), the ANSI-X9.63 KDF, AES-128-CTR and
+ * HMAC-SHA-256 run on libcrypto, and the Home Network private key is
+ * imported once when it is configured. Older OpenSSL falls back on the
+ * implementations in lib/crypt.
+ *
+ * ogs_supi_from_suci_batch() de-conceals several SUCIs at once. With
+ * workers started by ogs_sbi_suci_init(), they share the batch with
+ * the calling thread.
+ */
+#define OGS_SBI_SUCI_MAX_NUM_OF_WORKER 64
+
+int ogs_sbi_suci_init(int num_of_worker);
+void ogs_sbi_suci_final(void);
+
+int ogs_sbi_suci_set_hnet_key(uint8_t id, uint8_t scheme, uint8_t *key);
+void ogs_sbi_suci_clear_hnet_key(void);
+
+int ogs_sbi_suci_deconceal(uint8_t id, uint8_t scheme,
+        ogs_datum_t *pubkey, ogs_datum_t *cipher_text, uint8_t *mactag,
+        uint8_t *plain_text);
+
+void ogs_supi_from_suci_batch(char **suci, char **supi, int num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGS_SBI_SUCI_H */
@@ -94,21 +94,38 @@ static void sctp_write_callback(short when, ogs_socket_t fd, void *data)
 {
     ogs_sctp_sock_t *sctp = data;
     ogs_pkbuf_t *pkbuf = NULL;
+    int sent;
 
     ogs_assert(sctp);
-    if (ogs_list_empty(&sctp->write_queue) == true) {
-        ogs_assert(sctp->poll.write);
-        ogs_pollset_remove(sctp->poll.write);
-        sctp->poll.write = NULL;
-        return;
-    }
+    ogs_assert(sctp->sock);
 
-    pkbuf = ogs_list_first(&sctp->write_queue);
-    ogs_assert(pkbuf);
-    ogs_list_remove(&sctp->write_queue, pkbuf);
+    /*
+     * Flush everything queued since the last wakeup. Messages that were
+     * written during one event loop iteration go out together instead of
+     * one per POLLOUT event.
+     */
+    while ((pkbuf = ogs_list_first(&sctp->write_queue))) {
+        sent = ogs_sctp_sendmsg(sctp->sock, pkbuf->data, pkbuf->len, NULL,
+                ogs_sctp_ppid_in_pkbuf(pkbuf),
+                ogs_sctp_stream_no_in_pkbuf(pkbuf));
+        if (sent < 0 && ogs_socket_errno == OGS_EAGAIN) {
+            /* Send buffer is full. Retry on next POLLOUT */
+            return;
+        }
 
-    ogs_assert(sctp->sock);
-    ogs_sctp_senddata(sctp->sock, pkbuf, NULL);
+        ogs_list_remove(&sctp->write_queue, pkbuf);
+
+        if (sent < 0 || sent != pkbuf->len)
+            ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
+                    "ogs_sctp_sendmsg(len:%d,ssn:%d)",
+                    pkbuf->len, (int)ogs_sctp_stream_no_in_pkbuf(pkbuf));
+
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    ogs_assert(sctp->poll.write);
+    ogs_pollset_remove(sctp->poll.write);
+    sctp->poll.write = NULL;
 }
 
 void ogs_sctp_flush_and_destroy(ogs_sctp_sock_t *sctp)
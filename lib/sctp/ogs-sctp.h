@@ -48,6 +48,9 @@ extern int __ogs_sctp_domain;
 #define OGS_SCTP_SGSAP_PPID             0
 #define OGS_SCTP_NGAP_PPID              60
 
+/* Maximum number of messages read from an association per wakeup */
+#define OGS_SCTP_MAX_RECV_BURST         32
+
 #define ogs_sctp_ppid_in_pkbuf(__pkBUF)         (__pkBUF)->param[0]
 #define ogs_sctp_stream_no_in_pkbuf(__pkBUF)    (__pkBUF)->param[1]
 
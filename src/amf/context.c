@@ -40,6 +40,7 @@ static void stats_add_ran_ue(void);
 static void stats_remove_ran_ue(void);
 static void stats_add_amf_session(void);
 static void stats_remove_amf_session(void);
+static void gnb_paging_ta_clear(amf_gnb_t *gnb);
 static bool amf_namf_comm_parse_guti(ogs_nas_5gs_guti_t *guti, char *ue_context_id);
 
 void amf_context_init(void)
@@ -83,6 +84,8 @@ void amf_context_init(void)
     ogs_assert(self.suci_hash);
     self.supi_hash = ogs_hash_make();
     ogs_assert(self.supi_hash);
+    self.paging_ta_hash = ogs_hash_make();
+    ogs_assert(self.paging_ta_hash);
 
     context_initialized = 1;
 }
@@ -105,6 +108,8 @@ void amf_context_final(void)
     ogs_hash_destroy(self.suci_hash);
     ogs_assert(self.supi_hash);
     ogs_hash_destroy(self.supi_hash);
+    ogs_assert(self.paging_ta_hash);
+    ogs_hash_destroy(self.paging_ta_hash);
 
     ogs_pool_final(&m_tmsi_pool);
     ogs_pool_final(&amf_sess_pool);
@@ -1263,6 +1268,9 @@ amf_gnb_t *amf_gnb_add(ogs_sock_t *sock, ogs_sockaddr_t *addr)
     gnb->ostream_id = 0;
 
     ogs_list_init(&gnb->ran_ue_list);
+    gnb->ran_ue_ngap_id_hash = ogs_hash_make();
+    ogs_assert(gnb->ran_ue_ngap_id_hash);
+    ogs_list_init(&gnb->paging_list);
 
     ogs_hash_set(self.gnb_addr_hash,
             gnb->sctp.addr, sizeof(ogs_sockaddr_t), gnb);
@@ -1298,6 +1306,11 @@ void amf_gnb_remove(amf_gnb_t *gnb)
     if (gnb->gnb_id_presence == true)
         ogs_hash_set(self.gnb_id_hash, &gnb->gnb_id, sizeof(gnb->gnb_id), NULL);
 
+    gnb_paging_ta_clear(gnb);
+
+    ogs_assert(gnb->ran_ue_ngap_id_hash);
+    ogs_hash_destroy(gnb->ran_ue_ngap_id_hash);
+
     ogs_sctp_flush_and_destroy(&gnb->sctp);
 
     ogs_pool_id_free(&amf_gnb_pool, gnb);
@@ -1363,6 +1376,162 @@ amf_gnb_t *amf_gnb_find_by_id(ogs_pool_id_t id)
     return ogs_pool_find_by_id(&amf_gnb_pool, id);
 }
 
+static void gnb_paging_ta_clear(amf_gnb_t *gnb)
+{
+    amf_paging_gnb_t *node = NULL, *next_node = NULL;
+    amf_paging_ta_t *ta = NULL;
+
+    ogs_assert(gnb);
+
+    ogs_list_for_each_entry_safe(&gnb->paging_list, next_node, node, gnb_lnode) {
+        ta = node->ta;
+        ogs_assert(ta);
+
+        ogs_list_remove(&ta->gnb_list, node);
+        ogs_list_remove(&gnb->paging_list, &node->gnb_lnode);
+        ogs_free(node);
+
+        if (ogs_list_empty(&ta->gnb_list)) {
+            ogs_hash_set(self.paging_ta_hash, &ta->tai, sizeof(ta->tai), NULL);
+            ogs_free(ta);
+        }
+    }
+}
+
+void amf_gnb_update_paging_ta(amf_gnb_t *gnb)
+{
+    int i, j;
+    ogs_5gs_tai_t tai;
+    amf_paging_ta_t *ta = NULL;
+    amf_paging_gnb_t *node = NULL;
+
+    ogs_assert(gnb);
+
+    gnb_paging_ta_clear(gnb);
+
+    for (i = 0; i < gnb->num_of_supported_ta_list; i++) {
+        for (j = 0; j < gnb->supported_ta_list[i].num_of_bplmn_list; j++) {
+            memset(&tai, 0, sizeof(tai));
+            memcpy(&tai.plmn_id,
+                    &gnb->supported_ta_list[i].bplmn_list[j].plmn_id,
+                    OGS_PLMN_ID_LEN);
+            tai.tac.v = gnb->supported_ta_list[i].tac.v;
+
+            ta = ogs_hash_get(self.paging_ta_hash, &tai, sizeof(tai));
+            if (!ta) {
+                ta = ogs_calloc(1, sizeof(*ta));
+                ogs_assert(ta);
+                memcpy(&ta->tai, &tai, sizeof(tai));
+                ogs_list_init(&ta->gnb_list);
+                ogs_hash_set(self.paging_ta_hash, &ta->tai, sizeof(ta->tai), ta);
+            } else {
+                /*
+                 * Nodes of this gNB are appended while no other gNB is
+                 * updated, so a duplicated TAI in the Supported TA List
+                 * can only be found at the tail.
+                 */
+                node = ogs_list_last(&ta->gnb_list);
+                if (node && node->gnb_id == gnb->id)
+                    continue;
+            }
+
+            node = ogs_calloc(1, sizeof(*node));
+            ogs_assert(node);
+            node->ta = ta;
+            node->gnb_id = gnb->id;
+
+            ogs_list_add(&ta->gnb_list, node);
+            ogs_list_add(&gnb->paging_list, &node->gnb_lnode);
+        }
+    }
+}
+
+amf_paging_ta_t *amf_paging_ta_find(ogs_5gs_tai_t *tai)
+{
+    ogs_5gs_tai_t key;
+
+    ogs_assert(tai);
+
+    memset(&key, 0, sizeof(key));
+    memcpy(&key.plmn_id, &tai->plmn_id, OGS_PLMN_ID_LEN);
+    key.tac.v = tai->tac.v;
+
+    return ogs_hash_get(self.paging_ta_hash, &key, sizeof(key));
+}
+
+/*
+ * RAN-UE-NGAP-ID index of the gNB.
+ *
+ * A valid RAN-UE-NGAP-ID normally belongs to a single NG context of
+ * the gNB. If another context already holds the same ID, the first one
+ * keeps the index as the linear search of ran_ue_list used to, and the
+ * newer one is counted as shadowed. When the indexed context goes away,
+ * the next holder of the ID in ran_ue_list takes over the index.
+ */
+static void ran_ue_ngap_id_index(amf_gnb_t *gnb, ran_ue_t *ran_ue)
+{
+    ran_ue_t *old_ran_ue = NULL;
+
+    ogs_assert(gnb);
+    ogs_assert(ran_ue);
+
+    if (ran_ue->ran_ue_ngap_id == INVALID_UE_NGAP_ID)
+        return;
+
+    old_ran_ue = ogs_hash_get(gnb->ran_ue_ngap_id_hash,
+            &ran_ue->ran_ue_ngap_id, sizeof(ran_ue->ran_ue_ngap_id));
+    if (old_ran_ue) {
+        ogs_assert(old_ran_ue != ran_ue);
+        ogs_warn("Duplicated RAN_UE_NGAP_ID[%lld] "
+                "AMF_UE_NGAP_ID[%lld:%lld]",
+                (long long)ran_ue->ran_ue_ngap_id,
+                (long long)old_ran_ue->amf_ue_ngap_id,
+                (long long)ran_ue->amf_ue_ngap_id);
+        gnb->num_of_shadowed_ran_ue++;
+        return;
+    }
+
+    ogs_hash_set(gnb->ran_ue_ngap_id_hash,
+            &ran_ue->ran_ue_ngap_id, sizeof(ran_ue->ran_ue_ngap_id), ran_ue);
+}
+
+static void ran_ue_ngap_id_unindex(amf_gnb_t *gnb, ran_ue_t *ran_ue)
+{
+    ran_ue_t *next_ran_ue = NULL;
+
+    ogs_assert(gnb);
+    ogs_assert(ran_ue);
+
+    if (ran_ue->ran_ue_ngap_id == INVALID_UE_NGAP_ID)
+        return;
+
+    if (ogs_hash_get(gnb->ran_ue_ngap_id_hash,
+            &ran_ue->ran_ue_ngap_id,
+            sizeof(ran_ue->ran_ue_ngap_id)) != ran_ue) {
+        /* A shadowed context leaves the index of the other one alone */
+        ogs_assert(gnb->num_of_shadowed_ran_ue > 0);
+        gnb->num_of_shadowed_ran_ue--;
+        return;
+    }
+
+    ogs_hash_set(gnb->ran_ue_ngap_id_hash,
+            &ran_ue->ran_ue_ngap_id, sizeof(ran_ue->ran_ue_ngap_id), NULL);
+
+    if (gnb->num_of_shadowed_ran_ue == 0)
+        return;
+
+    ogs_list_for_each(&gnb->ran_ue_list, next_ran_ue) {
+        if (next_ran_ue != ran_ue &&
+            next_ran_ue->ran_ue_ngap_id == ran_ue->ran_ue_ngap_id) {
+            ogs_hash_set(gnb->ran_ue_ngap_id_hash,
+                    &next_ran_ue->ran_ue_ngap_id,
+                    sizeof(next_ran_ue->ran_ue_ngap_id), next_ran_ue);
+            gnb->num_of_shadowed_ran_ue--;
+            break;
+        }
+    }
+}
+
 /** ran_ue_context handling function */
 ran_ue_t *ran_ue_add(amf_gnb_t *gnb, uint64_t ran_ue_ngap_id)
 {
@@ -1404,6 +1573,7 @@ ran_ue_t *ran_ue_add(amf_gnb_t *gnb, uint64_t ran_ue_ngap_id)
     ran_ue->gnb_id = gnb->id;
 
     ogs_list_add(&gnb->ran_ue_list, ran_ue);
+    ran_ue_ngap_id_index(gnb, ran_ue);
 
     stats_add_ran_ue();
 
@@ -1418,7 +1588,10 @@ void ran_ue_remove(ran_ue_t *ran_ue)
 
     gnb = amf_gnb_find_by_id(ran_ue->gnb_id);
 
-    if (gnb) ogs_list_remove(&gnb->ran_ue_list, ran_ue);
+    if (gnb) {
+        ran_ue_ngap_id_unindex(gnb, ran_ue);
+        ogs_list_remove(&gnb->ran_ue_list, ran_ue);
+    }
 
     ogs_assert(ran_ue->t_ng_holding);
     ogs_timer_delete(ran_ue->t_ng_holding);
@@ -1439,26 +1612,37 @@ void ran_ue_switch_to_gnb(ran_ue_t *ran_ue, amf_gnb_t *new_gnb)
     ogs_assert(gnb);
 
     /* Remove from the old gnb */
+    ran_ue_ngap_id_unindex(gnb, ran_ue);
     ogs_list_remove(&gnb->ran_ue_list, ran_ue);
 
     /* Add to the new gnb */
     ogs_list_add(&new_gnb->ran_ue_list, ran_ue);
+    ran_ue_ngap_id_index(new_gnb, ran_ue);
 
     /* Switch to gnb */
     ran_ue->gnb_id = new_gnb->id;
 }
 
-ran_ue_t *ran_ue_find_by_ran_ue_ngap_id(
-        amf_gnb_t *gnb, uint64_t ran_ue_ngap_id)
+void ran_ue_set_ran_ue_ngap_id(ran_ue_t *ran_ue, uint64_t ran_ue_ngap_id)
 {
-    ran_ue_t *ran_ue = NULL;
+    amf_gnb_t *gnb = NULL;
 
-    ogs_list_for_each(&gnb->ran_ue_list, ran_ue) {
-        if (ran_ue_ngap_id == ran_ue->ran_ue_ngap_id)
-            break;
-    }
+    ogs_assert(ran_ue);
 
-    return ran_ue;
+    gnb = amf_gnb_find_by_id(ran_ue->gnb_id);
+    ogs_assert(gnb);
+
+    ran_ue_ngap_id_unindex(gnb, ran_ue);
+    ran_ue->ran_ue_ngap_id = ran_ue_ngap_id;
+    ran_ue_ngap_id_index(gnb, ran_ue);
+}
+
+ran_ue_t *ran_ue_find_by_ran_ue_ngap_id(
+        amf_gnb_t *gnb, uint64_t ran_ue_ngap_id)
+{
+    ogs_assert(gnb);
+    return (ran_ue_t *)ogs_hash_get(gnb->ran_ue_ngap_id_hash,
+            &ran_ue_ngap_id, sizeof(ran_ue_ngap_id));
 }
 
 ran_ue_t *ran_ue_find(uint32_t index)
@@ -1730,6 +1914,9 @@ void amf_ue_remove(amf_ue_t *amf_ue)
     if (amf_ue->pei)
         ogs_free(amf_ue->pei);
 
+    if (amf_ue->nas_security_cache)
+        ogs_free(amf_ue->nas_security_cache);
+
     for (i = 0; i < amf_ue->num_of_msisdn; i++) {
         ogs_assert(amf_ue->msisdn[i]);
         ogs_free(amf_ue->msisdn[i]);
@@ -1781,6 +1968,19 @@ void amf_ue_remove(amf_ue_t *amf_ue)
             ogs_list_count(&self.amf_ue_list));
 }
 
+ogs_nas_security_cache_t *amf_ue_nas_security_cache(amf_ue_t *amf_ue)
+{
+    ogs_assert(amf_ue);
+
+    if (!amf_ue->nas_security_cache) {
+        amf_ue->nas_security_cache =
+            ogs_calloc(1, sizeof(ogs_nas_security_cache_t));
+        ogs_assert(amf_ue->nas_security_cache);
+    }
+
+    return amf_ue->nas_security_cache;
+}
+
 void amf_ue_remove_all(void)
 {
     amf_ue_t *amf_ue = NULL, *next = NULL;;
@@ -118,6 +118,7 @@ typedef struct amf_context_s {
     ogs_hash_t      *guti_ue_hash;  /* hash table (GUTI : AMF_UE) */
     ogs_hash_t      *suci_hash;     /* hash table (SUCI) */
     ogs_hash_t      *supi_hash;     /* hash table (SUPI) */
+    ogs_hash_t      *paging_ta_hash;/* hash table (TAI : AMF_PAGING_TA) */
 
     uint16_t        ngap_port;      /* Default NGAP Port */
 
@@ -167,9 +168,35 @@ typedef struct amf_gnb_s {
     ogs_pkbuf_t     *ng_reset_ack; /* Reset message */
 
     ogs_list_t      ran_ue_list;
+    ogs_hash_t      *ran_ue_ngap_id_hash; /* hash table (RAN_UE_NGAP_ID) */
+    int             num_of_shadowed_ran_ue; /* Duplicated RAN_UE_NGAP_ID */
+
+    ogs_list_t      paging_list;    /* List of amf_paging_gnb_t */
 
 } amf_gnb_t;
 
+/*
+ * TAI to gNB index used by NG-Paging.
+ *
+ * Each TAI broadcast by at least one gNB has an amf_paging_ta_t entry
+ * in amf_self()->paging_ta_hash. The entry links every gNB supporting
+ * that TAI, so Paging does not need to walk all gNBs and their
+ * Supported TA List. The index is rebuilt from gnb->supported_ta_list
+ * on NG Setup and RAN Configuration Update.
+ */
+typedef struct amf_paging_ta_s {
+    ogs_5gs_tai_t   tai;
+    ogs_list_t      gnb_list;       /* List of amf_paging_gnb_t */
+} amf_paging_ta_t;
+
+typedef struct amf_paging_gnb_s {
+    ogs_lnode_t     lnode;          /* Node in amf_paging_ta_t->gnb_list */
+    ogs_lnode_t     gnb_lnode;      /* Node in amf_gnb_t->paging_list */
+
+    amf_paging_ta_t *ta;
+    ogs_pool_id_t   gnb_id;
+} amf_paging_gnb_t;
+
 struct ran_ue_s {
     ogs_lnode_t     lnode;
     uint32_t        index;
@@ -478,6 +505,12 @@ struct amf_ue_s {
     /* Integrity and ciphering keys */
     uint8_t         knas_int[OGS_SHA256_DIGEST_SIZE/2];
     uint8_t         knas_enc[OGS_SHA256_DIGEST_SIZE/2];
+    /*
+     * Key schedules derived from knas_int/knas_enc. Only UEs that reach
+     * secured NAS need them, so amf_ue_nas_security_cache() allocates
+     * them on first use.
+     */
+    ogs_nas_security_cache_t *nas_security_cache;
     /* Downlink counter */
     uint32_t        dl_count;
     /* Uplink counter (24-bit stored in uint32_t) */
@@ -934,9 +967,13 @@ int amf_gnb_set_gnb_id(amf_gnb_t *gnb, uint32_t gnb_id);
 int amf_gnb_sock_type(ogs_sock_t *sock);
 amf_gnb_t *amf_gnb_find_by_id(ogs_pool_id_t id);
 
+void amf_gnb_update_paging_ta(amf_gnb_t *gnb);
+amf_paging_ta_t *amf_paging_ta_find(ogs_5gs_tai_t *tai);
+
 ran_ue_t *ran_ue_add(amf_gnb_t *gnb, uint64_t ran_ue_ngap_id);
 void ran_ue_remove(ran_ue_t *ran_ue);
 void ran_ue_switch_to_gnb(ran_ue_t *ran_ue, amf_gnb_t *new_gnb);
+void ran_ue_set_ran_ue_ngap_id(ran_ue_t *ran_ue, uint64_t ran_ue_ngap_id);
 ran_ue_t *ran_ue_find_by_ran_ue_ngap_id(
         amf_gnb_t *gnb, uint64_t ran_ue_ngap_id);
 ran_ue_t *ran_ue_find(uint32_t index);
@@ -950,6 +987,8 @@ amf_ue_t *amf_ue_add(ran_ue_t *ran_ue);
 void amf_ue_remove(amf_ue_t *amf_ue);
 void amf_ue_remove_all(void);
 
+ogs_nas_security_cache_t *amf_ue_nas_security_cache(amf_ue_t *amf_ue);
+
 void amf_ue_fsm_init(amf_ue_t *amf_ue);
 void amf_ue_fsm_fini(amf_ue_t *amf_ue);
 
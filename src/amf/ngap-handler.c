@@ -342,6 +342,8 @@ void ngap_handle_ng_setup_request(amf_gnb_t *gnb, ogs_ngap_message_t *message)
         gnb->num_of_supported_ta_list++;
     }
 
+    amf_gnb_update_paging_ta(gnb);
+
     if (maximum_number_of_gnbs_is_reached()) {
         ogs_warn("NG-Setup failure:");
         ogs_warn("    Maximum number of gNBs reached");
@@ -2825,12 +2827,12 @@ void ngap_handle_path_switch_request(
     ogs_info("    [OLD] TAC[%d] CellID[0x%llx]",
         amf_ue->nr_tai.tac.v, (long long)amf_ue->nr_cgi.cell_id);
 
-    /* Update RAN-UE-NGAP-ID */
-    ran_ue->ran_ue_ngap_id = *RAN_UE_NGAP_ID;
-
     /* Change ran_ue to the NEW gNB */
     ran_ue_switch_to_gnb(ran_ue, gnb);
 
+    /* Update RAN-UE-NGAP-ID */
+    ran_ue_set_ran_ue_ngap_id(ran_ue, *RAN_UE_NGAP_ID);
+
     if (!UserLocationInformation) {
         ogs_error("No UserLocationInformation");
         r = ngap_send_error_indication2(ran_ue,
@@ -3524,7 +3526,7 @@ void ngap_handle_handover_request_ack(
         return;
     }
 
-    target_ue->ran_ue_ngap_id = *RAN_UE_NGAP_ID;
+    ran_ue_set_ran_ue_ngap_id(target_ue, *RAN_UE_NGAP_ID);
 
     source_ue = ran_ue_find_by_id(target_ue->source_ue_id);
     if (!source_ue) {
@@ -4449,6 +4451,8 @@ void ngap_handle_ran_configuration_update(
             gnb->num_of_supported_ta_list++;
         }
 
+        amf_gnb_update_paging_ta(gnb);
+
         if (gnb->num_of_supported_ta_list == 0) {
             ogs_warn("RANConfigurationUpdate failure:");
             ogs_warn("    No supported TA exist in request");
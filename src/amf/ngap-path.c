@@ -425,7 +425,8 @@ int ngap_send_paging(amf_ue_t *amf_ue)
 {
     ogs_pkbuf_t *ngapbuf = NULL;
     amf_gnb_t *gnb = NULL;
-    int i, j;
+    amf_paging_ta_t *ta = NULL;
+    amf_paging_gnb_t *node = NULL;
     int rv;
 
     ogs_debug("NG-Paging");
@@ -435,38 +436,47 @@ int ngap_send_paging(amf_ue_t *amf_ue)
         return OGS_NOTFOUND;
     }
 
-    ogs_list_for_each(&amf_self()->gnb_list, gnb) {
-        for (i = 0; i < gnb->num_of_supported_ta_list; i++) {
-            for (j = 0; j < gnb->supported_ta_list[i].num_of_bplmn_list; j++) {
-                if (memcmp(&gnb->supported_ta_list[i].bplmn_list[j].plmn_id,
-                            &amf_ue->nr_tai.plmn_id, OGS_PLMN_ID_LEN) == 0 &&
-                    gnb->supported_ta_list[i].tac.v == amf_ue->nr_tai.tac.v) {
-
-                    if (amf_ue->t3513.pkbuf) {
-                        ngapbuf = amf_ue->t3513.pkbuf;
-                    } else {
-                        ngapbuf = ngap_build_paging(amf_ue);
-                        if (!ngapbuf) {
-                            ogs_error("ngap_build_paging() failed");
-                            return OGS_ERROR;
-                        }
-                    }
-
-                    amf_ue->t3513.pkbuf = ogs_pkbuf_copy(ngapbuf);
-                    if (!amf_ue->t3513.pkbuf) {
-                        ogs_error("ogs_pkbuf_copy() failed");
-                        ogs_pkbuf_free(ngapbuf);
-                        return OGS_ERROR;
-                    }
-
-                    amf_metrics_inst_global_inc(AMF_METR_GLOB_CTR_MM_PAGING_5G_REQ);
-
-                    rv = ngap_send_to_gnb(gnb, ngapbuf, NGAP_NON_UE_SIGNALLING);
-                    if (rv != OGS_OK) {
-                        ogs_error("ngap_send_to_gnb() failed");
-                        return rv;
-                    }
-                }
+    ta = amf_paging_ta_find(&amf_ue->nr_tai);
+    if (ta) {
+        /*
+         * The Paging message is encoded only once and kept for T3513.
+         * The encoder output lives in an OGS_MAX_SDU_LEN buffer, so it is
+         * shrunk to the PDU length to keep the per-gNB copy cheap.
+         */
+        if (!amf_ue->t3513.pkbuf) {
+            ngapbuf = ngap_build_paging(amf_ue);
+            if (!ngapbuf) {
+                ogs_error("ngap_build_paging() failed");
+                return OGS_ERROR;
+            }
+
+            amf_ue->t3513.pkbuf = ogs_pkbuf_alloc(NULL, ngapbuf->len);
+            if (!amf_ue->t3513.pkbuf) {
+                ogs_error("ogs_pkbuf_alloc() failed");
+                ogs_pkbuf_free(ngapbuf);
+                return OGS_ERROR;
+            }
+            ogs_pkbuf_put_data(amf_ue->t3513.pkbuf,
+                    ngapbuf->data, ngapbuf->len);
+            ogs_pkbuf_free(ngapbuf);
+        }
+
+        ogs_list_for_each(&ta->gnb_list, node) {
+            gnb = amf_gnb_find_by_id(node->gnb_id);
+            ogs_assert(gnb);
+
+            ngapbuf = ogs_pkbuf_copy(amf_ue->t3513.pkbuf);
+            if (!ngapbuf) {
+                ogs_error("ogs_pkbuf_copy() failed");
+                return OGS_ERROR;
+            }
+
+            amf_metrics_inst_global_inc(AMF_METR_GLOB_CTR_MM_PAGING_5G_REQ);
+
+            rv = ngap_send_to_gnb(gnb, ngapbuf, NGAP_NON_UE_SIGNALLING);
+            if (rv != OGS_OK) {
+                ogs_error("ngap_send_to_gnb() failed");
+                return rv;
             }
         }
     }
@@ -145,10 +145,12 @@ void bsf_state_operational(ogs_fsm_t *s, bsf_event_t *e)
 
                             if (message.PcfBinding->ipv4_addr)
                                 sess = bsf_sess_find_by_ipv4addr(
-                                            message.PcfBinding->ipv4_addr);
+                                            message.PcfBinding->ipv4_addr,
+                                            message.PcfBinding->dnn);
                             if (!sess && message.PcfBinding->ipv6_prefix)
                                 sess = bsf_sess_find_by_ipv6prefix(
-                                            message.PcfBinding->ipv6_prefix);
+                                            message.PcfBinding->ipv6_prefix,
+                                            message.PcfBinding->dnn);
 
                             if (!sess) {
                                 sess = bsf_sess_add_by_ip_address(
@@ -161,10 +163,24 @@ void bsf_state_operational(ogs_fsm_t *s, bsf_event_t *e)
                     CASE(OGS_SBI_HTTP_METHOD_GET)
                         if (message.param.ipv4addr)
                             sess = bsf_sess_find_by_ipv4addr(
-                                        message.param.ipv4addr);
+                                        message.param.ipv4addr,
+                                        message.param.dnn);
                         if (!sess && message.param.ipv6prefix)
                             sess = bsf_sess_find_by_ipv6prefix(
-                                        message.param.ipv6prefix);
+                                        message.param.ipv6prefix,
+                                        message.param.dnn);
+                        if (!sess && !message.param.ipv4addr &&
+                            !message.param.ipv6prefix) {
+                            if (message.param.supi)
+                                sess = bsf_sess_find_by_supi_and_dnn(
+                                            message.param.supi,
+                                            message.param.dnn);
+                            else if (message.param.snssai_presence &&
+                                    message.param.dnn)
+                                sess = bsf_sess_find_by_snssai_and_dnn(
+                                            &message.param.s_nssai,
+                                            message.param.dnn);
+                        }
                         break;
                     DEFAULT
                         ogs_error("Invalid HTTP method [%s]", message.h.method);
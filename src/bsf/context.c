@@ -17,6 +17,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <ctype.h>
+
 #include "context.h"
 
 static bsf_context_t self;
@@ -27,8 +29,35 @@ static OGS_POOL(bsf_sess_pool, bsf_sess_t);
 
 static int context_initialized = 0;
 
+/*
+ * The `times 33' hash of ogs_hash_make() spreads text well, but folds
+ * the few varying bytes of the UE addresses of one pool onto a small
+ * range of buckets. FNV-1a with a final mix spreads binary keys.
+ */
+static unsigned int index_hashfunc(const char *char_key, int *klen)
+{
+    const unsigned char *key = (const unsigned char *)char_key;
+    unsigned int hash = 2166136261U;
+    int i;
+
+    ogs_assert(*klen >= 0);
+
+    for (i = 0; i < *klen; i++) {
+        hash ^= key[i];
+        hash *= 16777619U;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+
+    return hash;
+}
+
 void bsf_context_init(void)
 {
+    int i;
+
     ogs_assert(context_initialized == 0);
 
     /* Initialize BSF context */
@@ -38,24 +67,39 @@ void bsf_context_init(void)
 
     ogs_pool_init(&bsf_sess_pool, ogs_app()->pool.sess);
 
-    self.ipv4addr_hash = ogs_hash_make();
-    ogs_assert(self.ipv4addr_hash);
-    self.ipv6prefix_hash = ogs_hash_make();
-    ogs_assert(self.ipv6prefix_hash);
+    for (i = 0; i < BSF_MAX_NUM_OF_INDEX; i++) {
+        if (i == BSF_INDEX_SUPI)
+            self.index_hash[i] = ogs_hash_make();
+        else
+            self.index_hash[i] = ogs_hash_make_custom(index_hashfunc);
+        ogs_assert(self.index_hash[i]);
+    }
+    self.dnn_hash = ogs_hash_make();
+    ogs_assert(self.dnn_hash);
 
     context_initialized = 1;
 }
 
 void bsf_context_final(void)
 {
+    ogs_hash_index_t *hi = NULL;
+    int i;
+
     ogs_assert(context_initialized == 1);
 
     bsf_sess_remove_all();
 
-    ogs_assert(self.ipv4addr_hash);
-    ogs_hash_destroy(self.ipv4addr_hash);
-    ogs_assert(self.ipv6prefix_hash);
-    ogs_hash_destroy(self.ipv6prefix_hash);
+    for (i = 0; i < BSF_MAX_NUM_OF_INDEX; i++) {
+        ogs_assert(self.index_hash[i]);
+        ogs_hash_destroy(self.index_hash[i]);
+    }
+
+    ogs_assert(self.dnn_hash);
+    for (hi = ogs_hash_first(self.dnn_hash); hi; hi = ogs_hash_next(hi)) {
+        ogs_free((void *)ogs_hash_this_key(hi));
+        ogs_free(ogs_hash_this_val(hi));
+    }
+    ogs_hash_destroy(self.dnn_hash);
 
     ogs_pool_final(&bsf_sess_pool);
 
@@ -125,6 +169,147 @@ int bsf_context_parse_config(void)
     return OGS_OK;
 }
 
+/*
+ * A DNN is case-insensitive, so every binding with the same DNN shares
+ * one copy, found by its lower-cased name. The S-NSSAI/DNN index and
+ * the DNN filters of the other lookups then compare pointers.
+ */
+static char *dnn_find(const char *dnn, bool add)
+{
+    char key[OGS_MAX_DNN_LEN+1];
+    char *name = NULL;
+    int i;
+
+    ogs_assert(dnn);
+
+    for (i = 0; dnn[i]; i++) {
+        if (i == OGS_MAX_DNN_LEN) {
+            ogs_error("Invalid DNN [%s]", dnn);
+            return NULL;
+        }
+        key[i] = tolower((unsigned char)dnn[i]);
+    }
+    key[i] = 0;
+
+    name = ogs_hash_get(self.dnn_hash, key, i);
+    if (!name && add) {
+        name = ogs_strdup(dnn);
+        ogs_assert(name);
+        ogs_hash_set(self.dnn_hash, ogs_strdup(key), i, name);
+    }
+
+    return name;
+}
+
+#define IPV6INDEX_KEY_LEN(__lEN) (1 + (((__lEN) + 7) >> 3))
+
+static void ipv6index_mask(uint8_t *dst, const uint8_t *addr6, int len)
+{
+    memset(dst, 0, OGS_IPV6_LEN);
+    memcpy(dst, addr6, len >> 3);
+    if (len & 7)
+        dst[len >> 3] = addr6[len >> 3] & (0xff << (8 - (len & 7)));
+}
+
+static const void *index_key(bsf_sess_t *sess, bsf_index_e index, int *klen)
+{
+    ogs_assert(sess);
+    ogs_assert(klen);
+
+    switch (index) {
+    case BSF_INDEX_IPV4ADDR:
+        *klen = sizeof(sess->ipv4addr);
+        return &sess->ipv4addr;
+    case BSF_INDEX_IPV6PREFIX:
+        *klen = IPV6INDEX_KEY_LEN(sess->ipv6index.len);
+        return &sess->ipv6index;
+    case BSF_INDEX_SNSSAI_DNN:
+        *klen = sizeof(sess->snssai_dnn);
+        return &sess->snssai_dnn;
+    case BSF_INDEX_SUPI:
+        ogs_assert(sess->supi);
+        *klen = strlen(sess->supi);
+        return sess->supi;
+    default:
+        ogs_fatal("Invalid index[%d]", index);
+        ogs_assert_if_reached();
+    }
+
+    return NULL;
+}
+
+static void index_add(bsf_sess_t *sess, bsf_index_e index)
+{
+    ogs_hash_t *hash = self.index_hash[index];
+    bsf_sess_t *head = NULL;
+    const void *key = NULL;
+    int klen;
+
+    key = index_key(sess, index, &klen);
+
+    /*
+     * The hash keeps the key memory of the binding it was set with,
+     * so the new binding becomes the head of the chain.
+     */
+    head = ogs_hash_get(hash, key, klen);
+    if (head) {
+        head->index[index].prev = sess;
+        ogs_hash_set(hash, key, klen, NULL);
+    }
+    sess->index[index].prev = NULL;
+    sess->index[index].next = head;
+    ogs_hash_set(hash, key, klen, sess);
+
+    if (index == BSF_INDEX_IPV6PREFIX)
+        self.ipv6prefix_count[sess->ipv6index.len]++;
+}
+
+static void index_remove(bsf_sess_t *sess, bsf_index_e index)
+{
+    ogs_hash_t *hash = self.index_hash[index];
+    bsf_sess_t *prev = NULL, *next = NULL;
+    const void *key = NULL;
+    int klen;
+
+    prev = sess->index[index].prev;
+    next = sess->index[index].next;
+
+    if (prev) {
+        prev->index[index].next = next;
+    } else {
+        key = index_key(sess, index, &klen);
+        ogs_hash_set(hash, key, klen, NULL);
+        if (next) {
+            key = index_key(next, index, &klen);
+            ogs_hash_set(hash, key, klen, next);
+        }
+    }
+    if (next)
+        next->index[index].prev = prev;
+
+    sess->index[index].prev = NULL;
+    sess->index[index].next = NULL;
+
+    if (index == BSF_INDEX_IPV6PREFIX) {
+        ogs_assert(self.ipv6prefix_count[sess->ipv6index.len] > 0);
+        self.ipv6prefix_count[sess->ipv6index.len]--;
+    }
+}
+
+static bsf_sess_t *index_find(
+        bsf_index_e index, const void *key, int klen, char *dnn)
+{
+    bsf_sess_t *sess = NULL;
+
+    for (sess = ogs_hash_get(self.index_hash[index], key, klen);
+            sess; sess = sess->index[index].next) {
+        if (!dnn || sess->dnn == dnn)
+            return sess;
+    }
+
+    return NULL;
+}
+
 bsf_sess_t *bsf_sess_add_by_ip_address(
             char *ipv4addr_string, char *ipv6prefix_string)
 {
@@ -148,7 +333,9 @@ bsf_sess_t *bsf_sess_add_by_ip_address(
     }
     if (ipv6prefix_string &&
         bsf_sess_set_ipv6prefix(sess, ipv6prefix_string) == false) {
-        ogs_error("bsf_sess_set_ipv6prefix[%s] failed", ipv4addr_string);
+        ogs_error("bsf_sess_set_ipv6prefix[%s] failed", ipv6prefix_string);
+        if (sess->ipv4addr_presence)
+            index_remove(sess, BSF_INDEX_IPV4ADDR);
         ogs_pool_free(&bsf_sess_pool, sess);
         return NULL;
     }
@@ -180,28 +367,23 @@ void bsf_sess_remove(bsf_sess_t *sess)
     ogs_assert(sess->binding_id);
     ogs_free(sess->binding_id);
 
-    if (sess->supi)
+    if (sess->supi) {
+        index_remove(sess, BSF_INDEX_SUPI);
         ogs_free(sess->supi);
+    }
     if (sess->gpsi)
         ogs_free(sess->gpsi);
 
-    if (sess->ipv4addr_string) {
-        ogs_hash_set(self.ipv4addr_hash,
-                &sess->ipv4addr, sizeof(sess->ipv4addr), NULL);
-        ogs_free(sess->ipv4addr_string);
-    }
-    if (sess->ipv6prefix_string) {
-        ogs_hash_set(self.ipv6prefix_hash,
-                &sess->ipv6prefix, (sess->ipv6prefix.len >> 3) + 1, NULL);
-        ogs_free(sess->ipv6prefix_string);
-    }
+    if (sess->ipv4addr_presence)
+        index_remove(sess, BSF_INDEX_IPV4ADDR);
+    if (sess->ipv6prefix_presence)
+        index_remove(sess, BSF_INDEX_IPV6PREFIX);
+    if (sess->snssai_dnn.dnn)
+        index_remove(sess, BSF_INDEX_SNSSAI_DNN);
 
     OpenAPI_clear_and_free_string_list(sess->ipv4_frame_route_list);
     OpenAPI_clear_and_free_string_list(sess->ipv6_frame_route_list);
 
-    ogs_assert(sess->dnn);
-    ogs_free(sess->dnn);
-
     if (sess->pcf_fqdn)
         ogs_free(sess->pcf_fqdn);
 
@@ -226,67 +408,109 @@ void bsf_sess_remove_all(void)
 
 bool bsf_sess_set_ipv4addr(bsf_sess_t *sess, char *ipv4addr_string)
 {
+    uint32_t ipv4addr;
     int rv;
 
     ogs_assert(sess);
     ogs_assert(ipv4addr_string);
 
-    if (sess->ipv4addr_string) {
-        ogs_hash_set(self.ipv4addr_hash,
-                &sess->ipv4addr, sizeof(sess->ipv4addr), NULL);
-        ogs_free(sess->ipv4addr_string);
-    }
-    rv = ogs_ipv4_from_string(&sess->ipv4addr, ipv4addr_string);
+    rv = ogs_ipv4_from_string(&ipv4addr, ipv4addr_string);
     if (rv != OGS_OK) {
         ogs_error("ogs_ipv4_from_string() failed");
         return false;
     }
 
-    sess->ipv4addr_string = ogs_strdup(ipv4addr_string);
-    if (!sess->ipv4addr_string) {
-        ogs_error("ogs_strdup() failed");
-        return false;
-    }
+    if (sess->ipv4addr_presence)
+        index_remove(sess, BSF_INDEX_IPV4ADDR);
+
+    sess->ipv4addr_presence = true;
+    sess->ipv4addr = ipv4addr;
 
-    ogs_hash_set(self.ipv4addr_hash,
-            &sess->ipv4addr, sizeof(sess->ipv4addr), sess);
+    index_add(sess, BSF_INDEX_IPV4ADDR);
 
     return true;
 }
 
 bool bsf_sess_set_ipv6prefix(bsf_sess_t *sess, char *ipv6prefix_string)
 {
+    uint8_t addr6[OGS_IPV6_LEN], len;
     int rv;
 
     ogs_assert(sess);
     ogs_assert(ipv6prefix_string);
 
-    if (sess->ipv6prefix_string) {
-        ogs_hash_set(self.ipv6prefix_hash,
-                &sess->ipv6prefix, (sess->ipv6prefix.len >> 3) + 1, NULL);
-        ogs_free(sess->ipv6prefix_string);
-    }
-    rv = ogs_ipv6prefix_from_string(
-            sess->ipv6prefix.addr6, &sess->ipv6prefix.len, ipv6prefix_string);
-    if (rv != OGS_OK) {
+    rv = ogs_ipv6prefix_from_string(addr6, &len, ipv6prefix_string);
+    if (rv != OGS_OK || len > OGS_IPV6_128_PREFIX_LEN) {
         ogs_error("ogs_ipv6prefix_from_string() failed");
         return false;
     }
 
-    ogs_assert(sess->ipv6prefix.len == OGS_IPV6_128_PREFIX_LEN);
+    if (sess->ipv6prefix_presence)
+        index_remove(sess, BSF_INDEX_IPV6PREFIX);
 
-    sess->ipv6prefix_string = ogs_strdup(ipv6prefix_string);
-    if (!sess->ipv6prefix_string) {
-        ogs_error("ogs_strdup() failed");
+    sess->ipv6prefix_presence = true;
+    sess->ipv6prefix.len = len;
+    memcpy(sess->ipv6prefix.addr6, addr6, OGS_IPV6_LEN);
+
+    /*
+     * The SMF binds the UE address as a /128, but the UE may source
+     * traffic from any interface identifier of its /64 prefix. So no
+     * binding is indexed by more than its /64 prefix.
+     */
+    sess->ipv6index.len = ogs_min(len, OGS_IPV6_DEFAULT_PREFIX_LEN);
+    ipv6index_mask(sess->ipv6index.addr6, addr6, sess->ipv6index.len);
+
+    index_add(sess, BSF_INDEX_IPV6PREFIX);
+
+    return true;
+}
+
+bool bsf_sess_set_snssai_and_dnn(
+        bsf_sess_t *sess, ogs_s_nssai_t *s_nssai, char *dnn)
+{
+    char *name = NULL;
+
+    ogs_assert(sess);
+    ogs_assert(s_nssai);
+    ogs_assert(dnn);
+
+    name = dnn_find(dnn, true);
+    if (!name)
         return false;
-    }
 
-    ogs_hash_set(self.ipv6prefix_hash,
-            &sess->ipv6prefix, (sess->ipv6prefix.len >> 3) + 1, sess);
+    if (sess->snssai_dnn.dnn)
+        index_remove(sess, BSF_INDEX_SNSSAI_DNN);
+
+    sess->s_nssai.sst = s_nssai->sst;
+    sess->s_nssai.sd.v = s_nssai->sd.v;
+    sess->dnn = name;
+
+    memset(&sess->snssai_dnn, 0, sizeof(sess->snssai_dnn));
+    sess->snssai_dnn.dnn = name;
+    sess->snssai_dnn.sst = s_nssai->sst;
+    sess->snssai_dnn.sd = s_nssai->sd.v;
+
+    index_add(sess, BSF_INDEX_SNSSAI_DNN);
 
     return true;
 }
 
+void bsf_sess_set_supi(bsf_sess_t *sess, char *supi)
+{
+    ogs_assert(sess);
+    ogs_assert(supi);
+
+    if (sess->supi) {
+        index_remove(sess, BSF_INDEX_SUPI);
+        ogs_free(sess->supi);
+    }
+
+    sess->supi = ogs_strdup(supi);
+    ogs_assert(sess->supi);
+
+    index_add(sess, BSF_INDEX_SUPI);
+}
+
 bsf_sess_t *bsf_sess_find(uint32_t index)
 {
     return ogs_pool_find(&bsf_sess_pool, index);
@@ -294,17 +518,39 @@ bsf_sess_t *bsf_sess_find(uint32_t index)
 
 bsf_sess_t *bsf_sess_find_by_snssai_and_dnn(ogs_s_nssai_t *s_nssai, char *dnn)
 {
-    bsf_sess_t *sess = NULL;
+    struct {
+        char *dnn;
+        uint32_t sst;
+        uint32_t sd;
+    } snssai_dnn;
 
     ogs_assert(s_nssai);
     ogs_assert(dnn);
 
-    ogs_list_for_each(&self.sess_list, sess)
-        if (sess->s_nssai.sst == s_nssai->sst &&
-            sess->dnn && ogs_strcasecmp(sess->dnn, dnn) == 0)
-            return sess;
+    memset(&snssai_dnn, 0, sizeof(snssai_dnn));
+    snssai_dnn.dnn = dnn_find(dnn, false);
+    if (!snssai_dnn.dnn)
+        return NULL;
+    snssai_dnn.sst = s_nssai->sst;
+    snssai_dnn.sd = s_nssai->sd.v;
 
-    return NULL;
+    return ogs_hash_get(self.index_hash[BSF_INDEX_SNSSAI_DNN],
+            &snssai_dnn, sizeof(snssai_dnn));
+}
+
+bsf_sess_t *bsf_sess_find_by_supi_and_dnn(char *supi, char *dnn)
+{
+    char *name = NULL;
+
+    ogs_assert(supi);
+
+    if (dnn) {
+        name = dnn_find(dnn, false);
+        if (!name)
+            return NULL;
+    }
+
+    return index_find(BSF_INDEX_SUPI, supi, strlen(supi), name);
 }
 
 bsf_sess_t *bsf_sess_find_by_binding_id(char *binding_id)
@@ -313,9 +559,10 @@ bsf_sess_t *bsf_sess_find_by_binding_id(char *binding_id)
     return bsf_sess_find(atoll(binding_id));
 }
 
-bsf_sess_t *bsf_sess_find_by_ipv4addr(char *ipv4addr_string)
+bsf_sess_t *bsf_sess_find_by_ipv4addr(char *ipv4addr_string, char *dnn)
 {
     uint32_t ipv4addr;
+    char *name = NULL;
     int rv;
 
     ogs_assert(ipv4addr_string);
@@ -326,27 +573,69 @@ bsf_sess_t *bsf_sess_find_by_ipv4addr(char *ipv4addr_string)
         return NULL;
     }
 
-    return ogs_hash_get(self.ipv4addr_hash, &ipv4addr, sizeof(ipv4addr));
+    if (dnn) {
+        name = dnn_find(dnn, false);
+        if (!name)
+            return NULL;
+    }
+
+    return index_find(BSF_INDEX_IPV4ADDR, &ipv4addr, sizeof(ipv4addr), name);
 }
 
-bsf_sess_t *bsf_sess_find_by_ipv6prefix(char *ipv6prefix_string)
+/*
+ * Longest prefix match: probe only the prefix lengths that some binding
+ * is indexed by, longest first, and prefer the binding of the exact
+ * address within the matching prefix.
+ */
+bsf_sess_t *bsf_sess_find_by_ipv6prefix(char *ipv6prefix_string, char *dnn)
 {
-    int rv;
+    bsf_sess_t *sess = NULL, *found = NULL;
+    uint8_t addr6[OGS_IPV6_LEN], len;
+    char *name = NULL;
+    int rv, i;
+
     struct {
         uint8_t len;
         uint8_t addr6[OGS_IPV6_LEN];
-    } ipv6prefix;
+    } ipv6index;
 
     ogs_assert(ipv6prefix_string);
 
-    rv = ogs_ipv6prefix_from_string(
-            ipv6prefix.addr6, &ipv6prefix.len, ipv6prefix_string);
-    ogs_assert(rv == OGS_OK);
+    rv = ogs_ipv6prefix_from_string(addr6, &len, ipv6prefix_string);
+    if (rv != OGS_OK || len > OGS_IPV6_128_PREFIX_LEN) {
+        ogs_error("ogs_ipv6prefix_from_string() failed");
+        return NULL;
+    }
+
+    if (dnn) {
+        name = dnn_find(dnn, false);
+        if (!name)
+            return NULL;
+    }
+
+    for (i = ogs_min(len, OGS_IPV6_DEFAULT_PREFIX_LEN); i >= 0; i--) {
+        if (self.ipv6prefix_count[i] == 0)
+            continue;
+
+        ipv6index.len = i;
+        ipv6index_mask(ipv6index.addr6, addr6, i);
+
+        for (sess = ogs_hash_get(self.index_hash[BSF_INDEX_IPV6PREFIX],
+                        &ipv6index, IPV6INDEX_KEY_LEN(i));
+                sess; sess = sess->index[BSF_INDEX_IPV6PREFIX].next) {
+            if (name && sess->dnn != name)
+                continue;
+            if (memcmp(sess->ipv6prefix.addr6, addr6, OGS_IPV6_LEN) == 0)
+                return sess;
+            if (!found)
+                found = sess;
+        }
 
-    ogs_assert(ipv6prefix.len == OGS_IPV6_128_PREFIX_LEN);
+        if (found)
+            return found;
+    }
 
-    return ogs_hash_get(self.ipv6prefix_hash,
-            &ipv6prefix, (ipv6prefix.len >> 3) + 1);
+    return NULL;
 }
 
 int get_sess_load(void)
@@ -34,13 +34,38 @@ extern int __bsf_log_domain;
 #undef OGS_LOG_DOMAIN
 #define OGS_LOG_DOMAIN __bsf_log_domain
 
+/*
+ * Lookup indexes of the PCF bindings
+ *
+ * Each index is a hash whose value is the first binding with that key.
+ * The other bindings with the same key are chained through
+ * bsf_sess_t.index[], so a key shared by several bindings (an S-NSSAI
+ * and DNN, the address of a UE in overlapping pools, or a SUPI with
+ * several PDU sessions) costs one hash entry and no allocation.
+ */
+typedef enum {
+    BSF_INDEX_IPV4ADDR = 0,
+    BSF_INDEX_IPV6PREFIX,
+    BSF_INDEX_SNSSAI_DNN,
+    BSF_INDEX_SUPI,
+
+    BSF_MAX_NUM_OF_INDEX,
+} bsf_index_e;
+
 typedef struct bsf_context_s {
-    ogs_hash_t          *ipv4addr_hash;
-    ogs_hash_t          *ipv6prefix_hash;
+    ogs_hash_t          *index_hash[BSF_MAX_NUM_OF_INDEX];
+
+    /* Number of bindings in the IPv6 index for each prefix length */
+    int                 ipv6prefix_count[OGS_IPV6_128_PREFIX_LEN+1];
+
+    /* Lower-cased DNN -> DNN shared by every binding */
+    ogs_hash_t          *dnn_hash;
 
     ogs_list_t          sess_list;
 } bsf_context_t;
 
+typedef struct bsf_sess_s bsf_sess_t;
+
 typedef struct bsf_sess_s {
     ogs_sbi_object_t sbi;
 
@@ -49,20 +74,36 @@ typedef struct bsf_sess_s {
     char *supi;
     char *gpsi;
 
-    char *ipv4addr_string;
-    char *ipv6prefix_string;
-
     OpenAPI_list_t *ipv4_frame_route_list;
     OpenAPI_list_t *ipv6_frame_route_list;
 
+    bool ipv4addr_presence;
     uint32_t ipv4addr;
+
+    bool ipv6prefix_presence;
     struct {
         uint8_t len;
         uint8_t addr6[OGS_IPV6_LEN];
     } ipv6prefix;
 
     ogs_s_nssai_t s_nssai;
-    char *dnn;
+    char *dnn;                  /* Shared, see bsf_self()->dnn_hash */
+
+    struct {
+        bsf_sess_t *prev;
+        bsf_sess_t *next;
+    } index[BSF_MAX_NUM_OF_INDEX];
+
+    /* Keys of BSF_INDEX_IPV6PREFIX and BSF_INDEX_SNSSAI_DNN */
+    struct {
+        uint8_t len;
+        uint8_t addr6[OGS_IPV6_LEN];
+    } ipv6index;
+    struct {
+        char *dnn;
+        uint32_t sst;
+        uint32_t sd;
+    } snssai_dnn;
 
     /* PCF address information */
     char *pcf_fqdn;
@@ -93,12 +134,16 @@ void bsf_sess_remove_all(void);
 
 bool bsf_sess_set_ipv4addr(bsf_sess_t *sess, char *ipv4addr);
 bool bsf_sess_set_ipv6prefix(bsf_sess_t *sess, char *ipv6prefix);
+bool bsf_sess_set_snssai_and_dnn(
+        bsf_sess_t *sess, ogs_s_nssai_t *s_nssai, char *dnn);
+void bsf_sess_set_supi(bsf_sess_t *sess, char *supi);
 
 bsf_sess_t *bsf_sess_find(uint32_t index);
 bsf_sess_t *bsf_sess_find_by_snssai_and_dnn(ogs_s_nssai_t *s_nssai, char *dnn);
+bsf_sess_t *bsf_sess_find_by_supi_and_dnn(char *supi, char *dnn);
 bsf_sess_t *bsf_sess_find_by_binding_id(char *binding_id);
-bsf_sess_t *bsf_sess_find_by_ipv4addr(char *ipv4addr_string);
-bsf_sess_t *bsf_sess_find_by_ipv6prefix(char *ipv6prefix_string);
+bsf_sess_t *bsf_sess_find_by_ipv4addr(char *ipv4addr_string, char *dnn);
+bsf_sess_t *bsf_sess_find_by_ipv6prefix(char *ipv6prefix_string, char *dnn);
 int get_sess_load(void);
 
 #ifdef __cplusplus
@@ -67,6 +67,7 @@ bool bsf_nbsf_management_handle_pcf_binding(
     } else {
         OpenAPI_list_t *PcfIpEndPointList = NULL;
         OpenAPI_lnode_t *node = NULL;
+        ogs_s_nssai_t s_nssai;
         int i;
 
         SWITCH(recvmsg->h.method)
@@ -128,12 +129,16 @@ bool bsf_nbsf_management_handle_pcf_binding(
                 }
             }
 
-            sess->s_nssai.sst = RecvPcfBinding->snssai->sst;
-            sess->s_nssai.sd =
-                ogs_s_nssai_sd_from_string(RecvPcfBinding->snssai->sd);
+            s_nssai.sst = RecvPcfBinding->snssai->sst;
+            s_nssai.sd = ogs_s_nssai_sd_from_string(RecvPcfBinding->snssai->sd);
 
-            sess->dnn = ogs_strdup(RecvPcfBinding->dnn);
-            ogs_assert(sess->dnn);
+            if (bsf_sess_set_snssai_and_dnn(
+                        sess, &s_nssai, RecvPcfBinding->dnn) == false) {
+                strerror = ogs_msprintf("Invalid DNN [%s]",
+                            RecvPcfBinding->dnn);
+                status = OGS_SBI_HTTP_STATUS_BAD_REQUEST;
+                goto cleanup;
+            }
 
             PcfIpEndPointList = RecvPcfBinding->pcf_ip_end_points;
 
@@ -174,11 +179,8 @@ bool bsf_nbsf_management_handle_pcf_binding(
                 }
             }
 
-            if (RecvPcfBinding->supi) {
-                if (sess->supi)
-                    ogs_free(sess->supi);
-                sess->supi = ogs_strdup(RecvPcfBinding->supi);
-            }
+            if (RecvPcfBinding->supi)
+                bsf_sess_set_supi(sess, RecvPcfBinding->supi);
             if (RecvPcfBinding->gpsi) {
                 if (sess->gpsi)
                     ogs_free(sess->gpsi);
@@ -65,6 +65,7 @@ static void stats_add_enb_ue(void);
 static void stats_remove_enb_ue(void);
 static void stats_add_mme_session(void);
 static void stats_remove_mme_session(void);
+static void enb_paging_ta_clear(mme_enb_t *enb);
 
 static bool compare_ue_info(mme_sgw_t *node, enb_ue_t *enb_ue);
 static mme_sgw_t *selected_sgw_node(mme_sgw_t *current, enb_ue_t *enb_ue);
@@ -136,6 +137,8 @@ void mme_context_init(void)
     ogs_assert(self.imsi_ue_hash);
     self.guti_ue_hash = ogs_hash_make();
     ogs_assert(self.guti_ue_hash);
+    self.paging_ta_hash = ogs_hash_make();
+    ogs_assert(self.paging_ta_hash);
     self.mme_s11_teid_hash = ogs_hash_make();
     ogs_assert(self.mme_s11_teid_hash);
     self.mme_gn_teid_hash = ogs_hash_make();
@@ -169,6 +172,8 @@ void mme_context_final(void)
     ogs_hash_destroy(self.imsi_ue_hash);
     ogs_assert(self.guti_ue_hash);
     ogs_hash_destroy(self.guti_ue_hash);
+    ogs_assert(self.paging_ta_hash);
+    ogs_hash_destroy(self.paging_ta_hash);
     ogs_assert(self.mme_s11_teid_hash);
     ogs_hash_destroy(self.mme_s11_teid_hash);
     ogs_assert(self.mme_gn_teid_hash);
@@ -3017,6 +3022,7 @@ mme_enb_t *mme_enb_add(ogs_sock_t *sock, ogs_sockaddr_t *addr)
     enb->ostream_id = 0;
 
     ogs_list_init(&enb->enb_ue_list);
+    ogs_list_init(&enb->paging_list);
 
     ogs_hash_set(self.enb_addr_hash,
             enb->sctp.addr, sizeof(ogs_sockaddr_t), enb);
@@ -3052,6 +3058,8 @@ int mme_enb_remove(mme_enb_t *enb)
     if (enb->enb_id_presence == true)
         ogs_hash_set(self.enb_id_hash, &enb->enb_id, sizeof(enb->enb_id), NULL);
 
+    enb_paging_ta_clear(enb);
+
     /*
      * CHECK:
      *
@@ -3128,6 +3136,73 @@ mme_enb_t *mme_enb_find_by_id(ogs_pool_id_t id)
     return ogs_pool_find_by_id(&mme_enb_pool, id);
 }
 
+static void enb_paging_ta_clear(mme_enb_t *enb)
+{
+    mme_paging_enb_t *node = NULL, *next_node = NULL;
+    mme_paging_ta_t *ta = NULL;
+
+    ogs_assert(enb);
+
+    ogs_list_for_each_entry_safe(&enb->paging_list, next_node, node, enb_lnode) {
+        ta = node->ta;
+        ogs_assert(ta);
+
+        ogs_list_remove(&ta->enb_list, node);
+        ogs_list_remove(&enb->paging_list, &node->enb_lnode);
+        ogs_free(node);
+
+        if (ogs_list_empty(&ta->enb_list)) {
+            ogs_hash_set(self.paging_ta_hash, &ta->tai, sizeof(ta->tai), NULL);
+            ogs_free(ta);
+        }
+    }
+}
+
+void mme_enb_update_paging_ta(mme_enb_t *enb)
+{
+    int i;
+    mme_paging_ta_t *ta = NULL;
+    mme_paging_enb_t *node = NULL;
+
+    ogs_assert(enb);
+
+    enb_paging_ta_clear(enb);
+
+    for (i = 0; i < enb->num_of_supported_ta_list; i++) {
+        ta = mme_paging_ta_find(&enb->supported_ta_list[i]);
+        if (!ta) {
+            ta = ogs_calloc(1, sizeof(*ta));
+            ogs_assert(ta);
+            memcpy(&ta->tai, &enb->supported_ta_list[i], sizeof(ta->tai));
+            ogs_list_init(&ta->enb_list);
+            ogs_hash_set(self.paging_ta_hash, &ta->tai, sizeof(ta->tai), ta);
+        } else {
+            /*
+             * Nodes of this eNB are appended while no other eNB is
+             * updated, so a duplicated TAI in the Supported TA List
+             * can only be found at the tail.
+             */
+            node = ogs_list_last(&ta->enb_list);
+            if (node && node->enb_id == enb->id)
+                continue;
+        }
+
+        node = ogs_calloc(1, sizeof(*node));
+        ogs_assert(node);
+        node->ta = ta;
+        node->enb_id = enb->id;
+
+        ogs_list_add(&ta->enb_list, node);
+        ogs_list_add(&enb->paging_list, &node->enb_lnode);
+    }
+}
+
+mme_paging_ta_t *mme_paging_ta_find(ogs_eps_tai_t *tai)
+{
+    ogs_assert(tai);
+    return ogs_hash_get(self.paging_ta_hash, tai, sizeof(*tai));
+}
+
 /** enb_ue_context handling function */
 enb_ue_t *enb_ue_add(mme_enb_t *enb, uint32_t enb_ue_s1ap_id)
 {
@@ -3692,6 +3767,10 @@ void mme_ue_remove(mme_ue_t *mme_ue)
 
     mme_sess_remove_all(mme_ue);
     mme_session_remove_all(mme_ue);
+    if (mme_ue->session)
+        ogs_free(mme_ue->session);
+    if (mme_ue->nas_security_cache)
+        ogs_free(mme_ue->nas_security_cache);
 
     mme_ebi_pool_final(mme_ue);
 
@@ -4816,6 +4895,30 @@ mme_bearer_t *mme_bearer_find_by_id(ogs_pool_id_t id)
     return ogs_pool_find_by_id(&mme_bearer_pool, id);
 }
 
+ogs_nas_security_cache_t *mme_ue_nas_security_cache(mme_ue_t *mme_ue)
+{
+    ogs_assert(mme_ue);
+
+    if (!mme_ue->nas_security_cache) {
+        mme_ue->nas_security_cache =
+            ogs_calloc(1, sizeof(ogs_nas_security_cache_t));
+        ogs_assert(mme_ue->nas_security_cache);
+    }
+
+    return mme_ue->nas_security_cache;
+}
+
+void mme_session_array_alloc(mme_ue_t *mme_ue)
+{
+    ogs_assert(mme_ue);
+
+    if (mme_ue->session)
+        return;
+
+    mme_ue->session = ogs_calloc(OGS_MAX_NUM_OF_SESS, sizeof(ogs_session_t));
+    ogs_assert(mme_ue->session);
+}
+
 void mme_session_remove_all(mme_ue_t *mme_ue)
 {
     int i;
@@ -4826,6 +4929,7 @@ void mme_session_remove_all(mme_ue_t *mme_ue)
     for (i = 0; i < mme_ue->num_of_session; i++) {
         if (mme_ue->session[i].name)
             ogs_free(mme_ue->session[i].name);
+        memset(&mme_ue->session[i], 0, sizeof(mme_ue->session[i]));
     }
 
     mme_ue->num_of_session = 0;
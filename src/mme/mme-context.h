@@ -154,6 +154,7 @@ typedef struct mme_context_s {
     ogs_hash_t *enb_id_hash;    /* hash table for ENB-ID */
     ogs_hash_t *imsi_ue_hash;   /* hash table (IMSI : MME_UE) */
     ogs_hash_t *guti_ue_hash;   /* hash table (GUTI : MME_UE) */
+    ogs_hash_t *paging_ta_hash; /* hash table (TAI : MME_PAGING_TA) */
 
     ogs_hash_t *mme_s11_teid_hash;  /* hash table (MME-S11-TEID : MME_UE) */
     ogs_hash_t *mme_gn_teid_hash;  /* hash table (MME-GN-TEID : MME_UE) */
@@ -265,8 +266,31 @@ typedef struct mme_enb_s {
 
     ogs_list_t      enb_ue_list;
 
+    ogs_list_t      paging_list;    /* List of mme_paging_enb_t */
+
 } mme_enb_t;
 
+/*
+ * TAI to eNB index used by S1-Paging.
+ *
+ * Each TAI supported by at least one eNB has an mme_paging_ta_t entry
+ * in mme_self()->paging_ta_hash linking all eNBs supporting it. It is
+ * rebuilt from enb->supported_ta_list on S1 Setup and
+ * eNB Configuration Update.
+ */
+typedef struct mme_paging_ta_s {
+    ogs_eps_tai_t   tai;
+    ogs_list_t      enb_list;       /* List of mme_paging_enb_t */
+} mme_paging_ta_t;
+
+typedef struct mme_paging_enb_s {
+    ogs_lnode_t     lnode;          /* Node in mme_paging_ta_t->enb_list */
+    ogs_lnode_t     enb_lnode;      /* Node in mme_enb_t->paging_list */
+
+    mme_paging_ta_t *ta;
+    ogs_pool_id_t   enb_id;
+} mme_paging_enb_t;
+
 struct enb_ue_s {
     ogs_lnode_t     lnode;
     ogs_pool_id_t   id;
@@ -548,6 +572,12 @@ struct mme_ue_s {
     /* Integrity and ciphering keys */
     uint8_t         knas_int[OGS_SHA256_DIGEST_SIZE/2];
     uint8_t         knas_enc[OGS_SHA256_DIGEST_SIZE/2];
+    /*
+     * Key schedules derived from knas_int/knas_enc. Only UEs that reach
+     * secured NAS need them, so mme_ue_nas_security_cache() allocates
+     * them on first use.
+     */
+    ogs_nas_security_cache_t *nas_security_cache;
     /* Downlink counter */
     uint32_t        dl_count;
     /* Uplink counter (24-bit stored in i32) */
@@ -597,8 +627,13 @@ struct mme_ue_s {
 
     uint32_t        context_identifier; /* default APN */
 
+    /*
+     * APN configuration is only read while setting up a PDN connection,
+     * so it is kept out of line and allocated on demand with
+     * mme_session_array_alloc() to keep the per-UE context compact.
+     */
     int num_of_session;
-    ogs_session_t session[OGS_MAX_NUM_OF_SESS];
+    ogs_session_t *session; /* [OGS_MAX_NUM_OF_SESS] */
 
     /* ESM Info */
     ogs_list_t      sess_list;
@@ -1057,6 +1092,9 @@ int mme_enb_set_enb_id(mme_enb_t *enb, uint32_t enb_id);
 int mme_enb_sock_type(ogs_sock_t *sock);
 mme_enb_t *mme_enb_find_by_id(ogs_pool_id_t id);
 
+void mme_enb_update_paging_ta(mme_enb_t *enb);
+mme_paging_ta_t *mme_paging_ta_find(ogs_eps_tai_t *tai);
+
 enb_ue_t *enb_ue_add(mme_enb_t *enb, uint32_t enb_ue_s1ap_id);
 void enb_ue_remove(enb_ue_t *enb_ue);
 void enb_ue_switch_to_enb(enb_ue_t *enb_ue, mme_enb_t *new_enb);
@@ -1199,6 +1237,8 @@ mme_bearer_t *mme_bearer_first(const mme_sess_t *sess);
 mme_bearer_t *mme_bearer_next(mme_bearer_t *bearer);
 mme_bearer_t *mme_bearer_find_by_id(ogs_pool_id_t id);
 
+void mme_session_array_alloc(mme_ue_t *mme_ue);
+ogs_nas_security_cache_t *mme_ue_nas_security_cache(mme_ue_t *mme_ue);
 void mme_session_remove_all(mme_ue_t *mme_ue);
 ogs_session_t *mme_session_find_by_apn(mme_ue_t *mme_ue, const char *apn);
 ogs_session_t *mme_default_session(mme_ue_t *mme_ue);
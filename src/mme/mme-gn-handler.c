@@ -230,6 +230,7 @@ static mme_sess_t *mme_ue_session_from_gtp1_pdp_ctx(mme_ue_t *mme_ue, const ogs_
     ogs_sess = mme_session_find_by_apn(mme_ue, gtp1_pdp_ctx->apn);
     if (!ogs_sess) {
         ogs_assert(mme_ue->num_of_session < OGS_MAX_NUM_OF_SESS);
+        mme_session_array_alloc(mme_ue);
         ogs_sess = &mme_ue->session[mme_ue->num_of_session];
         mme_ue->num_of_session++;
         ogs_sess->name = ogs_strdup(gtp1_pdp_ctx->apn);
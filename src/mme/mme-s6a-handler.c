@@ -346,6 +346,9 @@ static uint8_t mme_ue_session_from_slice_data(mme_ue_t *mme_ue,
     ogs_slice_data_t *slice_data)
 {
     int i;
+
+    mme_session_array_alloc(mme_ue);
+
     for (i = 0; i < slice_data->num_of_session; i++) {
         if (i >= OGS_MAX_NUM_OF_SESS) {
             ogs_warn("Ignore max session count overflow [%d>=%d]",
@@ -211,6 +211,8 @@ void s1ap_handle_s1_setup_request(mme_enb_t *enb, ogs_s1ap_message_t *message)
         }
     }
 
+    mme_enb_update_paging_ta(enb);
+
     if (maximum_number_of_enbs_is_reached()) {
         ogs_warn("S1-Setup failure:");
         ogs_warn("    Maximum number of eNBs reached");
@@ -354,6 +356,8 @@ void s1ap_handle_enb_configuration_update(
             }
         }
 
+        mme_enb_update_paging_ta(enb);
+
         /*
          * TS36.413
          * Section 8.7.3.4 Abnormal Conditions
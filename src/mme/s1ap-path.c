@@ -494,7 +494,8 @@ int s1ap_send_paging(mme_ue_t *mme_ue, S1AP_CNDomain_t cn_domain)
 {
     ogs_pkbuf_t *s1apbuf = NULL;
     mme_enb_t *enb = NULL;
-    int i;
+    mme_paging_ta_t *ta = NULL;
+    mme_paging_enb_t *node = NULL;
     int rv;
 
     ogs_debug("S1-Paging");
@@ -505,34 +506,45 @@ int s1ap_send_paging(mme_ue_t *mme_ue, S1AP_CNDomain_t cn_domain)
     }
 
     /* Find enB with matched TAI */
-    ogs_list_for_each(&mme_self()->enb_list, enb) {
-        for (i = 0; i < enb->num_of_supported_ta_list; i++) {
-
-            if (memcmp(&enb->supported_ta_list[i], &mme_ue->tai,
-                        sizeof(ogs_eps_tai_t)) == 0) {
-
-                if (mme_ue->t3413.pkbuf) {
-                    s1apbuf = mme_ue->t3413.pkbuf;
-                } else {
-                    s1apbuf = s1ap_build_paging(mme_ue, cn_domain);
-                    if (!s1apbuf) {
-                        ogs_error("s1ap_build_paging() failed");
-                        return OGS_ERROR;
-                    }
-                }
-
-                mme_ue->t3413.pkbuf = ogs_pkbuf_copy(s1apbuf);
-                if (!mme_ue->t3413.pkbuf) {
-                    ogs_error("ogs_pkbuf_copy() failed");
-                    ogs_pkbuf_free(s1apbuf);
-                    return OGS_ERROR;
-                }
-
-                rv = s1ap_send_to_enb(enb, s1apbuf, S1AP_NON_UE_SIGNALLING);
-                if (rv != OGS_OK) {
-                    ogs_error("s1ap_send_to_enb() failed");
-                    return rv;
-                }
+    ta = mme_paging_ta_find(&mme_ue->tai);
+    if (ta) {
+        /*
+         * The Paging message is encoded only once and kept for T3413.
+         * The encoder output lives in an OGS_MAX_SDU_LEN buffer, so it is
+         * shrunk to the PDU length to keep the per-eNB copy cheap.
+         */
+        if (!mme_ue->t3413.pkbuf) {
+            s1apbuf = s1ap_build_paging(mme_ue, cn_domain);
+            if (!s1apbuf) {
+                ogs_error("s1ap_build_paging() failed");
+                return OGS_ERROR;
+            }
+
+            mme_ue->t3413.pkbuf = ogs_pkbuf_alloc(NULL, s1apbuf->len);
+            if (!mme_ue->t3413.pkbuf) {
+                ogs_error("ogs_pkbuf_alloc() failed");
+                ogs_pkbuf_free(s1apbuf);
+                return OGS_ERROR;
+            }
+            ogs_pkbuf_put_data(mme_ue->t3413.pkbuf,
+                    s1apbuf->data, s1apbuf->len);
+            ogs_pkbuf_free(s1apbuf);
+        }
+
+        ogs_list_for_each(&ta->enb_list, node) {
+            enb = mme_enb_find_by_id(node->enb_id);
+            ogs_assert(enb);
+
+            s1apbuf = ogs_pkbuf_copy(mme_ue->t3413.pkbuf);
+            if (!s1apbuf) {
+                ogs_error("ogs_pkbuf_copy() failed");
+                return OGS_ERROR;
+            }
+
+            rv = s1ap_send_to_enb(enb, s1apbuf, S1AP_NON_UE_SIGNALLING);
+            if (rv != OGS_OK) {
+                ogs_error("s1ap_send_to_enb() failed");
+                return rv;
             }
         }
     }
@@ -29,7 +29,7 @@ static void lksctp_accept_handler(short when, ogs_socket_t fd, void *data);
 #endif
 
 void s1ap_accept_handler(ogs_sock_t *sock);
-void s1ap_recv_handler(ogs_sock_t *sock);
+int s1ap_recv_handler(ogs_sock_t *sock);
 
 ogs_sock_t *s1ap_server(ogs_socknode_t *node)
 {
@@ -68,12 +68,20 @@ ogs_sock_t *s1ap_server(ogs_socknode_t *node)
 void s1ap_recv_upcall(short when, ogs_socket_t fd, void *data)
 {
     ogs_sock_t *sock = NULL;
+    int i;
 
     ogs_assert(fd != INVALID_SOCKET);
     sock = data;
     ogs_assert(sock);
 
-    s1ap_recv_handler(sock);
+    /*
+     * The socket is non-blocking once it is added to the pollset,
+     * so drain several messages per wakeup instead of going back
+     * to the pollset for each of them.
+     */
+    for (i = 0; i < OGS_SCTP_MAX_RECV_BURST; i++)
+        if (s1ap_recv_handler(sock) != OGS_OK)
+            break;
 }
 
 #if HAVE_USRSCTP
@@ -120,7 +128,7 @@ void s1ap_accept_handler(ogs_sock_t *sock)
     }
 }
 
-void s1ap_recv_handler(ogs_sock_t *sock)
+int s1ap_recv_handler(ogs_sock_t *sock)
 {
     ogs_pkbuf_t *pkbuf;
     int size;
@@ -136,11 +144,16 @@ void s1ap_recv_handler(ogs_sock_t *sock)
     ogs_pkbuf_put(pkbuf, OGS_MAX_SDU_LEN);
     size = ogs_sctp_recvmsg(
             sock, pkbuf->data, pkbuf->len, &from, &sinfo, &flags);
+    if (size < 0 && ogs_socket_errno == OGS_EAGAIN) {
+        /* Nothing left to read */
+        ogs_pkbuf_free(pkbuf);
+        return OGS_RETRY;
+    }
     if (size < 0 || size >= OGS_MAX_SDU_LEN) {
         ogs_error("ogs_sctp_recvmsg(%d) failed(%d:%s)",
                 size, errno, strerror(errno));
         ogs_pkbuf_free(pkbuf);
-        return;
+        return OGS_ERROR;
     }
 
     if (flags & MSG_NOTIFICATION) {
@@ -243,7 +256,7 @@ void s1ap_recv_handler(ogs_sock_t *sock)
         memcpy(addr, &from, sizeof(ogs_sockaddr_t));
 
         s1ap_event_push(MME_EVENT_S1AP_MESSAGE, sock, addr, pkbuf, 0, 0);
-        return;
+        return OGS_OK;
     } else {
         if (ogs_socket_errno != OGS_EAGAIN) {
             ogs_fatal("ogs_sctp_recvmsg(%d) failed(%d:%s-0x%x)",
@@ -256,4 +269,5 @@ void s1ap_recv_handler(ogs_sock_t *sock)
     }
 
     ogs_pkbuf_free(pkbuf);
+    return OGS_DONE;
 }
@@ -64,6 +64,9 @@ void pcf_context_final(void)
 
     pcf_ue_remove_all();
 
+    if (self.cache.db)
+        ogs_sbi_cache_destroy(self.cache.db);
+
     ogs_assert(self.supi_hash);
     ogs_hash_destroy(self.supi_hash);
     ogs_assert(self.ipv4addr_hash);
@@ -83,8 +86,21 @@ pcf_context_t *pcf_self(void)
     return &self;
 }
 
+static void cache_data_free(void *data)
+{
+    ogs_sbi_message_t *message = data;
+
+    ogs_assert(message);
+
+    ogs_sbi_message_free(message);
+    ogs_free(message);
+}
+
 static int pcf_context_prepare(void)
 {
+#define PCF_CACHE_DEFAULT_TTL 30 /* 30 seconds */
+    self.cache.ttl = ogs_time_from_sec(PCF_CACHE_DEFAULT_TTL);
+
     return OGS_OK;
 }
 
@@ -323,6 +339,21 @@ int pcf_context_parse_config(void)
                         ogs_error("parse_policy_conf() failed");
                         return rv;
                     }
+                } else if (!strcmp(pcf_key, "cache")) {
+                    ogs_yaml_iter_t cache_iter;
+                    ogs_yaml_iter_recurse(&pcf_iter, &cache_iter);
+                    while (ogs_yaml_iter_next(&cache_iter)) {
+                        const char *cache_key = ogs_yaml_iter_key(&cache_iter);
+                        ogs_assert(cache_key);
+                        if (!strcmp(cache_key, "size")) {
+                            const char *v = ogs_yaml_iter_value(&cache_iter);
+                            if (v) self.cache.size = atoi(v);
+                        } else if (!strcmp(cache_key, "ttl")) {
+                            const char *v = ogs_yaml_iter_value(&cache_iter);
+                            if (v) self.cache.ttl = ogs_time_from_sec(atoi(v));
+                        } else
+                            ogs_warn("unknown key `%s`", cache_key);
+                    }
                 } else
                     ogs_warn("unknown key `%s`", pcf_key);
             }
@@ -332,6 +363,10 @@ int pcf_context_parse_config(void)
     rv = pcf_context_validation();
     if (rv != OGS_OK) return rv;
 
+    if (self.cache.size > 0)
+        self.cache.db = ogs_sbi_cache_create(
+                self.cache.size, self.cache.ttl, cache_data_free);
+
     return OGS_OK;
 }
 
@@ -798,6 +833,89 @@ pcf_app_t *pcf_app_find_by_app_session_id(char *app_session_id)
     return pcf_app_find(atoll(app_session_id));
 }
 
+/*
+ * The UDR does not notify policy data changes made through the WebUI,
+ * so an entry is only trusted for the configured TTL.
+ */
+void pcf_cache_add(ogs_sbi_request_t *request, ogs_sbi_message_t *message)
+{
+    ogs_sbi_message_t *cached = NULL;
+    char *key = NULL;
+
+    ogs_assert(request);
+    ogs_assert(message);
+
+    if (!self.cache.db)
+        return;
+
+    if (!request->h.method ||
+        strcmp(request->h.method, OGS_SBI_HTTP_METHOD_GET) != 0)
+        return;
+    if (message->res_status != OGS_SBI_HTTP_STATUS_OK)
+        return;
+
+    cached = ogs_calloc(1, sizeof(*cached));
+    ogs_assert(cached);
+
+    SWITCH(message->h.resource.component[3])
+    CASE(OGS_SBI_RESOURCE_NAME_AM_DATA)
+        if (message->AmPolicyData)
+            cached->AmPolicyData = OpenAPI_am_policy_data_copy(
+                    NULL, message->AmPolicyData);
+        break;
+
+    CASE(OGS_SBI_RESOURCE_NAME_SM_DATA)
+        if (message->SmPolicyData)
+            cached->SmPolicyData = OpenAPI_sm_policy_data_copy(
+                    NULL, message->SmPolicyData);
+        break;
+
+    DEFAULT
+    END
+
+    if (!cached->AmPolicyData && !cached->SmPolicyData) {
+        cache_data_free(cached);
+        return;
+    }
+
+    cached->res_status = OGS_SBI_HTTP_STATUS_OK;
+
+    key = ogs_sbi_cache_key(request);
+    ogs_assert(key);
+    ogs_sbi_cache_set(self.cache.db, key, cached);
+    ogs_free(key);
+}
+
+bool pcf_cache_find(ogs_sbi_request_t *request, ogs_sbi_message_t *message)
+{
+    ogs_sbi_message_t *cached = NULL;
+    char *key = NULL;
+
+    ogs_assert(request);
+    ogs_assert(message);
+
+    if (!self.cache.db)
+        return false;
+
+    key = ogs_sbi_cache_key(request);
+    ogs_assert(key);
+    cached = ogs_sbi_cache_get(self.cache.db, key);
+    ogs_free(key);
+
+    if (!cached)
+        return false;
+
+    /* Looks as if the UDR had just responded to the request */
+    memcpy(message, cached, sizeof(*message));
+    message->h.method = request->h.method;
+    message->h.service.name = request->h.service.name;
+    message->h.api.version = request->h.api.version;
+    memcpy(&message->h.resource, &request->h.resource,
+            sizeof(message->h.resource));
+
+    return true;
+}
+
 int pcf_instance_get_load(void)
 {
     return (((ogs_pool_size(&pcf_ue_pool) -
@@ -43,6 +43,13 @@ typedef struct pcf_context_s {
 
     ogs_hash_t      *ipv4addr_hash;
     ogs_hash_t      *ipv6prefix_hash;
+
+    /* Policy data from the UDR, see pcf_cache_add() */
+    struct {
+        int         size;       /* 0 disables the cache */
+        ogs_time_t  ttl;
+        ogs_sbi_cache_t *db;
+    } cache;
 } pcf_context_t;
 
 struct pcf_ue_s {
@@ -212,6 +219,9 @@ int pcf_app_remove(pcf_app_t *app);
 void pcf_app_remove_all(pcf_sess_t *sess);
 pcf_app_t *pcf_app_find(uint32_t index);
 pcf_app_t *pcf_app_find_by_app_session_id(char *app_session_id);
+void pcf_cache_add(ogs_sbi_request_t *request, ogs_sbi_message_t *message);
+bool pcf_cache_find(ogs_sbi_request_t *request, ogs_sbi_message_t *message);
+
 int pcf_instance_get_load(void);
 
 int pcf_db_qos_data(char *supi,
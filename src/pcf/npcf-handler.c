@@ -20,6 +20,7 @@
 #include "sbi-path.h"
 
 #include "npcf-handler.h"
+#include "nudr-handler.h"
 
 bool pcf_npcf_am_policy_control_handle_create(pcf_ue_t *pcf_ue,
         ogs_sbi_stream_t *stream, ogs_sbi_message_t *message)
@@ -205,6 +206,22 @@ bool pcf_npcf_am_policy_control_handle_create(pcf_ue_t *pcf_ue,
         return true;
     } else {
         /* Home PLMN */
+        if (pcf_self()->cache.db) {
+            ogs_sbi_request_t *request = NULL;
+            ogs_sbi_message_t recvmsg;
+
+            request = pcf_nudr_dr_build_query_am_data(pcf_ue, NULL);
+            ogs_assert(request);
+
+            if (pcf_cache_find(request, &recvmsg)) {
+                rc = pcf_nudr_dr_handle_query_am_data(
+                        pcf_ue, stream, &recvmsg);
+                ogs_sbi_request_free(request);
+                return rc;
+            }
+            ogs_sbi_request_free(request);
+        }
+
         r = pcf_ue_sbi_discover_and_send(OGS_SBI_SERVICE_TYPE_NUDR_DR, NULL,
                 pcf_nudr_dr_build_query_am_data, pcf_ue, stream, NULL);
         ogs_expect(r == OGS_OK);
@@ -505,6 +522,22 @@ bool pcf_npcf_smpolicycontrol_handle_create(pcf_sess_t *sess,
         return (r == OGS_OK);
     } else {
         /* Home PLMN */
+        if (pcf_self()->cache.db) {
+            ogs_sbi_request_t *request = NULL;
+            ogs_sbi_message_t recvmsg;
+
+            request = pcf_nudr_dr_build_query_sm_data(sess, NULL);
+            ogs_assert(request);
+
+            if (pcf_cache_find(request, &recvmsg)) {
+                rc = pcf_nudr_dr_handle_query_sm_data(
+                        sess, stream, &recvmsg);
+                ogs_sbi_request_free(request);
+                return rc;
+            }
+            ogs_sbi_request_free(request);
+        }
+
         r = pcf_sess_sbi_discover_and_send(
                 OGS_SBI_SERVICE_TYPE_NUDR_DR, NULL,
                 pcf_nudr_dr_build_query_sm_data, sess, stream, NULL);
@@ -505,6 +505,9 @@ void pcf_state_operational(ogs_fsm_t *s, pcf_event_t *e)
                         e->h.sbi.data =
                             OGS_UINT_TO_POINTER(sbi_xact->assoc_stream_id);
 
+                    if (sbi_xact->request)
+                        pcf_cache_add(sbi_xact->request, &message);
+
                     ogs_sbi_xact_remove(sbi_xact);
 
                     pcf_ue = pcf_ue_find_by_id(pcf_ue_id);
@@ -548,6 +551,9 @@ void pcf_state_operational(ogs_fsm_t *s, pcf_event_t *e)
                         e->h.sbi.data =
                             OGS_UINT_TO_POINTER(sbi_xact->assoc_stream_id);
 
+                    if (sbi_xact->request)
+                        pcf_cache_add(sbi_xact->request, &message);
+
                     ogs_sbi_xact_remove(sbi_xact);
 
                     sess = pcf_sess_find_by_id(sess_id);
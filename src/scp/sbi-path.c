@@ -1025,8 +1025,10 @@ static bool send_request(
 
     /* Added Custom Header(Target-apiRoot) */
     if (assoc->target_apiroot)
-        ogs_sbi_header_set(scp_request.http.headers,
-                OGS_SBI_CUSTOM_TARGET_APIROOT, assoc->target_apiroot);
+        ogs_hash_set(scp_request.http.headers,
+                OGS_SBI_CUSTOM_TARGET_APIROOT,
+                strlen(OGS_SBI_CUSTOM_TARGET_APIROOT),
+                assoc->target_apiroot);
 
     /* Client ApiRoot */
     uri_apiroot = ogs_sbi_client_apiroot(client);
@@ -1040,7 +1042,12 @@ static bool send_request(
     rc = ogs_sbi_client_send_request(client, client_cb, &scp_request, assoc);
     ogs_expect(rc == true);
 
-    ogs_sbi_http_hash_free(scp_request.http.headers);
+    /* The client did not take the body, e.g. for a GET or on failure */
+    if (scp_request.http.content)
+        ogs_free(scp_request.http.content);
+
+    /* Keys and values are borrowed, so only the hash itself is freed */
+    ogs_hash_destroy(scp_request.http.headers);
     ogs_free(scp_request.h.uri);
     ogs_free(uri_apiroot);
 
@@ -1058,17 +1065,30 @@ static void copy_request(
 
     memset(target, 0, sizeof(*target));
 
-    /* HTTP method/params/content */
+    /*
+     * HTTP method/params/content
+     *
+     * The body is not needed once the request is forwarded, so it moves
+     * to the client connection instead of being copied.
+     */
     target->h.method = source->h.method;
     target->http.params = source->http.params;
     target->http.content = source->http.content;
     target->http.content_length = source->http.content_length;
+    target->move_content = true;
+
+    source->http.content = NULL;
+    source->http.content_length = 0;
 
     /* HTTP Headers
      *
      * To remove the followings,
      *   Scheme - https
      *   Authority - scp.open5gs.org
+     *
+     * The keys and values point into the source request. The client
+     * formats its own copy of each header when the request is sent,
+     * so nothing needs to be duplicated here.
      */
     target->http.headers = ogs_hash_make();
     ogs_assert(target->http.headers);
@@ -1097,7 +1117,7 @@ static void copy_request(
         } else if (!strcasecmp(key, OGS_SBI_SCHEME)) {
         } else if (!strcasecmp(key, OGS_SBI_AUTHORITY)) {
         } else {
-            ogs_sbi_header_set(target->http.headers, key, val);
+            ogs_hash_set(target->http.headers, key, strlen(key), val);
         }
     }
 }
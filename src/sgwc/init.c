@@ -136,8 +136,12 @@ static void sgwc_main(void *data)
             ogs_fsm_dispatch(&sgwc_sm, e);
             sgwc_event_free(e);
         }
+
+        /* Send the PFCP messages held during this iteration */
+        ogs_pfcp_flush();
     }
 done:
+    ogs_pfcp_flush();
 
     ogs_fsm_fini(&sgwc_sm, 0);
 }
@@ -24,42 +24,23 @@
 
 static ogs_pkbuf_pool_t *packet_pool = NULL;
 
-static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
+static void gtpu_recv_message(ogs_sock_t *sock, ogs_socket_t fd,
+        ogs_pkbuf_t *pkbuf, ogs_sockaddr_t *from)
 {
     int len;
-    ssize_t size;
     char buf1[OGS_ADDRSTRLEN];
     char buf2[OGS_ADDRSTRLEN];
 
     sgwu_sess_t *sess = NULL;
 
-    ogs_pkbuf_t *pkbuf = NULL;
-    ogs_sock_t *sock = NULL;
-    ogs_sockaddr_t from;
-
     ogs_gtp2_header_t *gtp_h = NULL;
     ogs_gtp2_header_desc_t header_desc;
     ogs_pfcp_user_plane_report_t report;
 
-    ogs_assert(fd != INVALID_SOCKET);
-    sock = data;
     ogs_assert(sock);
-
-    pkbuf = ogs_pkbuf_alloc(packet_pool, OGS_MAX_PKT_LEN);
-    ogs_assert(pkbuf);
-    ogs_pkbuf_put(pkbuf, OGS_MAX_PKT_LEN);
-
-    size = ogs_recvfrom(fd, pkbuf->data, pkbuf->len, 0, &from);
-    if (size <= 0) {
-        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
-                "ogs_recv() failed");
-        goto cleanup;
-    }
-
-    ogs_pkbuf_trim(pkbuf, size);
-
     ogs_assert(pkbuf);
     ogs_assert(pkbuf->len);
+    ogs_assert(from);
 
     gtp_h = (ogs_gtp2_header_t *)pkbuf->data;
     if (gtp_h->version != OGS_GTP2_VERSION_1) {
@@ -77,16 +58,16 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     if (header_desc.type == OGS_GTPU_MSGTYPE_ECHO_REQ) {
         ogs_pkbuf_t *echo_rsp;
 
-        ogs_debug("[RECV] Echo Request from [%s]", OGS_ADDR(&from, buf1));
+        ogs_debug("[RECV] Echo Request from [%s]", OGS_ADDR(from, buf1));
         echo_rsp = ogs_gtp2_handle_echo_req(pkbuf);
         ogs_expect(echo_rsp);
         if (echo_rsp) {
             ssize_t sent;
 
             /* Echo reply */
-            ogs_debug("[SEND] Echo Response to [%s]", OGS_ADDR(&from, buf1));
+            ogs_debug("[SEND] Echo Response to [%s]", OGS_ADDR(from, buf1));
 
-            sent = ogs_sendto(fd, echo_rsp->data, echo_rsp->len, 0, &from);
+            sent = ogs_sendto(fd, echo_rsp->data, echo_rsp->len, 0, from);
             if (sent < 0 || sent != echo_rsp->len) {
                 ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
                         "ogs_sendto() failed");
@@ -104,7 +85,7 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     }
 
     ogs_trace("[RECV] GPU-U Type [%d] from [%s] : TEID[0x%x]",
-            header_desc.type, OGS_ADDR(&from, buf1), header_desc.teid);
+            header_desc.type, OGS_ADDR(from, buf1), header_desc.teid);
 
     /* Remove GTP header and send packets to peer NF */
     ogs_assert(ogs_pkbuf_pull(pkbuf, len));
@@ -135,9 +116,9 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                 ogs_error("[%s] Send Error Indication [TEID:0x%x] to [%s]",
                         OGS_ADDR(&sock->local_addr, buf1),
                         header_desc.teid,
-                        OGS_ADDR(&from, buf2));
+                        OGS_ADDR(from, buf2));
                 ogs_gtp1_send_error_indication(
-                        sock, header_desc.teid, 0, &from);
+                        sock, header_desc.teid, 0, from);
             }
             goto cleanup;
         }
@@ -212,9 +193,9 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                 ogs_error("[%s] Send Error Indication [TEID:0x%x] to [%s]",
                         OGS_ADDR(&sock->local_addr, buf1),
                         header_desc.teid,
-                        OGS_ADDR(&from, buf2));
+                        OGS_ADDR(from, buf2));
                 ogs_gtp1_send_error_indication(
-                        sock, header_desc.teid, 0, &from);
+                        sock, header_desc.teid, 0, from);
             }
             goto cleanup;
         }
@@ -290,6 +271,26 @@ cleanup:
     ogs_pkbuf_free(pkbuf);
 }
 
+static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
+{
+    ogs_pkbuf_t *pkbuf[OGS_GTPU_MAX_RECV_BATCH];
+    ogs_sockaddr_t from[OGS_GTPU_MAX_RECV_BATCH];
+    ogs_sock_t *sock = NULL;
+    int i, num;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    sock = data;
+    ogs_assert(sock);
+
+    num = ogs_gtpu_recvmmsg(fd, packet_pool, 0,
+            pkbuf, from, OGS_GTPU_MAX_RECV_BATCH);
+    for (i = 0; i < num; i++)
+        gtpu_recv_message(sock, fd, pkbuf[i], &from[i]);
+
+    /* Send the G-PDUs relayed from this batch */
+    ogs_gtpu_flush();
+}
+
 int sgwu_gtp_init(void)
 {
     ogs_pkbuf_config_t config;
@@ -311,6 +312,7 @@ int sgwu_gtp_init(void)
 
 void sgwu_gtp_final(void)
 {
+    ogs_gtpu_recvbuf_flush();
     ogs_pkbuf_pool_destroy(packet_pool);
 }
 
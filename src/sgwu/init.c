@@ -133,8 +133,14 @@ static void sgwu_main(void *data)
             ogs_fsm_dispatch(&sgwu_sm, e);
             sgwu_event_free(e);
         }
+
+        /* Send the PFCP messages and G-PDUs held during this iteration */
+        ogs_pfcp_flush();
+        ogs_gtpu_flush();
     }
 done:
+    ogs_pfcp_flush();
+    ogs_gtpu_flush();
 
     ogs_fsm_fini(&sgwu_sm, 0);
 }
@@ -77,6 +77,10 @@ void smf_context_init(void)
     smf_ctf_config_init(&self.ctf_config);
     self.diam_config = &g_diam_conf;
 
+    /* Setup CP Function Features */
+    ogs_pfcp_self()->cp_function_features.load = 1;
+    ogs_pfcp_self()->cp_function_features.ovrl = 1;
+
     ogs_log_install_domain(&__ogs_ngap_domain, "ngap", ogs_core()->log.level);
     ogs_log_install_domain(&__ogs_nas_domain, "nas", ogs_core()->log.level);
     ogs_log_install_domain(&__ogs_diam_domain, "diam", ogs_core()->log.level);
@@ -1142,40 +1146,68 @@ static bool compare_ue_info(ogs_pfcp_node_t *node, smf_sess_t *sess)
     return false;
 }
 
+/*
+ * Cyclic search from the node after current position.
+ *
+ * Among the associated UPFs, the one with the lowest Load Metric is chosen,
+ * and ties are broken by the round-robin order. If throttle is set,
+ * a UPF reporting an Overload Reduction Metric is skipped with
+ * the corresponding probability (TS29.244 Ch 6.2.4.3.2).
+ */
+static ogs_pfcp_node_t *least_loaded_upf_node(ogs_pfcp_node_t *current,
+        smf_sess_t *sess, bool match_ue_info, bool throttle)
+{
+    ogs_pfcp_node_t *first, *start, *node, *selected = NULL;
+    uint8_t reduction;
+
+    ogs_assert(current);
+    ogs_assert(sess);
+
+    first = ogs_list_first(&ogs_pfcp_self()->pfcp_peer_list);
+    ogs_assert(first);
+
+    start = ogs_list_next(current);
+    if (!start) start = first;
+
+    node = start;
+    do {
+        if (OGS_FSM_CHECK(&node->sm, smf_pfcp_state_associated) &&
+            (match_ue_info == false || compare_ue_info(node, sess) == true)) {
+            reduction = ogs_pfcp_node_overload_reduction(node);
+            if (throttle == false || reduction == 0 ||
+                (ogs_random32() % 100) >= reduction) {
+                if (!selected || ogs_pfcp_node_load_metric(node) <
+                        ogs_pfcp_node_load_metric(selected))
+                    selected = node;
+            }
+        }
+
+        node = ogs_list_next(node);
+        if (!node) node = first;
+    } while (node != start);
+
+    return selected;
+}
+
 static ogs_pfcp_node_t *selected_upf_node(
         ogs_pfcp_node_t *current, smf_sess_t *sess)
 {
-    ogs_pfcp_node_t *next, *node;
+    ogs_pfcp_node_t *node;
 
     ogs_assert(current);
     ogs_assert(sess);
 
-    /* continue search from current position */
-    next = ogs_list_next(current);
-    for (node = next; node; node = ogs_list_next(node)) {
-        if (OGS_FSM_CHECK(&node->sm, smf_pfcp_state_associated) &&
-            compare_ue_info(node, sess) == true) return node;
-    }
-    /* cyclic search from top to current position */
-    for (node = ogs_list_first(&ogs_pfcp_self()->pfcp_peer_list);
-            node != next; node = ogs_list_next(node)) {
-        if (OGS_FSM_CHECK(&node->sm, smf_pfcp_state_associated) &&
-            compare_ue_info(node, sess) == true) return node;
-    }
+    node = least_loaded_upf_node(current, sess, true, true);
+    if (node) return node;
+    /* every matching UPF was throttled, so overload is ignored */
+    node = least_loaded_upf_node(current, sess, true, false);
+    if (node) return node;
 
     if (ogs_global_conf()->parameter.no_pfcp_rr_select == 0) {
-        /* continue search from current position */
-        next = ogs_list_next(current);
-        for (node = next; node; node = ogs_list_next(node)) {
-            if (OGS_FSM_CHECK(&node->sm, smf_pfcp_state_associated))
-                return node;
-        }
-        /* cyclic search from top to current position */
-        for (node = ogs_list_first(&ogs_pfcp_self()->pfcp_peer_list);
-                node != next; node = ogs_list_next(node)) {
-            if (OGS_FSM_CHECK(&node->sm, smf_pfcp_state_associated))
-                return node;
-        }
+        node = least_loaded_upf_node(current, sess, false, true);
+        if (node) return node;
+        node = least_loaded_upf_node(current, sess, false, false);
+        if (node) return node;
     }
 
     ogs_error("No UPFs are PFCP associated that are suited to RR");
@@ -1198,7 +1230,11 @@ void smf_sess_select_upf(smf_sess_t *sess)
     ogs_pfcp_self()->pfcp_node =
         selected_upf_node(ogs_pfcp_self()->pfcp_node, sess);
     ogs_assert(ogs_pfcp_self()->pfcp_node);
+
+    if (sess->pfcp_node)
+        ogs_list_remove(&sess->pfcp_node->sess_list, &sess->pfcp_lnode);
     OGS_SETUP_PFCP_NODE(sess, ogs_pfcp_self()->pfcp_node);
+    ogs_list_add(&sess->pfcp_node->sess_list, &sess->pfcp_lnode);
     ogs_debug("UE using UPF on IP %s",
             ogs_sockaddr_to_string_static(
                 ogs_pfcp_self()->pfcp_node->addr_list));
@@ -1697,6 +1733,8 @@ void smf_sess_remove(smf_sess_t *sess)
             sess->ipv6 ? OGS_INET6_NTOP(&sess->ipv6->addr, buf2) : "");
 
     ogs_list_remove(&smf_ue->sess_list, sess);
+    if (sess->pfcp_node)
+        ogs_list_remove(&sess->pfcp_node->sess_list, &sess->pfcp_lnode);
 
     memset(&e, 0, sizeof(e));
     e.sess_id = sess->id;
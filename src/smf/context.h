@@ -506,6 +506,7 @@ typedef struct smf_sess_s {
 
     ogs_gtp_node_t  *gnode;
     ogs_pfcp_node_t *pfcp_node;
+    ogs_lnode_t     pfcp_lnode;     /* A node of pfcp_node->sess_list */
 
     ogs_pool_id_t smf_ue_id;
 
@@ -188,8 +188,16 @@ static void smf_main(void *data)
             ogs_fsm_dispatch(&smf_sm, e);
             ogs_event_free(e);
         }
+
+        smf_metrics_inst_by_ue_pool_update();
+
+        /* Send the PFCP messages and G-PDUs held during this iteration */
+        ogs_pfcp_flush();
+        ogs_gtpu_flush();
     }
 done:
+    ogs_pfcp_flush();
+    ogs_gtpu_flush();
 
     ogs_fsm_fini(&smf_sm, 0);
 }
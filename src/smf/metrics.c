@@ -493,6 +493,139 @@ int smf_metrics_free_inst_by_cause(ogs_metrics_inst_t **inst)
     return smf_metrics_free_inst(inst, _SMF_METR_BY_CAUSE_MAX);
 }
 
+/* BY UE POOL */
+const char *labels_ue_pool[] = {
+    "dnn",
+    "subnet"
+};
+
+#define SMF_METR_BY_UE_POOL_GAUGE_ENTRY(_id, _name, _desc) \
+    [_id] = { \
+        .type = OGS_METRICS_METRIC_TYPE_GAUGE, \
+        .name = _name, \
+        .description = _desc, \
+        .num_labels = OGS_ARRAY_SIZE(labels_ue_pool), \
+        .labels = labels_ue_pool, \
+    },
+#define SMF_METR_BY_UE_POOL_CTR_ENTRY(_id, _name, _desc) \
+    [_id] = { \
+        .type = OGS_METRICS_METRIC_TYPE_COUNTER, \
+        .name = _name, \
+        .description = _desc, \
+        .num_labels = OGS_ARRAY_SIZE(labels_ue_pool), \
+        .labels = labels_ue_pool, \
+    },
+ogs_metrics_spec_t *smf_metrics_spec_by_ue_pool[_SMF_METR_BY_UE_POOL_MAX];
+ogs_hash_t *metrics_hash_by_ue_pool = NULL;   /* hash table for UE pools */
+smf_metrics_spec_def_t smf_metrics_spec_def_by_ue_pool[_SMF_METR_BY_UE_POOL_MAX] = {
+/* Gauges: */
+SMF_METR_BY_UE_POOL_GAUGE_ENTRY(
+    SMF_METR_GAUGE_UE_POOL_SIZE,
+    "ue_pool_size",
+    "UE addresses in the pool")
+SMF_METR_BY_UE_POOL_GAUGE_ENTRY(
+    SMF_METR_GAUGE_UE_POOL_USED,
+    "ue_pool_used",
+    "UE addresses in use")
+/* Counters: */
+SMF_METR_BY_UE_POOL_CTR_ENTRY(
+    SMF_METR_CTR_UE_POOL_ALLOC,
+    "ue_pool_alloc",
+    "Dynamic UE addresses allocated")
+SMF_METR_BY_UE_POOL_CTR_ENTRY(
+    SMF_METR_CTR_UE_POOL_STATIC_ALLOC,
+    "ue_pool_static_alloc",
+    "Static UE addresses reserved")
+SMF_METR_BY_UE_POOL_CTR_ENTRY(
+    SMF_METR_CTR_UE_POOL_ALLOC_FAILED,
+    "ue_pool_alloc_failed",
+    "UE address requests with no address left")
+};
+void smf_metrics_init_by_ue_pool(void);
+typedef struct smf_metric_ue_pool_s {
+    ogs_pfcp_subnet_t   *subnet;    /* Hash key */
+    ogs_metrics_inst_t  *inst[_SMF_METR_BY_UE_POOL_MAX];
+
+    /* Subnet statistics already added to the counters */
+    uint64_t            alloc;
+    uint64_t            static_alloc;
+    uint64_t            failure;
+} smf_metric_ue_pool_t;
+
+void smf_metrics_init_by_ue_pool(void)
+{
+    metrics_hash_by_ue_pool = ogs_hash_make();
+    ogs_assert(metrics_hash_by_ue_pool);
+}
+
+static smf_metric_ue_pool_t *metrics_ue_pool_find(ogs_pfcp_subnet_t *subnet)
+{
+    smf_metric_ue_pool_t *ue_pool = NULL;
+    char addr[OGS_ADDRSTRLEN];
+    char prefix[OGS_ADDRSTRLEN+5];
+
+    ue_pool = ogs_hash_get(metrics_hash_by_ue_pool,
+            &subnet, sizeof(subnet));
+    if (ue_pool)
+        return ue_pool;
+
+    ue_pool = ogs_calloc(1, sizeof(*ue_pool));
+    ogs_assert(ue_pool);
+    ue_pool->subnet = subnet;
+
+    ogs_assert(inet_ntop(subnet->family,
+                subnet->sub.sub, addr, sizeof(addr)));
+    ogs_snprintf(prefix, sizeof(prefix), "%s/%d", addr, subnet->prefixlen);
+
+    smf_metrics_init_inst(ue_pool->inst, smf_metrics_spec_by_ue_pool,
+            _SMF_METR_BY_UE_POOL_MAX,
+            smf_metrics_spec_def_by_ue_pool->num_labels,
+            (const char *[]){ subnet->dnn, prefix });
+    ogs_metrics_inst_set(ue_pool->inst[SMF_METR_GAUGE_UE_POOL_SIZE],
+            ogs_bitmap_size(&subnet->bitmap) - subnet->stats.reserved);
+
+    ogs_hash_set(metrics_hash_by_ue_pool,
+            &ue_pool->subnet, sizeof(ue_pool->subnet), ue_pool);
+
+    return ue_pool;
+}
+
+void smf_metrics_inst_by_ue_pool_update(void)
+{
+    ogs_pfcp_subnet_t *subnet = NULL;
+    smf_metric_ue_pool_t *ue_pool = NULL;
+
+    ogs_list_for_each(&ogs_pfcp_self()->subnet_list, subnet) {
+        if (subnet->family == AF_UNSPEC ||
+            ogs_bitmap_size(&subnet->bitmap) == 0)
+            continue;
+
+        ue_pool = metrics_ue_pool_find(subnet);
+        ogs_assert(ue_pool);
+
+        ogs_metrics_inst_set(ue_pool->inst[SMF_METR_GAUGE_UE_POOL_USED],
+                ogs_bitmap_used(&subnet->bitmap) - subnet->stats.reserved);
+
+        if (subnet->stats.alloc != ue_pool->alloc) {
+            ogs_metrics_inst_add(ue_pool->inst[SMF_METR_CTR_UE_POOL_ALLOC],
+                    subnet->stats.alloc - ue_pool->alloc);
+            ue_pool->alloc = subnet->stats.alloc;
+        }
+        if (subnet->stats.static_alloc != ue_pool->static_alloc) {
+            ogs_metrics_inst_add(
+                    ue_pool->inst[SMF_METR_CTR_UE_POOL_STATIC_ALLOC],
+                    subnet->stats.static_alloc - ue_pool->static_alloc);
+            ue_pool->static_alloc = subnet->stats.static_alloc;
+        }
+        if (subnet->stats.failure != ue_pool->failure) {
+            ogs_metrics_inst_add(
+                    ue_pool->inst[SMF_METR_CTR_UE_POOL_ALLOC_FAILED],
+                    subnet->stats.failure - ue_pool->failure);
+            ue_pool->failure = subnet->stats.failure;
+        }
+    }
+}
+
 void smf_metrics_init(void)
 {
     ogs_metrics_context_t *ctx = ogs_metrics_self();
@@ -510,11 +643,14 @@ void smf_metrics_init(void)
             smf_metrics_spec_def_by_5qi, _SMF_METR_BY_5QI_MAX);
     smf_metrics_init_spec(ctx, smf_metrics_spec_by_cause,
             smf_metrics_spec_def_by_cause, _SMF_METR_BY_CAUSE_MAX);
+    smf_metrics_init_spec(ctx, smf_metrics_spec_by_ue_pool,
+            smf_metrics_spec_def_by_ue_pool, _SMF_METR_BY_UE_POOL_MAX);
 
     smf_metrics_init_inst_global();
     smf_metrics_init_by_slice();
     smf_metrics_init_by_5qi();
     smf_metrics_init_by_cause();
+    smf_metrics_init_by_ue_pool();
 }
 
 void smf_metrics_final(void)
@@ -566,6 +702,19 @@ void smf_metrics_final(void)
         }
         ogs_hash_destroy(metrics_hash_by_cause);
     }
+    if (metrics_hash_by_ue_pool) {
+        for (hi = ogs_hash_first(metrics_hash_by_ue_pool);
+                hi; hi = ogs_hash_next(hi)) {
+            smf_metric_ue_pool_t *ue_pool = ogs_hash_this_val(hi);
+
+            ogs_hash_set(metrics_hash_by_ue_pool,
+                    &ue_pool->subnet, sizeof(ue_pool->subnet), NULL);
+
+            /* The instances are free'd by ogs_metrics_context_final() */
+            ogs_free(ue_pool);
+        }
+        ogs_hash_destroy(metrics_hash_by_ue_pool);
+    }
 
     ogs_metrics_context_final();
 }
@@ -98,6 +98,19 @@ typedef enum smf_metric_type_by_cause_s {
 
 void smf_metrics_inst_by_cause_add(
     int cause, smf_metric_type_by_cause_t t, int val);
+/* BY UE POOL */
+typedef enum smf_metric_type_by_ue_pool_s {
+    SMF_METR_GAUGE_UE_POOL_SIZE = 0,
+    SMF_METR_GAUGE_UE_POOL_USED,
+    SMF_METR_CTR_UE_POOL_ALLOC,
+    SMF_METR_CTR_UE_POOL_STATIC_ALLOC,
+    SMF_METR_CTR_UE_POOL_ALLOC_FAILED,
+    _SMF_METR_BY_UE_POOL_MAX,
+} smf_metric_type_by_ue_pool_t;
+
+/* Copies the statistics of every UE pool subnet into the metrics */
+void smf_metrics_inst_by_ue_pool_update(void);
+
 void smf_metrics_init(void);
 void smf_metrics_final(void);
 
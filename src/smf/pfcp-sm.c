@@ -297,6 +297,11 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
         case OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE:
             if (!message->h.seid_presence) ogs_error("No SEID");
 
+            ogs_pfcp_cp_handle_load_control_information(node,
+                &message->pfcp_session_establishment_response.load_control_information);
+            ogs_pfcp_cp_handle_overload_control_information(node,
+                &message->pfcp_session_establishment_response.overload_control_information);
+
             if (!sess) {
                 ogs_gtp_xact_t *gtp_xact =
                     ogs_gtp_xact_find_by_id(xact->assoc_xact_id);
@@ -321,6 +326,11 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
         case OGS_PFCP_SESSION_MODIFICATION_RESPONSE_TYPE:
             if (!message->h.seid_presence) ogs_error("No SEID");
 
+            ogs_pfcp_cp_handle_load_control_information(node,
+                &message->pfcp_session_modification_response.load_control_information);
+            ogs_pfcp_cp_handle_overload_control_information(node,
+                &message->pfcp_session_modification_response.overload_control_information);
+
             if (xact->epc)
                 smf_epc_n4_handle_session_modification_response(
                     sess, xact, e->gtp2_message,
@@ -333,6 +343,11 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
         case OGS_PFCP_SESSION_DELETION_RESPONSE_TYPE:
             if (!message->h.seid_presence) ogs_error("No SEID");
 
+            ogs_pfcp_cp_handle_load_control_information(node,
+                &message->pfcp_session_deletion_response.load_control_information);
+            ogs_pfcp_cp_handle_overload_control_information(node,
+                &message->pfcp_session_deletion_response.overload_control_information);
+
             if (!sess) {
                 ogs_gtp_xact_t *gtp_xact =
                     ogs_gtp_xact_find_by_id(xact->assoc_xact_id);
@@ -357,6 +372,11 @@ void smf_pfcp_state_associated(ogs_fsm_t *s, smf_event_t *e)
         case OGS_PFCP_SESSION_REPORT_REQUEST_TYPE:
             if (!message->h.seid_presence) ogs_error("No SEID");
 
+            ogs_pfcp_cp_handle_load_control_information(node,
+                &message->pfcp_session_report_request.load_control_information);
+            ogs_pfcp_cp_handle_overload_control_information(node,
+                &message->pfcp_session_report_request.overload_control_information);
+
             if (!sess) {
                     ogs_error("No Session");
                     ogs_pfcp_send_error_message(xact, 0,
@@ -448,41 +468,39 @@ void smf_pfcp_state_exception(ogs_fsm_t *s, smf_event_t *e)
 static void pfcp_restoration(ogs_pfcp_node_t *node)
 {
     smf_ue_t *smf_ue = NULL;
+    smf_sess_t *sess = NULL;
 
     char buf1[OGS_ADDRSTRLEN];
     char buf2[OGS_ADDRSTRLEN];
 
-    ogs_list_for_each(&smf_self()->smf_ue_list, smf_ue) {
-        smf_sess_t *sess = NULL;
+    ogs_assert(node);
+
+    ogs_list_for_each_entry(&node->sess_list, sess, pfcp_lnode) {
+        ogs_assert(sess->pfcp_node == node);
+        smf_ue = smf_ue_find_by_id(sess->smf_ue_id);
         ogs_assert(smf_ue);
 
-        ogs_list_for_each(&smf_ue->sess_list, sess) {
-            ogs_assert(sess);
-
-            if (node == sess->pfcp_node) {
-                if (sess->epc) {
-                    ogs_info("UE IMSI[%s] APN[%s] IPv4[%s] IPv6[%s]",
-                        smf_ue->imsi_bcd, sess->session.name,
-                        sess->ipv4 ?
-                            OGS_INET_NTOP(&sess->ipv4->addr, buf1) : "",
-                        sess->ipv6 ?
-                            OGS_INET6_NTOP(&sess->ipv6->addr, buf2) : "");
-                    ogs_assert(OGS_OK ==
-                        smf_epc_pfcp_send_session_establishment_request(
-                            sess, OGS_INVALID_POOL_ID,
-                            OGS_PFCP_CREATE_RESTORATION_INDICATION));
-                } else {
-                    ogs_info("UE SUPI[%s] DNN[%s] IPv4[%s] IPv6[%s]",
-                        smf_ue->supi, sess->session.name,
-                        sess->ipv4 ?
-                            OGS_INET_NTOP(&sess->ipv4->addr, buf1) : "",
-                        sess->ipv6 ?
-                            OGS_INET6_NTOP(&sess->ipv6->addr, buf2) : "");
-                    ogs_assert(OGS_OK ==
-                            smf_5gc_pfcp_send_session_establishment_request(
-                                sess, OGS_PFCP_CREATE_RESTORATION_INDICATION));
-                }
-            }
+        if (sess->epc) {
+            ogs_info("UE IMSI[%s] APN[%s] IPv4[%s] IPv6[%s]",
+                smf_ue->imsi_bcd, sess->session.name,
+                sess->ipv4 ?
+                    OGS_INET_NTOP(&sess->ipv4->addr, buf1) : "",
+                sess->ipv6 ?
+                    OGS_INET6_NTOP(&sess->ipv6->addr, buf2) : "");
+            ogs_assert(OGS_OK ==
+                smf_epc_pfcp_send_session_establishment_request(
+                    sess, OGS_INVALID_POOL_ID,
+                    OGS_PFCP_CREATE_RESTORATION_INDICATION));
+        } else {
+            ogs_info("UE SUPI[%s] DNN[%s] IPv4[%s] IPv6[%s]",
+                smf_ue->supi, sess->session.name,
+                sess->ipv4 ?
+                    OGS_INET_NTOP(&sess->ipv4->addr, buf1) : "",
+                sess->ipv6 ?
+                    OGS_INET6_NTOP(&sess->ipv6->addr, buf2) : "");
+            ogs_assert(OGS_OK ==
+                    smf_5gc_pfcp_send_session_establishment_request(
+                        sess, OGS_PFCP_CREATE_RESTORATION_INDICATION));
         }
     }
 }
@@ -491,6 +509,7 @@ static void reselect_upf(ogs_pfcp_node_t *node)
 {
     int r;
     smf_ue_t *smf_ue = NULL;
+    smf_sess_t *sess = NULL, *next_sess = NULL;
     ogs_pfcp_node_t *iter = NULL;
 
     ogs_assert(node);
@@ -512,38 +531,36 @@ static void reselect_upf(ogs_pfcp_node_t *node)
         return;
     }
 
-    ogs_list_for_each(&smf_self()->smf_ue_list, smf_ue) {
-        smf_sess_t *sess = NULL, *next_sess = NULL;
-
-        ogs_list_for_each_safe(&smf_ue->sess_list, next_sess, sess) {
+    ogs_list_for_each_entry_safe(
+            &node->sess_list, next_sess, sess, pfcp_lnode) {
+        ogs_assert(sess->pfcp_node == node);
+        smf_ue = smf_ue_find_by_id(sess->smf_ue_id);
+        ogs_assert(smf_ue);
 
-            if (node == sess->pfcp_node) {
-                if (sess->epc) {
-                    ogs_error("[%s:%s] EPC restoration is not implemented",
-                            smf_ue->imsi_bcd, sess->session.name);
-                } else {
-                    if (PCF_SM_POLICY_ASSOCIATED(sess)) {
-                        smf_npcf_smpolicycontrol_param_t param;
-
-                        ogs_info("[%s:%d] SMF-initiated Deletion",
-                                smf_ue->supi, sess->psi);
-                        ogs_assert(sess->sm_context_ref);
-                        memset(&param, 0, sizeof(param));
-                        r = smf_sbi_discover_and_send(
-                                OGS_SBI_SERVICE_TYPE_NPCF_SMPOLICYCONTROL, NULL,
-                                smf_npcf_smpolicycontrol_build_delete,
-                                sess, NULL,
-                                OGS_PFCP_DELETE_TRIGGER_SMF_INITIATED,
-                                &param);
-                        ogs_expect(r == OGS_OK);
-                        ogs_assert(r != OGS_ERROR);
-                    } else {
-                        ogs_error("[%s:%d] No PolicyAssociationId. "
-                                "Forcibly remove SESSION",
-                                smf_ue->supi, sess->psi);
-                        SMF_SESS_CLEAR(sess);
-                    }
-                }
+        if (sess->epc) {
+            ogs_error("[%s:%s] EPC restoration is not implemented",
+                    smf_ue->imsi_bcd, sess->session.name);
+        } else {
+            if (PCF_SM_POLICY_ASSOCIATED(sess)) {
+                smf_npcf_smpolicycontrol_param_t param;
+
+                ogs_info("[%s:%d] SMF-initiated Deletion",
+                        smf_ue->supi, sess->psi);
+                ogs_assert(sess->sm_context_ref);
+                memset(&param, 0, sizeof(param));
+                r = smf_sbi_discover_and_send(
+                        OGS_SBI_SERVICE_TYPE_NPCF_SMPOLICYCONTROL, NULL,
+                        smf_npcf_smpolicycontrol_build_delete,
+                        sess, NULL,
+                        OGS_PFCP_DELETE_TRIGGER_SMF_INITIATED,
+                        &param);
+                ogs_expect(r == OGS_OK);
+                ogs_assert(r != OGS_ERROR);
+            } else {
+                ogs_error("[%s:%d] No PolicyAssociationId. "
+                        "Forcibly remove SESSION",
+                        smf_ue->supi, sess->psi);
+                SMF_SESS_CLEAR(sess);
             }
         }
     }
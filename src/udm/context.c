@@ -57,6 +57,9 @@ void udm_context_init(void)
     self.sdm_subscription_id_hash = ogs_hash_make();
     ogs_assert(self.sdm_subscription_id_hash);
 
+    self.suci.prefetch_hash = ogs_hash_make();
+    ogs_assert(self.suci.prefetch_hash);
+
     context_initialized = 1;
 }
 
@@ -66,6 +69,9 @@ void udm_context_final(void)
 
     udm_ue_remove_all();
 
+    if (self.cache.db)
+        ogs_sbi_cache_destroy(self.cache.db);
+
     ogs_assert(self.suci_hash);
     ogs_hash_destroy(self.suci_hash);
     ogs_assert(self.supi_hash);
@@ -73,6 +79,10 @@ void udm_context_final(void)
     ogs_assert(self.sdm_subscription_id_hash);
     ogs_hash_destroy(self.sdm_subscription_id_hash);
 
+    udm_suci_prefetch_flush();
+    ogs_assert(self.suci.prefetch_hash);
+    ogs_hash_destroy(self.suci.prefetch_hash);
+
     ogs_pool_final(&udm_ue_pool);
     ogs_pool_final(&udm_sess_pool);
     ogs_pool_final(&udm_sdm_subscription_pool);
@@ -85,13 +95,33 @@ udm_context_t *udm_self(void)
     return &self;
 }
 
+static void cache_data_free(void *data)
+{
+    ogs_sbi_message_t *message = data;
+
+    ogs_assert(message);
+
+    ogs_sbi_message_free(message);
+    ogs_free(message);
+}
+
 static int udm_context_prepare(void)
 {
+#define UDM_CACHE_DEFAULT_TTL 30 /* 30 seconds */
+    self.cache.ttl = ogs_time_from_sec(UDM_CACHE_DEFAULT_TTL);
+
     return OGS_OK;
 }
 
 static int udm_context_validation(void)
 {
+    if (self.suci.workers < 0 ||
+        self.suci.workers > OGS_SBI_SUCI_MAX_NUM_OF_WORKER) {
+        ogs_error("Invalid udm.suci.workers [%d] in '%s'",
+                self.suci.workers, ogs_app()->file);
+        return OGS_ERROR;
+    }
+
     return OGS_OK;
 }
 
@@ -134,6 +164,33 @@ int udm_context_parse_config(void)
                 } else if (!strcmp(udm_key, "hnet")) {
                     rv = ogs_sbi_context_parse_hnet_config(&udm_iter);
                     if (rv != OGS_OK) return rv;
+                } else if (!strcmp(udm_key, "cache")) {
+                    ogs_yaml_iter_t cache_iter;
+                    ogs_yaml_iter_recurse(&udm_iter, &cache_iter);
+                    while (ogs_yaml_iter_next(&cache_iter)) {
+                        const char *cache_key = ogs_yaml_iter_key(&cache_iter);
+                        ogs_assert(cache_key);
+                        if (!strcmp(cache_key, "size")) {
+                            const char *v = ogs_yaml_iter_value(&cache_iter);
+                            if (v) self.cache.size = atoi(v);
+                        } else if (!strcmp(cache_key, "ttl")) {
+                            const char *v = ogs_yaml_iter_value(&cache_iter);
+                            if (v) self.cache.ttl = ogs_time_from_sec(atoi(v));
+                        } else
+                            ogs_warn("unknown key `%s`", cache_key);
+                    }
+                } else if (!strcmp(udm_key, "suci")) {
+                    ogs_yaml_iter_t suci_iter;
+                    ogs_yaml_iter_recurse(&udm_iter, &suci_iter);
+                    while (ogs_yaml_iter_next(&suci_iter)) {
+                        const char *suci_key = ogs_yaml_iter_key(&suci_iter);
+                        ogs_assert(suci_key);
+                        if (!strcmp(suci_key, "workers")) {
+                            const char *v = ogs_yaml_iter_value(&suci_iter);
+                            if (v) self.suci.workers = atoi(v);
+                        } else
+                            ogs_warn("unknown key `%s`", suci_key);
+                    }
                 } else
                     ogs_warn("unknown key `%s`", udm_key);
             }
@@ -143,9 +200,37 @@ int udm_context_parse_config(void)
     rv = udm_context_validation();
     if (rv != OGS_OK) return rv;
 
+    if (self.cache.size > 0)
+        self.cache.db = ogs_sbi_cache_create(
+                self.cache.size, self.cache.ttl, cache_data_free);
+
     return OGS_OK;
 }
 
+typedef struct suci_prefetch_s {
+    char *suci;
+    char *supi;
+} suci_prefetch_t;
+
+static char *suci_prefetch_take(char *suci)
+{
+    suci_prefetch_t *prefetch = NULL;
+    char *supi = NULL;
+
+    prefetch = ogs_hash_get(self.suci.prefetch_hash, suci, strlen(suci));
+    if (!prefetch)
+        return NULL;
+
+    ogs_hash_set(self.suci.prefetch_hash,
+            prefetch->suci, strlen(prefetch->suci), NULL);
+
+    supi = prefetch->supi;
+    ogs_free(prefetch->suci);
+    ogs_free(prefetch);
+
+    return supi;
+}
+
 udm_ue_t *udm_ue_add(char *suci)
 {
     udm_event_t e;
@@ -178,7 +263,9 @@ udm_ue_t *udm_ue_add(char *suci)
         return NULL;
     }
 
-    udm_ue->supi = ogs_supi_from_supi_or_suci(udm_ue->suci);
+    udm_ue->supi = suci_prefetch_take(udm_ue->suci);
+    if (!udm_ue->supi)
+        udm_ue->supi = ogs_supi_from_supi_or_suci(udm_ue->suci);
     if (!udm_ue->supi) {
         ogs_error("No memory for udm_ue->supi [%s]", suci);
         ogs_free(udm_ue->suci);
@@ -439,9 +526,229 @@ udm_sdm_subscription_t *udm_sdm_subscription_find_by_id(char *id)
             id, strlen(id));
 }
 
+/*
+ * The UDR does not notify provisioned data changes made through
+ * the WebUI, so an entry is only trusted for the configured TTL.
+ */
+void udm_cache_add(ogs_sbi_request_t *request, ogs_sbi_message_t *message)
+{
+    ogs_sbi_message_t *cached = NULL;
+    OpenAPI_lnode_t *node = NULL;
+    char *key = NULL;
+
+    ogs_assert(request);
+    ogs_assert(message);
+
+    if (!self.cache.db)
+        return;
+
+    if (!request->h.method ||
+        strcmp(request->h.method, OGS_SBI_HTTP_METHOD_GET) != 0)
+        return;
+    if (message->res_status != OGS_SBI_HTTP_STATUS_OK)
+        return;
+    if (!message->h.resource.component[3] ||
+        strcmp(message->h.resource.component[3],
+            OGS_SBI_RESOURCE_NAME_PROVISIONED_DATA) != 0)
+        return;
+
+    cached = ogs_calloc(1, sizeof(*cached));
+    ogs_assert(cached);
+
+    SWITCH(message->h.resource.component[4])
+    CASE(OGS_SBI_RESOURCE_NAME_AM_DATA)
+        if (!message->AccessAndMobilitySubscriptionData)
+            break;
+        cached->AccessAndMobilitySubscriptionData =
+            OpenAPI_access_and_mobility_subscription_data_copy(NULL,
+                    message->AccessAndMobilitySubscriptionData);
+        break;
+
+    CASE(OGS_SBI_RESOURCE_NAME_SMF_SELECTION_SUBSCRIPTION_DATA)
+        if (!message->SmfSelectionSubscriptionData)
+            break;
+        cached->SmfSelectionSubscriptionData =
+            OpenAPI_smf_selection_subscription_data_copy(NULL,
+                    message->SmfSelectionSubscriptionData);
+        break;
+
+    CASE(OGS_SBI_RESOURCE_NAME_SM_DATA)
+        if (!message->SessionManagementSubscriptionDataList ||
+            message->SessionManagementSubscriptionDataList->count == 0)
+            break;
+        cached->SessionManagementSubscriptionDataList = OpenAPI_list_create();
+        ogs_assert(cached->SessionManagementSubscriptionDataList);
+        OpenAPI_list_for_each(
+                message->SessionManagementSubscriptionDataList, node) {
+            OpenAPI_session_management_subscription_data_t *item = NULL;
+
+            item = OpenAPI_session_management_subscription_data_copy(
+                    NULL, node->data);
+            if (!item) {
+                ogs_error("OpenAPI_session_management_subscription_data_copy() "
+                        "failed");
+                continue;
+            }
+            OpenAPI_list_add(cached->SessionManagementSubscriptionDataList,
+                    item);
+        }
+        break;
+
+    DEFAULT
+    END
+
+    if (!cached->AccessAndMobilitySubscriptionData &&
+        !cached->SmfSelectionSubscriptionData &&
+        !cached->SessionManagementSubscriptionDataList) {
+        cache_data_free(cached);
+        return;
+    }
+
+    cached->res_status = OGS_SBI_HTTP_STATUS_OK;
+
+    key = ogs_sbi_cache_key(request);
+    ogs_assert(key);
+    ogs_sbi_cache_set(self.cache.db, key, cached);
+    ogs_free(key);
+}
+
+bool udm_cache_find(ogs_sbi_request_t *request, ogs_sbi_message_t *message)
+{
+    ogs_sbi_message_t *cached = NULL;
+    char *key = NULL;
+
+    ogs_assert(request);
+    ogs_assert(message);
+
+    if (!self.cache.db)
+        return false;
+
+    key = ogs_sbi_cache_key(request);
+    ogs_assert(key);
+    cached = ogs_sbi_cache_get(self.cache.db, key);
+    ogs_free(key);
+
+    if (!cached)
+        return false;
+
+    /* Looks as if the UDR had just responded to the request */
+    memcpy(message, cached, sizeof(*message));
+    message->h.method = request->h.method;
+    message->h.service.name = request->h.service.name;
+    message->h.api.version = request->h.api.version;
+    memcpy(&message->h.resource, &request->h.resource,
+            sizeof(message->h.resource));
+
+    return true;
+}
+
 int get_ue_load(void)
 {
     return (((ogs_pool_size(&udm_ue_pool) -
             ogs_pool_avail(&udm_ue_pool)) * 100) /
             ogs_pool_size(&udm_ue_pool));
 }
+
+/*
+ * ECIES de-concealment dominates udm_ue_add() for a SUCI of Profile A/B.
+ * Before the events popped from the queue are dispatched, collect the
+ * SUCIs of the requests without a UE context yet and de-conceal them
+ * together on the SUCI workers. udm_ue_add() then takes the SUPI from
+ * the prefetch hash, and udm_suci_prefetch_flush() drops what is left
+ * once the events have been dispatched.
+ */
+void udm_suci_prefetch(udm_event_t **events, int num)
+{
+    char *suci[UDM_MAX_NUM_OF_EVENT_BATCH];
+    char *supi[UDM_MAX_NUM_OF_EVENT_BATCH];
+    suci_prefetch_t *prefetch = NULL;
+    int i, n = 0;
+
+    ogs_assert(events);
+    ogs_assert(num <= UDM_MAX_NUM_OF_EVENT_BATCH);
+
+    if (self.suci.workers == 0)
+        return;
+
+    for (i = 0; i < num; i++) {
+        udm_event_t *e = events[i];
+        ogs_sbi_request_t *request = NULL;
+        char *p = NULL;
+        size_t len;
+
+        ogs_assert(e);
+        if (e->h.id != OGS_EVENT_SBI_SERVER)
+            continue;
+
+        request = e->h.sbi.request;
+        if (!request || !request->h.uri)
+            continue;
+
+        p = strstr(request->h.uri, "/suci-");
+        if (!p)
+            continue;
+
+        p++;
+        len = strcspn(p, "/?");
+
+        suci[n] = ogs_strndup(p, len);
+        ogs_assert(suci[n]);
+
+        if (udm_ue_find_by_suci(suci[n]) ||
+            ogs_hash_get(self.suci.prefetch_hash, suci[n], len)) {
+            ogs_free(suci[n]);
+            continue;
+        }
+
+        /* Mark it so that the same SUCI is not collected twice */
+        ogs_hash_set(self.suci.prefetch_hash, suci[n], len, suci[n]);
+        n++;
+    }
+
+    for (i = 0; i < n; i++)
+        ogs_hash_set(self.suci.prefetch_hash, suci[i], strlen(suci[i]), NULL);
+
+    if (n < 2) {
+        /* Nothing to share with the workers */
+        for (i = 0; i < n; i++)
+            ogs_free(suci[i]);
+        return;
+    }
+
+    ogs_supi_from_suci_batch(suci, supi, n);
+
+    for (i = 0; i < n; i++) {
+        if (!supi[i]) {
+            /* udm_ue_add() tries again and reports the error */
+            ogs_free(suci[i]);
+            continue;
+        }
+
+        prefetch = ogs_calloc(1, sizeof(*prefetch));
+        ogs_assert(prefetch);
+        prefetch->suci = suci[i];
+        prefetch->supi = supi[i];
+
+        ogs_hash_set(self.suci.prefetch_hash,
+                prefetch->suci, strlen(prefetch->suci), prefetch);
+    }
+}
+
+void udm_suci_prefetch_flush(void)
+{
+    ogs_hash_index_t *hi = NULL;
+    suci_prefetch_t *prefetch = NULL;
+
+    for (hi = ogs_hash_first(self.suci.prefetch_hash);
+            hi; hi = ogs_hash_next(hi)) {
+        prefetch = ogs_hash_this_val(hi);
+        ogs_assert(prefetch);
+
+        ogs_hash_set(self.suci.prefetch_hash,
+                prefetch->suci, strlen(prefetch->suci), NULL);
+
+        ogs_free(prefetch->suci);
+        ogs_free(prefetch->supi);
+        ogs_free(prefetch);
+    }
+}
@@ -35,6 +35,8 @@ extern int __udm_log_domain;
 #undef OGS_LOG_DOMAIN
 #define OGS_LOG_DOMAIN __udm_log_domain
 
+#define UDM_MAX_NUM_OF_EVENT_BATCH 64
+
 typedef struct udm_context_s {
     ogs_list_t      udm_ue_list;
     ogs_list_t      sdm_subscription_list;
@@ -42,6 +44,18 @@ typedef struct udm_context_s {
     ogs_hash_t      *supi_hash;
     ogs_hash_t      *sdm_subscription_id_hash;
 
+    /* Provisioned data from the UDR, see udm_cache_add() */
+    struct {
+        int         size;       /* 0 disables the cache */
+        ogs_time_t  ttl;
+        ogs_sbi_cache_t *db;
+    } cache;
+
+    /* SUCI de-concealed ahead of udm_ue_add(), see udm_suci_prefetch() */
+    struct {
+        int         workers;    /* 0 de-conceals one SUCI at a time */
+        ogs_hash_t  *prefetch_hash;
+    } suci;
 } udm_context_t;
 
 struct udm_ue_s {
@@ -128,6 +142,12 @@ void udm_sdm_subscription_remove(udm_sdm_subscription_t *subscription);
 void udm_sdm_subscription_remove_all(udm_ue_t *udm_ue);
 udm_sdm_subscription_t *udm_sdm_subscription_find_by_id(char *id);
 
+void udm_cache_add(ogs_sbi_request_t *request, ogs_sbi_message_t *message);
+bool udm_cache_find(ogs_sbi_request_t *request, ogs_sbi_message_t *message);
+
+void udm_suci_prefetch(udm_event_t **events, int num);
+void udm_suci_prefetch_flush(void);
+
 int get_ue_load(void);
 
 #ifdef __cplusplus
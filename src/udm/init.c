@@ -44,6 +44,9 @@ int udm_initialize(void)
     rv = udm_context_parse_config();
     if (rv != OGS_OK) return rv;
 
+    rv = ogs_sbi_suci_init(udm_self()->suci.workers);
+    if (rv != OGS_OK) return rv;
+
     rv = udm_sbi_open();
     if (rv != OGS_OK) return rv;
 
@@ -90,6 +93,8 @@ void udm_terminate(void)
 
     udm_sbi_close();
 
+    ogs_sbi_suci_final();
+
     udm_context_final();
     ogs_sbi_context_final();
 }
@@ -119,20 +124,46 @@ static void udm_main(void *data)
         ogs_timer_mgr_expire(ogs_app()->timer_mgr);
 
         for ( ;; ) {
-            udm_event_t *e = NULL;
-
-            rv = ogs_queue_trypop(ogs_app()->queue, (void**)&e);
-            ogs_assert(rv != OGS_ERROR);
-
-            if (rv == OGS_DONE)
+            udm_event_t *e[UDM_MAX_NUM_OF_EVENT_BATCH];
+            bool terminated = false, drained = false;
+            int i, num = 0;
+
+            /*
+             * Pop the pending events together so that the SUCIs they
+             * carry can be de-concealed in a single batch.
+             */
+            while (num < UDM_MAX_NUM_OF_EVENT_BATCH) {
+                rv = ogs_queue_trypop(ogs_app()->queue, (void**)&e[num]);
+                ogs_assert(rv != OGS_ERROR);
+
+                if (rv == OGS_DONE) {
+                    terminated = true;
+                    break;
+                }
+
+                if (rv == OGS_RETRY) {
+                    drained = true;
+                    break;
+                }
+
+                ogs_assert(e[num]);
+                num++;
+            }
+
+            udm_suci_prefetch(e, num);
+
+            for (i = 0; i < num; i++) {
+                ogs_fsm_dispatch(&udm_sm, e[i]);
+                ogs_event_free(e[i]);
+            }
+
+            udm_suci_prefetch_flush();
+
+            if (terminated)
                 goto done;
 
-            if (rv == OGS_RETRY)
+            if (drained)
                 break;
-
-            ogs_assert(e);
-            ogs_fsm_dispatch(&udm_sm, e);
-            ogs_event_free(e);
         }
     }
 done:
@@ -466,6 +466,9 @@ void udm_state_operational(ogs_fsm_t *s, udm_event_t *e)
 
                     e->h.sbi.state = sbi_xact->state;
 
+                    if (sbi_xact->request)
+                        udm_cache_add(sbi_xact->request, &message);
+
                     ogs_sbi_xact_remove(sbi_xact);
 
                     udm_ue = udm_ue_find_by_id(udm_ue_id);
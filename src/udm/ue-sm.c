@@ -33,6 +33,30 @@ void udm_ue_state_final(ogs_fsm_t *s, udm_event_t *e)
 {
 }
 
+static bool handle_cached_provisioned(udm_ue_t *udm_ue,
+        ogs_sbi_stream_t *stream, int state, ogs_sbi_message_t *message)
+{
+    ogs_sbi_request_t *request = NULL;
+    ogs_sbi_message_t recvmsg;
+    bool found;
+
+    if (!udm_self()->cache.db)
+        return false;
+
+    request = udm_nudr_dr_build_query_subscription_provisioned(
+            udm_ue, message);
+    ogs_assert(request);
+
+    found = udm_cache_find(request, &recvmsg);
+    if (found)
+        udm_nudr_dr_handle_subscription_provisioned(
+                udm_ue, stream, state, &recvmsg);
+
+    ogs_sbi_request_free(request);
+
+    return found;
+}
+
 void udm_ue_state_operational(ogs_fsm_t *s, udm_event_t *e)
 {
     udm_ue_t *udm_ue = NULL;
@@ -193,6 +217,10 @@ void udm_ue_state_operational(ogs_fsm_t *s, udm_event_t *e)
                 CASE(OGS_SBI_RESOURCE_NAME_AM_DATA)
                 CASE(OGS_SBI_RESOURCE_NAME_SMF_SELECT_DATA)
                 CASE(OGS_SBI_RESOURCE_NAME_SM_DATA)
+                    if (handle_cached_provisioned(
+                            udm_ue, stream, UDM_SBI_NO_STATE, message))
+                        break;
+
                     r = udm_ue_sbi_discover_and_send(
                             OGS_SBI_SERVICE_TYPE_NUDR_DR, NULL,
                             udm_nudr_dr_build_query_subscription_provisioned,
@@ -202,6 +230,10 @@ void udm_ue_state_operational(ogs_fsm_t *s, udm_event_t *e)
                     break;
 
                 CASE(OGS_SBI_RESOURCE_NAME_NSSAI)
+                    if (handle_cached_provisioned(udm_ue, stream,
+                            UDM_SBI_UE_PROVISIONED_NSSAI_ONLY, message))
+                        break;
+
                     r = udm_ue_sbi_discover_and_send(
                             OGS_SBI_SERVICE_TYPE_NUDR_DR, NULL,
                             udm_nudr_dr_build_query_subscription_provisioned,
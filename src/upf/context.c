@@ -19,6 +19,7 @@
 
 #include "context.h"
 #include "pfcp-path.h"
+#include "store.h"
 
 static upf_context_t self;
 
@@ -26,6 +27,7 @@ int __upf_log_domain;
 
 static OGS_POOL(upf_sess_pool, upf_sess_t);
 static OGS_POOL(upf_n4_seid_pool, ogs_pool_id_t);
+static ogs_pool_id_t *seid_random_to_index;
 
 static int context_initialized = 0;
 
@@ -33,6 +35,8 @@ static void upf_sess_urr_acc_remove_all(upf_sess_t *sess);
 
 void upf_context_init(void)
 {
+    int i;
+
     ogs_assert(context_initialized == 0);
 
     /* Initialize UPF context */
@@ -53,6 +57,12 @@ void upf_context_init(void)
     ogs_pool_init(&upf_n4_seid_pool, ogs_app()->pool.sess);
     ogs_pool_random_id_generate(&upf_n4_seid_pool);
 
+    seid_random_to_index = ogs_calloc(
+            sizeof(ogs_pool_id_t), ogs_pool_size(&upf_n4_seid_pool)+1);
+    ogs_assert(seid_random_to_index);
+    for (i = 0; i < ogs_pool_size(&upf_n4_seid_pool); i++)
+        seid_random_to_index[upf_n4_seid_pool.array[i]] = i;
+
     self.upf_n4_seid_hash = ogs_hash_make();
     ogs_assert(self.upf_n4_seid_hash);
     self.smf_n4_seid_hash = ogs_hash_make();
@@ -98,6 +108,7 @@ void upf_context_final(void)
 
     ogs_pool_final(&upf_sess_pool);
     ogs_pool_final(&upf_n4_seid_pool);
+    ogs_free(seid_random_to_index);
 
     context_initialized = 0;
 }
@@ -159,6 +170,8 @@ int upf_context_parse_config(void)
                     /* handle config in pfcp library */
                 } else if (!strcmp(upf_key, "metrics")) {
                     /* handle config in metrics library */
+                } else if (!strcmp(upf_key, "store")) {
+                    self.store = ogs_yaml_iter_value(&upf_iter);
                 } else
                     ogs_warn("unknown key `%s`", upf_key);
             }
@@ -212,10 +225,64 @@ upf_sess_t *upf_sess_add(ogs_pfcp_f_seid_t *cp_f_seid)
     return sess;
 }
 
+/*
+ * Re-create a session kept in the session store with the UPF-N4-SEID
+ * the SMF already knows. The SEID pool holds a random permutation, so
+ * the stored value is swapped into the node that was just allocated.
+ */
+upf_sess_t *upf_sess_restore(
+        ogs_pfcp_f_seid_t *cp_f_seid, uint64_t upf_n4_seid)
+{
+    upf_sess_t *sess = NULL;
+    ogs_pool_id_t *node = NULL;
+    int i, j;
+
+    ogs_assert(cp_f_seid);
+
+    if (upf_n4_seid == 0 ||
+        upf_n4_seid > ogs_pool_size(&upf_n4_seid_pool)) {
+        ogs_error("Invalid UPF-N4-SEID [0x%llx]",
+                (unsigned long long)upf_n4_seid);
+        return NULL;
+    }
+    if (upf_sess_find_by_upf_n4_seid(upf_n4_seid)) {
+        ogs_error("UPF-N4-SEID [0x%llx] already in use",
+                (unsigned long long)upf_n4_seid);
+        return NULL;
+    }
+    if (upf_sess_find_by_smf_n4_f_seid(cp_f_seid)) {
+        ogs_error("SMF-N4-SEID [0x%llx] already in use",
+                (unsigned long long)cp_f_seid->seid);
+        return NULL;
+    }
+
+    sess = upf_sess_add(cp_f_seid);
+    ogs_assert(sess);
+
+    ogs_hash_set(self.upf_n4_seid_hash, &sess->upf_n4_seid,
+            sizeof(sess->upf_n4_seid), NULL);
+
+    node = sess->upf_n4_seid_node;
+    i = seid_random_to_index[upf_n4_seid];
+    j = node - upf_n4_seid_pool.array;
+
+    upf_n4_seid_pool.array[i] = *node;
+    seid_random_to_index[*node] = i;
+    *node = upf_n4_seid;
+    seid_random_to_index[upf_n4_seid] = j;
+
+    sess->upf_n4_seid = upf_n4_seid;
+    ogs_hash_set(self.upf_n4_seid_hash, &sess->upf_n4_seid,
+            sizeof(sess->upf_n4_seid), sess);
+
+    return sess;
+}
+
 int upf_sess_remove(upf_sess_t *sess)
 {
     ogs_assert(sess);
 
+    upf_store_remove(sess);
     upf_sess_urr_acc_remove_all(sess);
 
     ogs_list_remove(&self.sess_list, sess);
@@ -358,6 +425,22 @@ upf_sess_t *upf_sess_find_by_id(ogs_pool_id_t id)
     return ogs_pool_find_by_id(&upf_sess_pool, id);
 }
 
+int upf_sess_index(upf_sess_t *sess)
+{
+    ogs_assert(sess);
+    return ogs_pool_index(&upf_sess_pool, sess);
+}
+
+uint8_t upf_sess_load_metric(void)
+{
+    int size = ogs_pool_size(&upf_sess_pool);
+
+    if (size <= 0)
+        return 0;
+
+    return (size - ogs_pool_avail(&upf_sess_pool)) * 100 / size;
+}
+
 upf_sess_t *upf_sess_add_by_message(ogs_pfcp_message_t *message)
 {
     upf_sess_t *sess = NULL;
@@ -680,43 +763,92 @@ uint8_t upf_sess_set_ue_ipv6_framed_routes(upf_sess_t *sess,
     return cause_value;
 }
 
-void upf_sess_urr_acc_add(upf_sess_t *sess, ogs_pfcp_urr_t *urr, size_t size, bool is_uplink)
+static bool upf_sess_urr_acc_volume_reached(
+        upf_sess_urr_acc_t *urr_acc, ogs_pfcp_urr_t *urr)
+{
+    uint64_t vol = urr_acc->total_octets - urr_acc->last_report.total_octets;
+
+    return (urr->rep_triggers.volume_quota && urr->vol_quota.tovol &&
+            vol >= urr->vol_quota.total_volume) ||
+           (urr->rep_triggers.volume_threshold && urr->vol_threshold.tovol &&
+            vol >= urr->vol_threshold.total_volume);
+}
+
+/* Precompute the byte mark so that the per-packet path is a single compare.
+ * Must be called whenever last_report or the URR volume triggers change. */
+void upf_sess_urr_acc_volume_check_setup(upf_sess_t *sess, ogs_pfcp_urr_t *urr)
 {
     upf_sess_urr_acc_t *urr_acc = NULL;
-    uint64_t vol;
+    uint64_t limit = UINT64_MAX;
 
     ogs_assert(urr->id > 0 && urr->id <= OGS_MAX_NUM_OF_URR);
     urr_acc = &sess->urr_acc[urr->id-1];
 
-    /* Increment total & ul octets + pkts */
-    urr_acc->total_octets += size;
-    urr_acc->total_pkts++;
-    if (is_uplink) {
-        urr_acc->ul_octets += size;
-        urr_acc->ul_pkts++;
-    } else {
-        urr_acc->dl_octets += size;
-        urr_acc->dl_pkts++;
-    }
+    if (urr->rep_triggers.volume_quota && urr->vol_quota.tovol)
+        limit = ogs_min(limit, urr->vol_quota.total_volume);
+    if (urr->rep_triggers.volume_threshold && urr->vol_threshold.tovol)
+        limit = ogs_min(limit, urr->vol_threshold.total_volume);
 
-    urr_acc->time_of_last_packet = ogs_time_now();
-    if (urr_acc->time_of_first_packet == 0)
-        urr_acc->time_of_first_packet = urr_acc->time_of_last_packet;
+    if (limit > UINT64_MAX - urr_acc->last_report.total_octets)
+        urr_acc->next_volume_check = UINT64_MAX;
+    else
+        urr_acc->next_volume_check = urr_acc->last_report.total_octets + limit;
+}
 
-    /* generate report if volume threshold/quota is reached */
-    vol = urr_acc->total_octets - urr_acc->last_report.total_octets;
-    if ((urr->rep_triggers.volume_quota && urr->vol_quota.tovol && vol >= urr->vol_quota.total_volume) ||
-        (urr->rep_triggers.volume_threshold && urr->vol_threshold.tovol && vol >= urr->vol_threshold.total_volume)) {
-        ogs_pfcp_user_plane_report_t report;
-        memset(&report, 0, sizeof(report));
-        upf_sess_urr_acc_fill_usage_report(sess, urr, &report, 0);
-        report.num_of_usage_report = 1;
-        upf_sess_urr_acc_snapshot(sess, urr);
+void upf_sess_urr_acc_add(upf_sess_t *sess, ogs_pfcp_pdr_t *pdr, size_t size, bool is_uplink)
+{
+    upf_sess_urr_acc_t *urr_acc = NULL;
+    ogs_pfcp_urr_t *urr = NULL;
+    ogs_time_t now;
+    int i;
 
-        ogs_assert(OGS_OK ==
-            upf_pfcp_send_session_report_request(sess, &report));
-        /* Start new report period/iteration: */
-        upf_sess_urr_acc_timers_setup(sess, urr);
+    ogs_assert(pdr);
+
+    if (!pdr->num_of_urr)
+        return;
+
+    /* One clock read per packet, shared by every URR of the PDR */
+    now = ogs_time_now();
+
+    for (i = 0; i < pdr->num_of_urr; i++) {
+        urr = pdr->urr[i];
+        ogs_assert(urr);
+        ogs_assert(urr->id > 0 && urr->id <= OGS_MAX_NUM_OF_URR);
+        urr_acc = &sess->urr_acc[urr->id-1];
+
+        /* Increment total & ul octets + pkts */
+        urr_acc->total_octets += size;
+        urr_acc->total_pkts++;
+        if (is_uplink) {
+            urr_acc->ul_octets += size;
+            urr_acc->ul_pkts++;
+        } else {
+            urr_acc->dl_octets += size;
+            urr_acc->dl_pkts++;
+        }
+
+        urr_acc->time_of_last_packet = now;
+        if (urr_acc->time_of_first_packet == 0)
+            urr_acc->time_of_first_packet = now;
+
+        if (urr_acc->total_octets < urr_acc->next_volume_check)
+            continue;
+
+        /* generate report if volume threshold/quota is reached */
+        if (upf_sess_urr_acc_volume_reached(urr_acc, urr)) {
+            ogs_pfcp_user_plane_report_t report;
+            memset(&report, 0, sizeof(report));
+            upf_sess_urr_acc_fill_usage_report(sess, urr, &report, 0);
+            report.num_of_usage_report = 1;
+            upf_sess_urr_acc_snapshot(sess, urr);
+
+            ogs_assert(OGS_OK ==
+                upf_pfcp_send_session_report_request(sess, &report));
+            /* Start new report period/iteration: */
+            upf_sess_urr_acc_timers_setup(sess, urr);
+        } else {
+            upf_sess_urr_acc_volume_check_setup(sess, urr);
+        }
     }
 }
 
@@ -798,6 +930,8 @@ void upf_sess_urr_acc_snapshot(upf_sess_t *sess, ogs_pfcp_urr_t *urr)
     urr_acc->last_report.dl_pkts = urr_acc->dl_pkts;
     urr_acc->last_report.ul_pkts = urr_acc->ul_pkts;
     urr_acc->last_report.timestamp = ogs_time_now();
+
+    upf_sess_urr_acc_volume_check_setup(sess, urr);
 }
 
 static void upf_sess_urr_acc_timers_cb(void *data)
@@ -60,6 +60,18 @@ typedef struct upf_context_s {
     struct upf_route_trie_node *ipv6_framed_routes;
 
     ogs_list_t sess_list;
+
+    const char *store;      /* Session store file, e.g. /dev/shm/open5gs-upf */
+
+    /* Load/Overload Control Information last reported to the SMF */
+    struct {
+        uint32_t seqn;
+        uint8_t metric;
+    } load;
+    struct {
+        uint32_t seqn;
+        uint8_t reduction;
+    } overload;
 } upf_context_t;
 
 /* trie mapping from IP framed routes to session. */
@@ -85,6 +97,8 @@ typedef struct upf_sess_urr_acc_s {
     uint64_t dl_pkts;
     ogs_time_t time_of_first_packet;
     ogs_time_t time_of_last_packet;
+    /* total_octets at which the next volume quota/threshold check is due */
+    uint64_t next_volume_check;
     /* Snapshot of measurement when last report was sent: */
     struct {
         uint64_t total_octets;
@@ -112,6 +126,7 @@ typedef struct upf_sess_s {
     } smf_n4_f_seid;                    /* SMF SEID is received from Peer */
 
     /* APN Configuration */
+    uint8_t         pdn_type;           /* PDN Type from the SMF */
     ogs_pfcp_ue_ip_t *ipv4;
     ogs_pfcp_ue_ip_t *ipv6;
 
@@ -121,6 +136,8 @@ typedef struct upf_sess_s {
     char            *gx_sid;            /* Gx Session ID */
     ogs_pfcp_node_t *pfcp_node;
 
+    bool            store_pending;      /* Queued for upf_store_flush() */
+
     /* Accounting: */
     upf_sess_urr_acc_t urr_acc[OGS_MAX_NUM_OF_URR]; /* FIXME: This probably needs to be mved to a hashtable or alike */
     char            *apn_dnn;            /* APN/DNN Item */
@@ -135,6 +152,7 @@ int upf_context_parse_config(void);
 upf_sess_t *upf_sess_add_by_message(ogs_pfcp_message_t *message);
 
 upf_sess_t *upf_sess_add(ogs_pfcp_f_seid_t *f_seid);
+upf_sess_t *upf_sess_restore(ogs_pfcp_f_seid_t *f_seid, uint64_t upf_n4_seid);
 int upf_sess_remove(upf_sess_t *sess);
 void upf_sess_remove_all(void);
 upf_sess_t *upf_sess_find_by_smf_n4_seid(uint64_t seid);
@@ -143,6 +161,8 @@ upf_sess_t *upf_sess_find_by_upf_n4_seid(uint64_t seid);
 upf_sess_t *upf_sess_find_by_ipv4(uint32_t addr);
 upf_sess_t *upf_sess_find_by_ipv6(uint32_t *addr6);
 upf_sess_t *upf_sess_find_by_id(ogs_pool_id_t id);
+int upf_sess_index(upf_sess_t *sess);
+uint8_t upf_sess_load_metric(void);
 
 uint8_t upf_sess_set_ue_ip(upf_sess_t *sess,
         uint8_t session_type, ogs_pfcp_pdr_t *pdr);
@@ -151,7 +171,8 @@ uint8_t upf_sess_set_ue_ipv4_framed_routes(upf_sess_t *sess,
 uint8_t upf_sess_set_ue_ipv6_framed_routes(upf_sess_t *sess,
         char *framed_routes[]);
 
-void upf_sess_urr_acc_add(upf_sess_t *sess, ogs_pfcp_urr_t *urr, size_t size, bool is_uplink);
+void upf_sess_urr_acc_add(upf_sess_t *sess, ogs_pfcp_pdr_t *pdr, size_t size, bool is_uplink);
+void upf_sess_urr_acc_volume_check_setup(upf_sess_t *sess, ogs_pfcp_urr_t *urr);
 void upf_sess_urr_acc_fill_usage_report(upf_sess_t *sess, const ogs_pfcp_urr_t *urr,
                                         ogs_pfcp_user_plane_report_t *report, unsigned int idx);
 void upf_sess_urr_acc_snapshot(upf_sess_t *sess, ogs_pfcp_urr_t *urr);
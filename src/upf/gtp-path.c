@@ -109,7 +109,6 @@ static void _gtpv1_tun_recv_common_cb(
     ogs_pfcp_pdr_t *fallback_pdr = NULL;
     ogs_pfcp_far_t *far = NULL;
     ogs_pfcp_user_plane_report_t report;
-    int i;
 
     recvbuf = ogs_tun_read(fd, packet_pool);
     if (!recvbuf) {
@@ -209,9 +208,14 @@ static void _gtpv1_tun_recv_common_cb(
         goto cleanup;
     }
 
+    /* Police Downlink MBR */
+    if (pdr->qer &&
+        ogs_pfcp_qer_police(pdr->qer, false, recvbuf->len,
+            ogs_get_monotonic_time()) == false)
+        goto cleanup;
+
     /* Increment total & dl octets + pkts */
-    for (i = 0; i < pdr->num_of_urr; i++)
-        upf_sess_urr_acc_add(sess, pdr->urr[i], recvbuf->len, false);
+    upf_sess_urr_acc_add(sess, pdr, recvbuf->len, false);
 
     ogs_assert(true == ogs_pfcp_up_handle_pdr(
                 pdr, OGS_GTPU_MSGTYPE_GPDU, NULL, recvbuf, &report));
@@ -262,43 +266,23 @@ static void _gtpv1_tun_recv_eth_cb(short when, ogs_socket_t fd, void *data)
     _gtpv1_tun_recv_common_cb(when, fd, true, data);
 }
 
-static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
+static void gtpu_recv_message(ogs_sock_t *sock, ogs_socket_t fd,
+        ogs_pkbuf_t *pkbuf, ogs_sockaddr_t *from, ogs_time_t now)
 {
     int len;
-    ssize_t size;
     char buf1[OGS_ADDRSTRLEN];
     char buf2[OGS_ADDRSTRLEN];
 
     upf_sess_t *sess = NULL;
 
-    ogs_pkbuf_t *pkbuf = NULL;
-    ogs_sock_t *sock = NULL;
-    ogs_sockaddr_t from;
-
     ogs_gtp2_header_t *gtp_h = NULL;
     ogs_gtp2_header_desc_t header_desc;
     ogs_pfcp_user_plane_report_t report;
 
-    ogs_assert(fd != INVALID_SOCKET);
-    sock = data;
     ogs_assert(sock);
-
-    pkbuf = ogs_pkbuf_alloc(packet_pool, OGS_MAX_PKT_LEN);
-    ogs_assert(pkbuf);
-    ogs_pkbuf_reserve(pkbuf, OGS_TUN_MAX_HEADROOM);
-    ogs_pkbuf_put(pkbuf, OGS_MAX_PKT_LEN-OGS_TUN_MAX_HEADROOM);
-
-    size = ogs_recvfrom(fd, pkbuf->data, pkbuf->len, 0, &from);
-    if (size <= 0) {
-        ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
-                "ogs_recv() failed");
-        goto cleanup;
-    }
-
-    ogs_pkbuf_trim(pkbuf, size);
-
     ogs_assert(pkbuf);
     ogs_assert(pkbuf->len);
+    ogs_assert(from);
 
     gtp_h = (ogs_gtp2_header_t *)pkbuf->data;
     if (gtp_h->version != OGS_GTP2_VERSION_1) {
@@ -316,16 +300,16 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     if (header_desc.type == OGS_GTPU_MSGTYPE_ECHO_REQ) {
         ogs_pkbuf_t *echo_rsp;
 
-        ogs_debug("[RECV] Echo Request from [%s]", OGS_ADDR(&from, buf1));
+        ogs_debug("[RECV] Echo Request from [%s]", OGS_ADDR(from, buf1));
         echo_rsp = ogs_gtp2_handle_echo_req(pkbuf);
         ogs_expect(echo_rsp);
         if (echo_rsp) {
             ssize_t sent;
 
             /* Echo reply */
-            ogs_debug("[SEND] Echo Response to [%s]", OGS_ADDR(&from, buf1));
+            ogs_debug("[SEND] Echo Response to [%s]", OGS_ADDR(from, buf1));
 
-            sent = ogs_sendto(fd, echo_rsp->data, echo_rsp->len, 0, &from);
+            sent = ogs_sendto(fd, echo_rsp->data, echo_rsp->len, 0, from);
             if (sent < 0 || sent != echo_rsp->len) {
                 ogs_log_message(OGS_LOG_ERROR, ogs_socket_errno,
                         "ogs_sendto() failed");
@@ -343,7 +327,7 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
     }
 
     ogs_trace("[RECV] GPU-U Type [%d] from [%s] : TEID[0x%x]",
-            header_desc.type, OGS_ADDR(&from, buf1), header_desc.teid);
+            header_desc.type, OGS_ADDR(from, buf1), header_desc.teid);
 
     /* Remove GTP header and send packets to TUN interface */
     ogs_assert(ogs_pkbuf_pull(pkbuf, len));
@@ -383,7 +367,6 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
 
         ogs_pfcp_subnet_t *subnet = NULL;
         ogs_pfcp_dev_t *dev = NULL;
-        int i;
 
         ip_h = (struct ip *)pkbuf->data;
         ogs_assert(ip_h);
@@ -419,10 +402,10 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                 ogs_error("[%s] Send Error Indication [TEID:0x%x] to [%s]",
                         OGS_ADDR(&sock->local_addr, buf1),
                         header_desc.teid,
-                        OGS_ADDR(&from, buf2));
+                        OGS_ADDR(from, buf2));
                 ogs_gtp1_send_error_indication(
                         sock, header_desc.teid,
-                        header_desc.qos_flow_identifier, &from);
+                        header_desc.qos_flow_identifier, from);
             }
             goto cleanup;
         }
@@ -479,10 +462,10 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
                             "[%s] Send Error Indication [TEID:0x%x] to [%s]",
                             OGS_ADDR(&sock->local_addr, buf1),
                             header_desc.teid,
-                            OGS_ADDR(&from, buf2));
+                            OGS_ADDR(from, buf2));
                     ogs_gtp1_send_error_indication(
                             sock, header_desc.teid,
-                            header_desc.qos_flow_identifier, &from);
+                            header_desc.qos_flow_identifier, from);
                 }
                 goto cleanup;
             }
@@ -639,9 +622,13 @@ static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
             dev = subnet->dev;
             ogs_assert(dev);
 
+            /* Police Uplink MBR */
+            if (pdr->qer &&
+                ogs_pfcp_qer_police(pdr->qer, true, pkbuf->len, now) == false)
+                goto cleanup;
+
             /* Increment total & ul octets + pkts */
-            for (i = 0; i < pdr->num_of_urr; i++)
-                upf_sess_urr_acc_add(sess, pdr->urr[i], pkbuf->len, true);
+            upf_sess_urr_acc_add(sess, pdr, pkbuf->len, true);
 
             if (dev->is_tap) {
                 ogs_assert(eth_type);
@@ -716,6 +703,31 @@ cleanup:
     ogs_pkbuf_free(pkbuf);
 }
 
+static void _gtpv1_u_recv_cb(short when, ogs_socket_t fd, void *data)
+{
+    ogs_pkbuf_t *pkbuf[OGS_GTPU_MAX_RECV_BATCH];
+    ogs_sockaddr_t from[OGS_GTPU_MAX_RECV_BATCH];
+    ogs_sock_t *sock = NULL;
+    ogs_time_t now;
+    int i, num;
+
+    ogs_assert(fd != INVALID_SOCKET);
+    sock = data;
+    ogs_assert(sock);
+
+    num = ogs_gtpu_recvmmsg(fd, packet_pool, OGS_TUN_MAX_HEADROOM,
+            pkbuf, from, OGS_GTPU_MAX_RECV_BATCH);
+
+    /* One timestamp for the whole batch, see ogs_pfcp_qer_police() */
+    now = num > 0 ? ogs_get_monotonic_time() : 0;
+
+    for (i = 0; i < num; i++)
+        gtpu_recv_message(sock, fd, pkbuf[i], &from[i], now);
+
+    /* Send the G-PDUs relayed from this batch */
+    ogs_gtpu_flush();
+}
+
 int upf_gtp_init(void)
 {
     ogs_pkbuf_config_t config;
@@ -737,6 +749,7 @@ int upf_gtp_init(void)
 
 void upf_gtp_final(void)
 {
+    ogs_gtpu_recvbuf_flush();
     ogs_pkbuf_pool_destroy(packet_pool);
 }
 
@@ -21,6 +21,7 @@
 #include "gtp-path.h"
 #include "pfcp-path.h"
 #include "metrics.h"
+#include "store.h"
 
 static ogs_thread_t *thread;
 static void upf_main(void *data);
@@ -74,6 +75,9 @@ int upf_initialize(void)
     rv = upf_gtp_open();
     if (rv != OGS_OK) return rv;
 
+    rv = upf_store_open();
+    if (rv != OGS_OK) return rv;
+
     thread = ogs_thread_create(upf_main, NULL);
     if (!thread) return OGS_ERROR;
 
@@ -95,6 +99,8 @@ void upf_terminate(void)
 
     ogs_metrics_context_close(ogs_metrics_self());
 
+    /* Sessions are kept in the store for the next start */
+    upf_store_close();
     upf_context_final();
 
     ogs_pfcp_context_final();
@@ -148,8 +154,23 @@ static void upf_main(void *data)
             ogs_fsm_dispatch(&upf_sm, e);
             upf_event_free(e);
         }
+
+        /*
+         * Write the sessions changed during this iteration to the store
+         * before the PFCP responses are sent.
+         */
+        upf_store_flush();
+
+        upf_metrics_inst_by_ue_pool_update();
+
+        /* Send the PFCP messages and G-PDUs held during this iteration */
+        ogs_pfcp_flush();
+        ogs_gtpu_flush();
     }
 done:
+    upf_store_flush();
+    ogs_pfcp_flush();
+    ogs_gtpu_flush();
 
     ogs_fsm_fini(&upf_sm, 0);
 }
@@ -60,6 +60,19 @@ typedef enum upf_metric_type_by_dnn_s {
 void upf_metrics_inst_by_dnn_add(
     char *dnn, upf_metric_type_by_dnn_t t, int val);
 
+/* BY UE POOL */
+typedef enum upf_metric_type_by_ue_pool_s {
+    UPF_METR_GAUGE_UE_POOL_SIZE = 0,
+    UPF_METR_GAUGE_UE_POOL_USED,
+    UPF_METR_CTR_UE_POOL_ALLOC,
+    UPF_METR_CTR_UE_POOL_STATIC_ALLOC,
+    UPF_METR_CTR_UE_POOL_ALLOC_FAILED,
+    _UPF_METR_BY_UE_POOL_MAX,
+} upf_metric_type_by_ue_pool_t;
+
+/* Copies the statistics of every UE pool subnet into the metrics */
+void upf_metrics_inst_by_ue_pool_update(void);
+
 void upf_metrics_init(void);
 void upf_metrics_final(void);
 
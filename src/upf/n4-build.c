@@ -20,6 +20,46 @@
 #include "context.h"
 #include "n4-build.h"
 
+/* Start asking the SMF to throttle new sessions above this load */
+#define UPF_OVERLOAD_THRESHOLD 80
+/* Period of Validity : 10 seconds (2 second units) */
+#define UPF_OVERLOAD_VALIDITY 0x05
+
+static void build_load_overload_control_information(
+        ogs_pfcp_tlv_load_control_information_t *lci,
+        ogs_pfcp_tlv_overload_control_information_t *oci)
+{
+    uint8_t metric, reduction;
+    bool changed = false;
+
+    metric = upf_sess_load_metric();
+
+    if (ogs_pfcp_self()->cp_function_features.load) {
+        if (upf_self()->load.seqn == 0 || upf_self()->load.metric != metric) {
+            upf_self()->load.seqn++;
+            upf_self()->load.metric = metric;
+        }
+        ogs_pfcp_build_load_control_information(
+                lci, upf_self()->load.seqn, upf_self()->load.metric);
+    }
+
+    if (ogs_pfcp_self()->cp_function_features.ovrl) {
+        reduction = metric > UPF_OVERLOAD_THRESHOLD ?
+            (metric - UPF_OVERLOAD_THRESHOLD) * 100 /
+                (100 - UPF_OVERLOAD_THRESHOLD) : 0;
+        if (upf_self()->overload.reduction != reduction) {
+            upf_self()->overload.seqn++;
+            upf_self()->overload.reduction = reduction;
+            changed = true;
+        }
+        /* A zero reduction is only sent once to clear the SMF state */
+        if (reduction || changed)
+            ogs_pfcp_build_overload_control_information(
+                    oci, upf_self()->overload.seqn,
+                    upf_self()->overload.reduction, UPF_OVERLOAD_VALIDITY);
+    }
+}
+
 ogs_pkbuf_t *upf_n4_build_session_establishment_response(uint8_t type,
     upf_sess_t *sess, ogs_pfcp_pdr_t *created_pdr[], int num_of_created_pdr)
 {
@@ -69,6 +109,173 @@ ogs_pkbuf_t *upf_n4_build_session_establishment_response(uint8_t type,
         if (pdr_presence == true) j++;
     }
 
+    /* Load/Overload Control Information */
+    build_load_overload_control_information(
+            &rsp->load_control_information,
+            &rsp->overload_control_information);
+
+    pfcp_message->h.type = type;
+    pkbuf = ogs_pfcp_build_msg(pfcp_message);
+    ogs_expect(pkbuf);
+
+    ogs_pfcp_pdrbuf_clear();
+    ogs_free(pfcp_message);
+
+    return pkbuf;
+}
+
+static int pdr_has_sdf_filter_id_only(ogs_pfcp_pdr_t *pdr)
+{
+    ogs_pfcp_rule_t *rule = NULL;
+
+    ogs_list_for_each(&pdr->rule_list, rule) {
+        if (rule->bid && !rule->flow_description)
+            return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Describe the current state of the session as the Session Establishment
+ * Request that would re-create it, with the Restoration Indication set.
+ * The session store keeps this message so that a restarted UPF can run
+ * it through upf_n4_handle_session_establishment_request().
+ */
+ogs_pkbuf_t *upf_n4_build_session_establishment_request(uint8_t type,
+        upf_sess_t *sess)
+{
+    ogs_pfcp_message_t *pfcp_message = NULL;
+    ogs_pfcp_session_establishment_request_t *req = NULL;
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    ogs_pfcp_pdr_t *pdr = NULL;
+    ogs_pfcp_far_t *far = NULL;
+    ogs_pfcp_urr_t *urr = NULL;
+    ogs_pfcp_qer_t *qer = NULL;
+    int i, pass;
+
+    ogs_pfcp_f_seid_t f_seid;
+    ogs_pfcp_f_teid_t *f_teid = NULL;
+    ogs_pfcp_sereq_flags_t sereq_flags;
+    char apn_dnn[OGS_MAX_DNN_LEN+1];
+    const int hdr_len = 9;
+
+    ogs_assert(sess);
+
+    ogs_list_for_each(&sess->pfcp.pdr_list, pdr) {
+        if (!pdr->far) {
+            ogs_error("No FAR in PDR-ID[%d]", pdr->id);
+            return NULL;
+        }
+    }
+    ogs_list_for_each(&sess->pfcp.far_list, far) {
+        if (!(far->apply_action & OGS_PFCP_APPLY_ACTION_FORW) &&
+            (far->apply_action & OGS_PFCP_APPLY_ACTION_BUFF) &&
+            !sess->pfcp.bar) {
+            ogs_error("No BAR in FAR-ID[%d]", far->id);
+            return NULL;
+        }
+    }
+
+    pfcp_message = ogs_calloc(1, sizeof(*pfcp_message));
+    if (!pfcp_message) {
+        ogs_error("ogs_calloc() failed");
+        return NULL;
+    }
+
+    req = &pfcp_message->pfcp_session_establishment_request;
+
+    /* CP F-SEID */
+    memset(&f_seid, 0, sizeof(f_seid));
+    f_seid.ipv4 = sess->smf_n4_f_seid.ip.ipv4;
+    f_seid.ipv6 = sess->smf_n4_f_seid.ip.ipv6;
+    if (f_seid.ipv4 && f_seid.ipv6) {
+        f_seid.both.addr = sess->smf_n4_f_seid.ip.addr;
+        memcpy(f_seid.both.addr6,
+                sess->smf_n4_f_seid.ip.addr6, OGS_IPV6_LEN);
+    } else if (f_seid.ipv4) {
+        f_seid.addr = sess->smf_n4_f_seid.ip.addr;
+    } else {
+        memcpy(f_seid.addr6, sess->smf_n4_f_seid.ip.addr6, OGS_IPV6_LEN);
+    }
+    f_seid.seid = htobe64(sess->smf_n4_f_seid.seid);
+    req->cp_f_seid.presence = 1;
+    req->cp_f_seid.data = &f_seid;
+    req->cp_f_seid.len = sess->smf_n4_f_seid.ip.len + hdr_len;
+
+    ogs_pfcp_pdrbuf_init();
+
+    /*
+     * Create PDR
+     *
+     * A rule with only an SDF Filter ID is copied from the earlier rule
+     * with the same ID, so PDRs holding such rules are built last.
+     */
+    i = 0;
+    for (pass = 0; pass < 2; pass++) {
+        ogs_list_for_each(&sess->pfcp.pdr_list, pdr) {
+            if (pdr_has_sdf_filter_id_only(pdr) != pass)
+                continue;
+
+            ogs_pfcp_build_create_pdr(&req->create_pdr[i], i, pdr);
+
+            /* The TEID has been chosen already, so restore it as it is */
+            if (req->create_pdr[i].pdi.local_f_teid.presence) {
+                f_teid = req->create_pdr[i].pdi.local_f_teid.data;
+                f_teid->ch = 0;
+                f_teid->chid = 0;
+            }
+            i++;
+        }
+    }
+
+    /* Create FAR */
+    i = 0;
+    ogs_list_for_each(&sess->pfcp.far_list, far) {
+        ogs_pfcp_build_create_far(&req->create_far[i], i, far);
+        i++;
+    }
+
+    /* Create URR */
+    i = 0;
+    ogs_list_for_each(&sess->pfcp.urr_list, urr) {
+        ogs_pfcp_build_create_urr(&req->create_urr[i], i, urr);
+        i++;
+    }
+
+    /* Create QER */
+    i = 0;
+    ogs_list_for_each(&sess->pfcp.qer_list, qer) {
+        ogs_pfcp_build_create_qer(&req->create_qer[i], i, qer);
+        i++;
+    }
+
+    /* Create BAR */
+    if (sess->pfcp.bar) {
+        ogs_pfcp_build_create_bar(&req->create_bar, sess->pfcp.bar);
+    }
+
+    /* PDN Type */
+    if (sess->pdn_type) {
+        req->pdn_type.presence = 1;
+        req->pdn_type.u8 = sess->pdn_type;
+    }
+
+    /* APN/DNN */
+    if (sess->apn_dnn) {
+        req->apn_dnn.presence = 1;
+        req->apn_dnn.len = ogs_fqdn_build(
+                apn_dnn, sess->apn_dnn, strlen(sess->apn_dnn));
+        req->apn_dnn.data = apn_dnn;
+    }
+
+    /* Restoration Indication */
+    sereq_flags.value = 0;
+    sereq_flags.restoration_indication = 1;
+    req->pfcpsereq_flags.presence = 1;
+    req->pfcpsereq_flags.u8 = sereq_flags.value;
+
     pfcp_message->h.type = type;
     pkbuf = ogs_pfcp_build_msg(pfcp_message);
     ogs_expect(pkbuf);
@@ -111,6 +318,11 @@ ogs_pkbuf_t *upf_n4_build_session_modification_response(uint8_t type,
         if (pdr_presence == true) j++;
     }
 
+    /* Load/Overload Control Information */
+    build_load_overload_control_information(
+            &rsp->load_control_information,
+            &rsp->overload_control_information);
+
     pfcp_message->h.type = type;
     pkbuf = ogs_pfcp_build_msg(pfcp_message);
     ogs_expect(pkbuf);
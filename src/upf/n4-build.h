@@ -28,6 +28,8 @@ extern "C" {
 
 ogs_pkbuf_t *upf_n4_build_session_establishment_response(uint8_t type,
     upf_sess_t *sess, ogs_pfcp_pdr_t *created_pdr[], int num_of_created_pdr);
+ogs_pkbuf_t *upf_n4_build_session_establishment_request(uint8_t type,
+        upf_sess_t *sess);
 ogs_pkbuf_t *upf_n4_build_session_modification_response(uint8_t type,
     upf_sess_t *sess, ogs_pfcp_pdr_t *created_pdr[], int num_of_created_pdr);
 ogs_pkbuf_t *upf_n4_build_session_deletion_response(uint8_t type,
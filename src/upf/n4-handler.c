@@ -21,6 +21,7 @@
 #include "pfcp-path.h"
 #include "gtp-path.h"
 #include "n4-handler.h"
+#include "store.h"
 
 static void upf_n4_handle_create_urr(upf_sess_t *sess, ogs_pfcp_tlv_create_urr_t *create_urr_arr,
                               uint8_t *cause_value, uint8_t *offending_ie_value)
@@ -36,6 +37,8 @@ static void upf_n4_handle_create_urr(upf_sess_t *sess, ogs_pfcp_tlv_create_urr_t
         if (!urr)
             return;
 
+        upf_sess_urr_acc_volume_check_setup(sess, urr);
+
         /* TODO: enable counters somewhere else if ISTM not set, upon first pkt received */
         if (urr->meas_info.istm) {
             upf_sess_urr_acc_timers_setup(sess, urr);
@@ -58,9 +61,10 @@ void upf_n4_handle_session_establishment_request(
     ogs_pfcp_sereq_flags_t sereq_flags;
     bool restoration_indication = false;
 
-    upf_metrics_inst_global_inc(UPF_METR_GLOB_CTR_SM_N4SESSIONESTABREQ);
+    /* A NULL xact means that the session store is restoring it */
+    if (xact)
+        upf_metrics_inst_global_inc(UPF_METR_GLOB_CTR_SM_N4SESSIONESTABREQ);
 
-    ogs_assert(xact);
     ogs_assert(req);
 
     ogs_debug("Session Establishment Request");
@@ -69,6 +73,8 @@ void upf_n4_handle_session_establishment_request(
 
     if (!sess) {
         ogs_error("No Context");
+        if (!xact)
+            return;
         ogs_pfcp_send_error_message(xact, 0,
                 OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE,
                 OGS_PFCP_CAUSE_MANDATORY_IE_MISSING, 0);
@@ -178,6 +184,7 @@ void upf_n4_handle_session_establishment_request(
         /* Setup UE IP address */
         if (pdr->ue_ip_addr_len) {
             if (req->pdn_type.presence == 1) {
+                sess->pdn_type = req->pdn_type.u8;
                 cause_value = upf_sess_set_ue_ip(sess, req->pdn_type.u8, pdr);
                 if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
                     goto cleanup;
@@ -215,6 +222,11 @@ void upf_n4_handle_session_establishment_request(
         }
     }
 
+    upf_store_save(sess);
+
+    if (!xact)
+        return;
+
     if (restoration_indication == true ||
         ogs_pfcp_self()->up_function_features.ftup == 0)
         ogs_assert(OGS_OK ==
@@ -228,9 +240,11 @@ void upf_n4_handle_session_establishment_request(
     return;
 
 cleanup:
+    ogs_pfcp_sess_clear(&sess->pfcp);
+    if (!xact)
+        return;
     upf_metrics_inst_by_cause_add(cause_value,
             UPF_METR_CTR_SM_N4SESSIONESTABFAIL, 1);
-    ogs_pfcp_sess_clear(&sess->pfcp);
     ogs_pfcp_send_error_message(xact, sess ? sess->smf_n4_f_seid.seid : 0,
             OGS_PFCP_SESSION_ESTABLISHMENT_RESPONSE_TYPE,
             cause_value, offending_ie_value);
@@ -338,9 +352,12 @@ void upf_n4_handle_session_modification_request(
         goto cleanup;
 
     for (i = 0; i < OGS_MAX_NUM_OF_URR; i++) {
-        if (ogs_pfcp_handle_update_urr(&sess->pfcp, &req->update_urr[i],
-                    &cause_value, &offending_ie_value) == NULL)
+        ogs_pfcp_urr_t *urr = ogs_pfcp_handle_update_urr(
+                &sess->pfcp, &req->update_urr[i],
+                &cause_value, &offending_ie_value);
+        if (urr == NULL)
             break;
+        upf_sess_urr_acc_volume_check_setup(sess, urr);
     }
     if (cause_value != OGS_PFCP_CAUSE_REQUEST_ACCEPTED)
         goto cleanup;
@@ -418,6 +435,8 @@ void upf_n4_handle_session_modification_request(
         }
     }
 
+    upf_store_save(sess);
+
     if (ogs_pfcp_self()->up_function_features.ftup == 0)
         ogs_assert(OGS_OK ==
             upf_pfcp_send_session_modification_response(
@@ -430,6 +449,7 @@ void upf_n4_handle_session_modification_request(
 
 cleanup:
     ogs_pfcp_sess_clear(&sess->pfcp);
+    upf_store_remove(sess);
     ogs_pfcp_send_error_message(xact, sess ? sess->smf_n4_f_seid.seid : 0,
             OGS_PFCP_SESSION_MODIFICATION_RESPONSE_TYPE,
             cause_value, offending_ie_value);
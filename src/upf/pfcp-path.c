@@ -55,26 +55,19 @@ static void pfcp_node_fsm_fini(ogs_pfcp_node_t *node)
         ogs_timer_delete(node->t_association);
 }
 
-static void pfcp_recv_cb(short when, ogs_socket_t fd, void *data)
+static void pfcp_recv_message(ogs_pkbuf_t *pkbuf, ogs_sockaddr_t *from)
 {
     int rv;
 
     upf_event_t *e = NULL;
-    ogs_pkbuf_t *pkbuf = NULL;
-    ogs_sockaddr_t from;
     ogs_pfcp_node_t *node = NULL;
     ogs_pfcp_message_t *message = NULL;
 
     ogs_pfcp_status_e pfcp_status;;
     ogs_pfcp_node_id_t node_id;
 
-    ogs_assert(fd != INVALID_SOCKET);
-
-    pkbuf = ogs_pfcp_recvfrom(fd, &from);
-    if (!pkbuf) {
-        ogs_error("ogs_pfcp_recvfrom() failed");
-        return;
-    }
+    ogs_assert(pkbuf);
+    ogs_assert(from);
 
     e = upf_event_new(UPF_EVT_N4_MESSAGE);
     ogs_assert(e);
@@ -104,7 +97,7 @@ static void pfcp_recv_cb(short when, ogs_socket_t fd, void *data)
                 pfcp_status == OGS_PFCP_STATUS_SUCCESS ?
                     ogs_pfcp_node_id_to_string_static(&node_id) :
                     "NULL",
-                ogs_sockaddr_to_string_static(&from));
+                ogs_sockaddr_to_string_static(from));
         break;
 
     case OGS_PFCP_ERROR_SEMANTIC_INCORRECT_MESSAGE:
@@ -114,25 +107,25 @@ static void pfcp_recv_cb(short when, ogs_socket_t fd, void *data)
         ogs_error("ogs_pfcp_extract_node_id() failed "
                 "type [%d] pfcp_status [%d] from %s",
                 message->h.type, pfcp_status,
-                ogs_sockaddr_to_string_static(&from));
+                ogs_sockaddr_to_string_static(from));
         goto cleanup;
 
     default:
         ogs_error("Unexpected pfcp_status "
                 "type [%d] pfcp_status [%d] from %s",
                 message->h.type, pfcp_status,
-                ogs_sockaddr_to_string_static(&from));
+                ogs_sockaddr_to_string_static(from));
         goto cleanup;
     }
 
     node = ogs_pfcp_node_find(&ogs_pfcp_self()->pfcp_peer_list,
-            pfcp_status == OGS_PFCP_STATUS_SUCCESS ? &node_id : NULL, &from);
+            pfcp_status == OGS_PFCP_STATUS_SUCCESS ? &node_id : NULL, from);
     if (!node) {
         if (message->h.type == OGS_PFCP_ASSOCIATION_SETUP_REQUEST_TYPE ||
             message->h.type == OGS_PFCP_ASSOCIATION_SETUP_RESPONSE_TYPE) {
             ogs_assert(pfcp_status == OGS_PFCP_STATUS_SUCCESS);
             node = ogs_pfcp_node_add(&ogs_pfcp_self()->pfcp_peer_list,
-                    &node_id, &from);
+                    &node_id, from);
             if (!node) {
                 ogs_error("No memory: ogs_pfcp_node_add() failed");
                 goto cleanup;
@@ -148,7 +141,7 @@ static void pfcp_recv_cb(short when, ogs_socket_t fd, void *data)
                     pfcp_status == OGS_PFCP_STATUS_SUCCESS ?
                         ogs_pfcp_node_id_to_string_static(&node_id) :
                         "NULL",
-                    ogs_sockaddr_to_string_static(&from));
+                    ogs_sockaddr_to_string_static(from));
             goto cleanup;
         }
     } else {
@@ -157,7 +150,7 @@ static void pfcp_recv_cb(short when, ogs_socket_t fd, void *data)
         ogs_expect(OGS_OK == ogs_pfcp_node_merge(
                     node,
                     pfcp_status == OGS_PFCP_STATUS_SUCCESS ?  &node_id : NULL,
-                    &from));
+                    from));
         ogs_debug("Merged PFCP-Node: addr_list %s",
                 ogs_sockaddr_to_string_static(node->addr_list));
     }
@@ -180,6 +173,19 @@ cleanup:
     upf_event_free(e);
 }
 
+static void pfcp_recv_cb(short when, ogs_socket_t fd, void *data)
+{
+    ogs_pkbuf_t *pkbuf[OGS_PFCP_MAX_RECV_BATCH];
+    ogs_sockaddr_t from[OGS_PFCP_MAX_RECV_BATCH];
+    int i, num;
+
+    ogs_assert(fd != INVALID_SOCKET);
+
+    num = ogs_pfcp_recvmmsg(fd, pkbuf, from, OGS_PFCP_MAX_RECV_BATCH);
+    for (i = 0; i < num; i++)
+        pfcp_recv_message(pkbuf[i], &from[i]);
+}
+
 int upf_pfcp_open(void)
 {
     ogs_socknode_t *node = NULL;
@@ -361,6 +367,13 @@ int upf_pfcp_send_session_report_request(
     ogs_assert(sess);
     ogs_assert(report);
 
+    if (!sess->pfcp_node) {
+        /* Restored from the session store, SMF not associated yet */
+        ogs_warn("No PFCP node for UPF-N4-SEID[0x%lx]",
+                (long)sess->upf_n4_seid);
+        return OGS_OK;
+    }
+
     memset(&h, 0, sizeof(ogs_pfcp_header_t));
     h.type = OGS_PFCP_SESSION_REPORT_REQUEST_TYPE;
     h.seid = sess->smf_n4_f_seid.seid;
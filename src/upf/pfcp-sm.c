@@ -25,6 +25,7 @@
 #include "pfcp-path.h"
 #include "n4-handler.h"
 
+static void pfcp_adopt_restored_sessions(ogs_pfcp_node_t *node);
 static void pfcp_restoration(ogs_pfcp_node_t *node);
 static void node_timeout(ogs_pfcp_xact_t *xact, void *data);
 
@@ -172,6 +173,8 @@ void upf_pfcp_state_associated(ogs_fsm_t *s, upf_event_t *e)
         ogs_assert(OGS_OK ==
             ogs_pfcp_send_heartbeat_request(node, node_timeout));
 
+        pfcp_adopt_restored_sessions(node);
+
         if (node->restoration_required == true) {
             pfcp_restoration(node);
             node->restoration_required = false;
@@ -334,6 +337,35 @@ void upf_pfcp_state_exception(ogs_fsm_t *s, upf_event_t *e)
     }
 }
 
+/*
+ * Sessions replayed from the session store have no PFCP node until
+ * their SMF is associated again. Match them by the CP F-SEID address.
+ */
+static void pfcp_adopt_restored_sessions(ogs_pfcp_node_t *node)
+{
+    upf_sess_t *sess = NULL;
+    ogs_sockaddr_t *addr = NULL;
+    ogs_ip_t *ip = NULL;
+
+    ogs_list_for_each(&upf_self()->sess_list, sess) {
+        if (sess->pfcp_node)
+            continue;
+
+        ip = &sess->smf_n4_f_seid.ip;
+        for (addr = node->addr_list; addr; addr = addr->next) {
+            if (addr->ogs_sa_family == AF_INET && ip->ipv4 &&
+                addr->sin.sin_addr.s_addr == ip->addr)
+                break;
+            if (addr->ogs_sa_family == AF_INET6 && ip->ipv6 &&
+                memcmp(addr->sin6.sin6_addr.s6_addr,
+                    ip->addr6, OGS_IPV6_LEN) == 0)
+                break;
+        }
+        if (addr)
+            OGS_SETUP_PFCP_NODE(sess, node);
+    }
+}
+
 static void pfcp_restoration(ogs_pfcp_node_t *node)
 {
     upf_sess_t *sess = NULL, *next = NULL;
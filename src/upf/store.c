@@ -0,0 +1,394 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "store.h"
+#include "n4-build.h"
+#include "n4-handler.h"
+
+#if HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+
+#if HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#if HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#define UPF_STORE_MAGIC     0x4f505346  /* "OPSF" */
+#define UPF_STORE_VERSION   1
+
+typedef struct upf_store_header_s {
+    uint32_t        magic;
+    uint32_t        version;
+    uint32_t        slot_size;
+    uint32_t        num_of_slot;
+    uint32_t        local_recovery;     /* PFCP Recovery Time Stamp */
+    uint32_t        spare;
+} upf_store_header_t;
+
+/*
+ * A session that is not in its slot, because it does not fit or because
+ * the process died while writing it. Restoring such a store is incomplete.
+ */
+#define UPF_STORE_SLOT_SKIPPED  UINT32_MAX
+
+typedef struct upf_store_slot_s {
+    uint32_t        len;                /* 0 if the slot is free */
+    uint8_t         data[UPF_STORE_SLOT_SIZE - sizeof(uint32_t)];
+} upf_store_slot_t;
+
+static struct {
+    const char      *path;
+    int             fd;
+    size_t          size;
+
+    upf_store_header_t *header;
+    upf_store_slot_t *slot;
+
+    ogs_pool_id_t   *pending;           /* Sessions waiting for a rewrite */
+    int             num_of_pending;
+} self;
+
+static upf_store_slot_t *store_slot(upf_sess_t *sess)
+{
+    int index = upf_sess_index(sess);
+
+    ogs_assert(index > 0 && index <= self.header->num_of_slot);
+    return &self.slot[index-1];
+}
+
+static void store_restore(void)
+{
+    ogs_time_t start = ogs_get_monotonic_time();
+    uint8_t *buf = NULL, *pos = NULL;
+    size_t total = 0;
+    uint32_t len;
+    int i, found = 0, restored = 0, skipped = 0;
+
+    /*
+     * A restored session is stored again in the slot of its new pool
+     * index, so every message is copied out before any is replayed.
+     */
+    for (i = 0; i < self.header->num_of_slot; i++) {
+        len = self.slot[i].len;
+        if (len == 0)
+            continue;
+        if (len == UPF_STORE_SLOT_SKIPPED) {
+            self.slot[i].len = 0;
+            skipped++;
+            continue;
+        }
+        if (len <= OGS_PFCP_HEADER_LEN || len > sizeof(self.slot[i].data)) {
+            ogs_error("Invalid slot[%d] length [%u]", i, len);
+            self.slot[i].len = 0;
+            skipped++;
+            continue;
+        }
+        total += sizeof(len) + len;
+        found++;
+    }
+
+    if (skipped)
+        ogs_warn("%d sessions were not in the session store", skipped);
+
+    if (found == 0)
+        return;
+
+    buf = ogs_malloc(total);
+    ogs_assert(buf);
+
+    pos = buf;
+    for (i = 0; i < self.header->num_of_slot; i++) {
+        len = self.slot[i].len;
+        if (len == 0)
+            continue;
+        memcpy(pos, &len, sizeof(len));
+        memcpy(pos + sizeof(len), self.slot[i].data, len);
+        pos += sizeof(len) + len;
+        self.slot[i].len = 0;
+    }
+
+    for (pos = buf; pos < buf + total; pos += sizeof(len) + len) {
+        ogs_pkbuf_t *pkbuf = NULL;
+        ogs_pfcp_message_t *message = NULL;
+        ogs_pfcp_session_establishment_request_t *req = NULL;
+        ogs_pfcp_f_seid_t *f_seid = NULL;
+        upf_sess_t *sess = NULL;
+
+        memcpy(&len, pos, sizeof(len));
+
+        pkbuf = ogs_pkbuf_alloc(NULL, len);
+        ogs_assert(pkbuf);
+        ogs_pkbuf_put_data(pkbuf, pos + sizeof(len), len);
+
+        message = ogs_pfcp_parse_msg(pkbuf);
+        if (!message) {
+            ogs_error("ogs_pfcp_parse_msg() failed");
+            ogs_pkbuf_free(pkbuf);
+            continue;
+        }
+
+        req = &message->pfcp_session_establishment_request;
+        f_seid = req->cp_f_seid.data;
+        if (message->h.type != OGS_PFCP_SESSION_ESTABLISHMENT_REQUEST_TYPE ||
+            req->cp_f_seid.presence == 0 || f_seid == NULL) {
+            ogs_error("Invalid message [type:%d]", message->h.type);
+            goto next;
+        }
+        f_seid->seid = be64toh(f_seid->seid);
+
+        sess = upf_sess_restore(f_seid, message->h.seid);
+        if (!sess)
+            goto next;
+
+        upf_n4_handle_session_establishment_request(sess, NULL, req);
+        if (ogs_list_first(&sess->pfcp.pdr_list) == NULL) {
+            ogs_error("Cannot restore UPF-N4-SEID[0x%lx]",
+                    (long)sess->upf_n4_seid);
+            upf_sess_remove(sess);
+            goto next;
+        }
+
+        restored++;
+
+next:
+        ogs_pfcp_message_free(message);
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    ogs_free(buf);
+
+    upf_store_flush();
+
+    /*
+     * Keep the Recovery Time Stamp of the previous process, so that
+     * the SMF does not take the restart for a loss of PFCP state.
+     * If any session is missing, the new Recovery Time Stamp stands and
+     * the SMF re-establishes its sessions.
+     */
+    if (restored == found && skipped == 0)
+        ogs_pfcp_self()->local_recovery = self.header->local_recovery;
+
+    ogs_info("Restored %d of %d sessions in %lld usec",
+            restored, found, (long long)(ogs_get_monotonic_time() - start));
+}
+
+int upf_store_open(void)
+{
+    struct stat st;
+    void *addr = NULL;
+    int num_of_slot, i;
+
+    self.path = upf_self()->store;
+    if (!self.path)
+        return OGS_OK;
+
+    num_of_slot = ogs_app()->pool.sess;
+    self.size = sizeof(upf_store_header_t) +
+        (size_t)num_of_slot * sizeof(upf_store_slot_t);
+
+    self.fd = open(self.path, O_RDWR|O_CREAT, 0600);
+    if (self.fd < 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_errno,
+                "open(%s) failed", self.path);
+        return OGS_ERROR;
+    }
+
+    if (fstat(self.fd, &st) != 0) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_errno,
+                "fstat(%s) failed", self.path);
+        goto cleanup;
+    }
+
+    if ((size_t)st.st_size != self.size) {
+        if (st.st_size)
+            ogs_warn("Discard session store [%s] of %lld bytes",
+                    self.path, (long long)st.st_size);
+        if (ftruncate(self.fd, 0) != 0 ||
+            ftruncate(self.fd, self.size) != 0) {
+            ogs_log_message(OGS_LOG_ERROR, ogs_errno,
+                    "ftruncate(%s) failed", self.path);
+            goto cleanup;
+        }
+    }
+
+    addr = mmap(NULL, self.size,
+            PROT_READ|PROT_WRITE, MAP_SHARED, self.fd, 0);
+    if (addr == MAP_FAILED) {
+        ogs_log_message(OGS_LOG_ERROR, ogs_errno,
+                "mmap(%s) failed", self.path);
+        goto cleanup;
+    }
+
+    self.header = addr;
+    self.slot = (upf_store_slot_t *)(self.header + 1);
+
+    self.pending = ogs_calloc(num_of_slot, sizeof(ogs_pool_id_t));
+    ogs_assert(self.pending);
+    self.num_of_pending = 0;
+
+    if (self.header->magic == UPF_STORE_MAGIC &&
+        self.header->version == UPF_STORE_VERSION &&
+        self.header->slot_size == sizeof(upf_store_slot_t) &&
+        self.header->num_of_slot == num_of_slot) {
+        store_restore();
+    } else {
+        if (self.header->magic)
+            ogs_warn("Discard session store [%s] "
+                    "[magic:0x%x version:%d]", self.path,
+                    self.header->magic, self.header->version);
+        for (i = 0; i < num_of_slot; i++)
+            self.slot[i].len = 0;
+    }
+
+    self.header->magic = UPF_STORE_MAGIC;
+    self.header->version = UPF_STORE_VERSION;
+    self.header->slot_size = sizeof(upf_store_slot_t);
+    self.header->num_of_slot = num_of_slot;
+    self.header->local_recovery = ogs_pfcp_self()->local_recovery;
+
+    ogs_info("Session store [%s] with %d slots", self.path, num_of_slot);
+
+    return OGS_OK;
+
+cleanup:
+    close(self.fd);
+    self.fd = -1;
+
+    return OGS_ERROR;
+}
+
+void upf_store_close(void)
+{
+    if (!self.header)
+        return;
+
+    munmap(self.header, self.size);
+    close(self.fd);
+
+    ogs_free(self.pending);
+    self.pending = NULL;
+    self.num_of_pending = 0;
+
+    self.header = NULL;
+    self.slot = NULL;
+    self.fd = -1;
+}
+
+static void store_write(upf_sess_t *sess)
+{
+    upf_store_slot_t *slot = NULL;
+    ogs_pfcp_header_t *h = NULL;
+    ogs_pkbuf_t *pkbuf = NULL;
+
+    ogs_assert(sess);
+
+    slot = store_slot(sess);
+
+    pkbuf = upf_n4_build_session_establishment_request(
+            OGS_PFCP_SESSION_ESTABLISHMENT_REQUEST_TYPE, sess);
+    if (!pkbuf) {
+        ogs_error("Cannot store UPF-N4-SEID[0x%lx]", (long)sess->upf_n4_seid);
+        return;
+    }
+
+    ogs_assert(ogs_pkbuf_push(pkbuf, OGS_PFCP_HEADER_LEN));
+    h = (ogs_pfcp_header_t *)pkbuf->data;
+    memset(h, 0, OGS_PFCP_HEADER_LEN);
+
+    h->version = OGS_PFCP_VERSION;
+    h->seid_presence = 1;
+    h->type = OGS_PFCP_SESSION_ESTABLISHMENT_REQUEST_TYPE;
+    h->length = htobe16(pkbuf->len - 4);
+    h->seid = htobe64(sess->upf_n4_seid);
+
+    if (pkbuf->len > sizeof(slot->data)) {
+        ogs_warn("UPF-N4-SEID[0x%lx] needs %d bytes in the session store",
+                (long)sess->upf_n4_seid, pkbuf->len);
+        ogs_pkbuf_free(pkbuf);
+        return;
+    }
+
+    /* The length goes last, so a crash never leaves half a message */
+    memcpy(slot->data, pkbuf->data, pkbuf->len);
+    __atomic_store_n(&slot->len, pkbuf->len, __ATOMIC_RELEASE);
+
+    ogs_pkbuf_free(pkbuf);
+}
+
+void upf_store_save(upf_sess_t *sess)
+{
+    ogs_assert(sess);
+
+    if (!self.header)
+        return;
+
+    /* Until upf_store_flush() writes it, the session counts as missing */
+    __atomic_store_n(&store_slot(sess)->len,
+            UPF_STORE_SLOT_SKIPPED, __ATOMIC_RELEASE);
+
+    if (sess->store_pending)
+        return;
+
+    /* Removed sessions may still hold entries, so the queue can fill up */
+    if (self.num_of_pending == self.header->num_of_slot)
+        upf_store_flush();
+
+    self.pending[self.num_of_pending++] = sess->id;
+    sess->store_pending = true;
+}
+
+void upf_store_remove(upf_sess_t *sess)
+{
+    ogs_assert(sess);
+
+    if (!self.header)
+        return;
+
+    __atomic_store_n(&store_slot(sess)->len, 0, __ATOMIC_RELEASE);
+    sess->store_pending = false;
+}
+
+void upf_store_flush(void)
+{
+    upf_sess_t *sess = NULL;
+    int i;
+
+    if (!self.header)
+        return;
+
+    for (i = 0; i < self.num_of_pending; i++) {
+        /* Skip a session that was removed since it was queued */
+        sess = upf_sess_find_by_id(self.pending[i]);
+        if (!sess || !sess->store_pending)
+            continue;
+
+        sess->store_pending = false;
+        store_write(sess);
+    }
+
+    self.num_of_pending = 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPF_STORE_H
+#define UPF_STORE_H
+
+#include "context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Session store
+ *
+ * Every session owns one fixed-size slot in a memory-mapped file,
+ * indexed by its position in the session pool. The slot holds the
+ * Session Establishment Request (with the Restoration Indication)
+ * that re-creates the current PDR/FAR/URR/QER/BAR, UE IP address and
+ * TEIDs. The file lives in /dev/shm, so it survives a restart of the
+ * process, and upf_store_open() replays it before PFCP comes up.
+ *
+ * The PFCP Recovery Time Stamp of the previous process is kept only if
+ * every session was in the store and was restored. A session that does
+ * not fit in its slot leaves a marker behind, so the next start knows
+ * the store is incomplete.
+ *
+ * upf_store_save() only marks the slot as missing and queues the
+ * session. upf_store_flush() encodes each queued session once, at the
+ * end of the event loop iteration, so a burst of modifications to one
+ * session costs a single rewrite of its slot.
+ */
+#define UPF_STORE_SLOT_SIZE 2048
+
+int upf_store_open(void);
+void upf_store_close(void);
+
+void upf_store_save(upf_sess_t *sess);
+void upf_store_remove(upf_sess_t *sess);
+void upf_store_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UPF_STORE_H */
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "ogs-core.h"
+#include "core/abts.h"
+
+static void test1_func(abts_case *tc, void *data)
+{
+    static const int sizes[] = { 2, 63, 64, 65, 4096, 4097, 262145 };
+    ogs_bitmap_t bitmap;
+    int i, n, rv;
+
+    for (n = 0; n < sizeof(sizes)/sizeof(sizes[0]); n++) {
+        rv = ogs_bitmap_init(&bitmap, sizes[n]);
+        ABTS_INT_EQUAL(tc, OGS_OK, rv);
+        ABTS_INT_EQUAL(tc, sizes[n], ogs_bitmap_avail(&bitmap));
+
+        /* Indexes are handed out in order, and never past the end */
+        for (i = 0; i < sizes[n]; i++) {
+            rv = ogs_bitmap_alloc(&bitmap);
+            if (rv != i) break;
+        }
+        ABTS_INT_EQUAL(tc, sizes[n], i);
+        ABTS_INT_EQUAL(tc, -1, ogs_bitmap_alloc(&bitmap));
+        ABTS_INT_EQUAL(tc, 0, ogs_bitmap_avail(&bitmap));
+
+        /* A freed index in a full word is found again */
+        ogs_bitmap_clear(&bitmap, sizes[n] - 1);
+        ABTS_INT_EQUAL(tc, sizes[n] - 1, ogs_bitmap_alloc(&bitmap));
+
+        ogs_bitmap_clear(&bitmap, sizes[n] / 2);
+        ogs_bitmap_clear(&bitmap, 0);
+        ABTS_INT_EQUAL(tc, 2, ogs_bitmap_avail(&bitmap));
+        ABTS_INT_EQUAL(tc, 0, ogs_bitmap_alloc(&bitmap));
+        ABTS_INT_EQUAL(tc, sizes[n] / 2, ogs_bitmap_alloc(&bitmap));
+        ABTS_INT_EQUAL(tc, -1, ogs_bitmap_alloc(&bitmap));
+
+        ogs_bitmap_final(&bitmap);
+    }
+}
+
+static void test2_func(abts_case *tc, void *data)
+{
+    ogs_bitmap_t bitmap;
+    int i, rv;
+
+    rv = ogs_bitmap_init(&bitmap, 200);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    /* Reserved indexes are skipped by the allocator */
+    ABTS_TRUE(tc, ogs_bitmap_set(&bitmap, 0));
+    ABTS_TRUE(tc, ogs_bitmap_set(&bitmap, 2));
+    ABTS_TRUE(tc, !ogs_bitmap_set(&bitmap, 2));
+    ABTS_TRUE(tc, ogs_bitmap_test(&bitmap, 2));
+    ABTS_TRUE(tc, !ogs_bitmap_test(&bitmap, 1));
+
+    ABTS_INT_EQUAL(tc, 1, ogs_bitmap_alloc(&bitmap));
+    ABTS_INT_EQUAL(tc, 3, ogs_bitmap_alloc(&bitmap));
+    ABTS_INT_EQUAL(tc, 4, ogs_bitmap_used(&bitmap));
+
+    ogs_bitmap_clear(&bitmap, 2);
+    ogs_bitmap_clear(&bitmap, 2);
+    ABTS_INT_EQUAL(tc, 3, ogs_bitmap_used(&bitmap));
+
+    /* A released index is not reused until the search wraps around */
+    ABTS_INT_EQUAL(tc, 4, ogs_bitmap_alloc(&bitmap));
+    for (i = 5; i < 200; i++) {
+        rv = ogs_bitmap_alloc(&bitmap);
+        if (rv != i) break;
+    }
+    ABTS_INT_EQUAL(tc, 200, i);
+    ABTS_INT_EQUAL(tc, 2, ogs_bitmap_alloc(&bitmap));
+    ABTS_INT_EQUAL(tc, -1, ogs_bitmap_alloc(&bitmap));
+
+    ogs_bitmap_final(&bitmap);
+}
+
+abts_suite *test_bitmap(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, test1_func, NULL);
+    abts_run_test(suite, test2_func, NULL);
+
+    return suite;
+}
@@ -424,6 +424,34 @@ static void test8_func(abts_case *tc, void *data)
     ABTS_INT_EQUAL(tc, OGS_OK, rv);
 }
 
+static void test9_func(abts_case *tc, void *data)
+{
+    int rv;
+    ogs_sockaddr_t *addr, *cached;
+
+    rv = ogs_getaddrinfo_cached(&addr, AF_UNSPEC, "localhost", PORT, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_PTR_NOTNULL(tc, addr);
+    ABTS_INT_EQUAL(tc, PORT, OGS_PORT(addr));
+    ABTS_STR_EQUAL(tc, "localhost", addr->hostname);
+
+    rv = ogs_getaddrinfo_cached(&cached, AF_UNSPEC, "localhost", PORT2, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_PTR_NOTNULL(tc, cached);
+    ABTS_INT_EQUAL(tc, PORT2, OGS_PORT(cached));
+    ABTS_TRUE(tc, ogs_sockaddr_is_equal_addr(addr, cached));
+
+    ogs_freeaddrinfo(cached);
+    ogs_freeaddrinfo(addr);
+
+    rv = ogs_getaddrinfo_cached(&addr, AF_UNSPEC, "127.0.0.1", PORT, 0);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    ABTS_PTR_EQUAL(tc, NULL, addr->hostname);
+    ogs_freeaddrinfo(addr);
+
+    ogs_dns_cache_flush();
+}
+
 abts_suite *test_socket(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -436,6 +464,7 @@ abts_suite *test_socket(abts_suite *suite)
     abts_run_test(suite, test6_func, NULL);
     abts_run_test(suite, test7_func, NULL);
     abts_run_test(suite, test8_func, NULL);
+    abts_run_test(suite, test9_func, NULL);
 
     return suite;
 }
@@ -852,6 +852,63 @@ static void test6_func(abts_case *tc, void *data)
     ogs_pkbuf_free(req);
 }
 
+typedef struct _tlv_counter_report {
+    ogs_tlv_uint16_t rule_id;
+    ogs_tlv_uint24_t volume;
+    ogs_tlv_uint32_t duration;
+} tlv_counter_report;
+
+ogs_tlv_desc_t tlv_desc_rule_id =
+    { OGS_TLV_UINT16, "Rule ID", 56, 2, 0, sizeof(ogs_tlv_uint16_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_volume =
+    { OGS_TLV_UINT24, "Volume", 66, 3, 0, sizeof(ogs_tlv_uint24_t), { NULL } };
+ogs_tlv_desc_t tlv_desc_duration =
+    { OGS_TLV_UINT32, "Duration", 67, 4, 0, sizeof(ogs_tlv_uint32_t), { NULL } };
+
+ogs_tlv_desc_t tlv_desc_counter_report = {
+    OGS_TLV_MESSAGE, "Counter Report", 0, 0, 0, 0, {
+    &tlv_desc_rule_id,
+    &tlv_desc_volume,
+    &tlv_desc_duration,
+    NULL,
+}};
+
+static void test7_func(abts_case *tc, void *data)
+{
+    tlv_counter_report report;
+    ogs_pkbuf_t *pkbuf = NULL;
+    char testbuf[1024];
+    int i;
+
+    memset(&report, 0, sizeof(report));
+    report.rule_id.presence = 1;
+    report.rule_id.u16 = 0x1234;
+    report.volume.presence = 1;
+    report.volume.u24 = 0x56789a;
+    report.duration.presence = 1;
+    report.duration.u32 = 0xbcdef012;
+
+#define TEST_TLV_BUILD_COUNTER \
+    "00380002 12340042 00035678 9a004300" \
+    "04bcdef0 12"
+
+    /* Building must not modify the message, so it can be built again */
+    for (i = 0; i < 2; i++) {
+        pkbuf = ogs_tlv_build_msg(&tlv_desc_counter_report, &report,
+                OGS_TLV_MODE_T2_L2);
+        ABTS_PTR_NOTNULL(tc, pkbuf);
+        ABTS_INT_EQUAL(tc, 21, pkbuf->len);
+        ABTS_TRUE(tc, memcmp(pkbuf->data,
+            ogs_hex_from_string(TEST_TLV_BUILD_COUNTER,
+                testbuf, sizeof(testbuf)), pkbuf->len) == 0);
+        ogs_pkbuf_free(pkbuf);
+    }
+
+    ABTS_INT_EQUAL(tc, 0x1234, report.rule_id.u16);
+    ABTS_INT_EQUAL(tc, 0x56789a, report.volume.u24);
+    ABTS_INT_EQUAL(tc, 0xbcdef012, report.duration.u32);
+}
+
 abts_suite *test_tlv(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -875,6 +932,7 @@ abts_suite *test_tlv(abts_suite *suite)
     abts_run_test(suite, test5_func, (void*)OGS_TLV_MODE_T1_L2_I1);
 
     abts_run_test(suite, test6_func, NULL);
+    abts_run_test(suite, test7_func, NULL);
 
     return suite;
 }
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 by Sukchan Lee <acetcom@gmail.com>
+ *
+ * This file is part of Open5GS.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ogs-pfcp.h"
+#include "core/abts.h"
+
+/*
+ * The UP function keeps the SDF Filters of a PDR as rules only.
+ * Building the Create PDR from them must give back every filter.
+ */
+static void pfcp_message_test1(abts_case *tc, void *data)
+{
+    static char *description[] = {
+        (char *)"permit out ip from 10.45.0.1 to assigned",
+        (char *)"permit out udp from any 5060 to assigned 50000-50010",
+    };
+    ogs_pfcp_message_t message, decoded;
+    ogs_pfcp_session_establishment_request_t *req = NULL;
+    ogs_pfcp_sdf_filter_t sdf_filter;
+    ogs_pfcp_pdr_t pdr;
+    ogs_pfcp_far_t far;
+    ogs_pfcp_rule_t rule[4];
+    ogs_pkbuf_t *pkbuf = NULL;
+    int i, rv;
+
+    memset(&pdr, 0, sizeof(pdr));
+    memset(&far, 0, sizeof(far));
+    memset(rule, 0, sizeof(rule));
+
+    far.id = 1;
+    pdr.id = 1;
+    pdr.precedence = 255;
+    pdr.src_if = OGS_PFCP_INTERFACE_CORE;
+    pdr.far = &far;
+
+    /* Flow Description with an SDF Filter ID */
+    rule[0].fd = 1;
+    rule[0].flow_description = description[0];
+    rule[0].bid = 1;
+    rule[0].sdf_filter_id = 1;
+    /* Flow Description only */
+    rule[1].fd = 1;
+    rule[1].flow_description = description[1];
+    /* SDF Filter ID only, copied from the opposite direction */
+    rule[2].bid = 1;
+    rule[2].sdf_filter_id = 7;
+    /* Nothing to send */
+    rule[3].spi = 1;
+
+    for (i = 0; i < 4; i++) {
+        rule[i].pdr = &pdr;
+        ogs_list_add(&pdr.rule_list, &rule[i]);
+    }
+
+    memset(&message, 0, sizeof(message));
+    message.h.type = OGS_PFCP_SESSION_ESTABLISHMENT_REQUEST_TYPE;
+    req = &message.pfcp_session_establishment_request;
+
+    ogs_pfcp_pdrbuf_init();
+    ogs_pfcp_build_create_pdr(&req->create_pdr[0], 0, &pdr);
+
+    pkbuf = ogs_pfcp_build_msg(&message);
+    ABTS_PTR_NOTNULL(tc, pkbuf);
+
+    ogs_pfcp_pdrbuf_clear();
+
+    memset(&decoded, 0, sizeof(decoded));
+    req = &decoded.pfcp_session_establishment_request;
+    rv = ogs_tlv_parse_msg(req,
+            &ogs_pfcp_msg_desc_pfcp_session_establishment_request,
+            pkbuf, OGS_TLV_MODE_T2_L2);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    ABTS_INT_EQUAL(tc, 1, req->create_pdr[0].presence);
+    ABTS_INT_EQUAL(tc, 1, req->create_pdr[0].pdr_id.u16);
+    ABTS_INT_EQUAL(tc, 1, req->create_pdr[0].far_id.u32);
+    ABTS_INT_EQUAL(tc, 0, req->create_pdr[0].pdi.sdf_filter[3].presence);
+
+    for (i = 0; i < 3; i++) {
+        ABTS_INT_EQUAL(tc, 1, req->create_pdr[0].pdi.sdf_filter[i].presence);
+        rv = ogs_pfcp_parse_sdf_filter(
+                &sdf_filter, &req->create_pdr[0].pdi.sdf_filter[i]);
+        ABTS_INT_EQUAL(tc, req->create_pdr[0].pdi.sdf_filter[i].len, rv);
+
+        ABTS_INT_EQUAL(tc, rule[i].fd, sdf_filter.fd);
+        ABTS_INT_EQUAL(tc, rule[i].bid, sdf_filter.bid);
+        if (rule[i].fd) {
+            ABTS_INT_EQUAL(tc, strlen(rule[i].flow_description),
+                    sdf_filter.flow_description_len);
+            ABTS_TRUE(tc, memcmp(rule[i].flow_description,
+                    sdf_filter.flow_description,
+                    sdf_filter.flow_description_len) == 0);
+        }
+        if (rule[i].bid)
+            ABTS_INT_EQUAL(tc, rule[i].sdf_filter_id,
+                    sdf_filter.sdf_filter_id);
+    }
+
+    ogs_pkbuf_free(pkbuf);
+}
+
+abts_suite *test_pfcp_message(abts_suite *suite)
+{
+    suite = ADD_SUITE(suite)
+
+    abts_run_test(suite, pfcp_message_test1, NULL);
+
+    return suite;
+}
@@ -1021,6 +1021,149 @@ static void sbi_message_test10(abts_case *tc, void *param)
     }
 }
 
+static int sbi_cache_freed;
+
+static void sbi_cache_free(void *data)
+{
+    sbi_cache_freed++;
+    ogs_free(data);
+}
+
+static ogs_sbi_request_t *cache_key_request(const char *name[], int num)
+{
+    ogs_sbi_request_t *request = NULL;
+    int i;
+
+    request = ogs_sbi_request_new();
+    ogs_assert(request);
+
+    request->h.method = ogs_strdup(OGS_SBI_HTTP_METHOD_GET);
+    request->h.service.name = ogs_strdup(OGS_SBI_SERVICE_NAME_NUDR_DR);
+    request->h.api.version = ogs_strdup(OGS_SBI_API_V1);
+    request->h.resource.component[0] =
+        ogs_strdup(OGS_SBI_RESOURCE_NAME_SUBSCRIPTION_DATA);
+
+    for (i = 0; i < num; i++)
+        ogs_hash_set(request->http.params,
+                ogs_strdup(name[i]), strlen(name[i]), ogs_strdup(name[i]));
+
+    return request;
+}
+
+static void sbi_message_test11(abts_case *tc, void *data)
+{
+    ogs_sbi_cache_t *cache = NULL;
+    ogs_sbi_message_t message;
+    ogs_sbi_request_t *request1 = NULL, *request2 = NULL;
+    char *key1 = NULL, *key2 = NULL;
+
+    sbi_cache_freed = 0;
+
+    /* The least recently used entry is evicted */
+    cache = ogs_sbi_cache_create(2, 0, sbi_cache_free);
+    ABTS_PTR_NOTNULL(tc, cache);
+
+    ogs_sbi_cache_set(cache, "a", ogs_strdup("1"));
+    ogs_sbi_cache_set(cache, "b", ogs_strdup("2"));
+    ABTS_STR_EQUAL(tc, "1", ogs_sbi_cache_get(cache, "a"));
+    ogs_sbi_cache_set(cache, "c", ogs_strdup("3"));
+    ABTS_INT_EQUAL(tc, 1, sbi_cache_freed);
+
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_cache_get(cache, "b"));
+    ABTS_STR_EQUAL(tc, "1", ogs_sbi_cache_get(cache, "a"));
+    ABTS_STR_EQUAL(tc, "3", ogs_sbi_cache_get(cache, "c"));
+
+    /* Setting a key again replaces the entry */
+    ogs_sbi_cache_set(cache, "a", ogs_strdup("4"));
+    ABTS_INT_EQUAL(tc, 2, sbi_cache_freed);
+    ABTS_STR_EQUAL(tc, "4", ogs_sbi_cache_get(cache, "a"));
+
+    ABTS_INT_EQUAL(tc, 4, cache->stats.hit);
+    ABTS_INT_EQUAL(tc, 1, cache->stats.miss);
+    ABTS_INT_EQUAL(tc, 1, cache->stats.evicted);
+
+    ogs_sbi_cache_destroy(cache);
+    ABTS_INT_EQUAL(tc, 4, sbi_cache_freed);
+
+    /* An entry is dropped once its TTL has passed */
+    cache = ogs_sbi_cache_create(2, ogs_time_from_msec(10), sbi_cache_free);
+    ABTS_PTR_NOTNULL(tc, cache);
+
+    ogs_sbi_cache_set(cache, "a", ogs_strdup("1"));
+    ABTS_STR_EQUAL(tc, "1", ogs_sbi_cache_get(cache, "a"));
+    ogs_msleep(20);
+    ABTS_PTR_EQUAL(tc, NULL, ogs_sbi_cache_get(cache, "a"));
+    ABTS_INT_EQUAL(tc, 5, sbi_cache_freed);
+    ABTS_INT_EQUAL(tc, 1, cache->stats.expired);
+
+    ogs_sbi_cache_destroy(cache);
+
+    /* Requests built from the same message have the same key */
+    memset(&message, 0, sizeof(message));
+    message.h.method = (char *)OGS_SBI_HTTP_METHOD_GET;
+    message.h.service.name = (char *)OGS_SBI_SERVICE_NAME_NUDR_DR;
+    message.h.api.version = (char *)OGS_SBI_API_V1;
+    message.h.resource.component[0] =
+        (char *)OGS_SBI_RESOURCE_NAME_SUBSCRIPTION_DATA;
+    message.h.resource.component[1] = (char *)"imsi-999700000000001";
+    message.h.resource.component[2] = (char *)"99970";
+    message.h.resource.component[3] =
+        (char *)OGS_SBI_RESOURCE_NAME_PROVISIONED_DATA;
+    message.h.resource.component[4] = (char *)OGS_SBI_RESOURCE_NAME_SM_DATA;
+    message.param.dnn = (char *)"internet";
+    message.param.single_nssai_presence = true;
+    message.param.s_nssai.sst = 1;
+    message.param.s_nssai.sd.v = OGS_S_NSSAI_NO_SD_VALUE;
+
+    request1 = ogs_sbi_build_request(&message);
+    ABTS_PTR_NOTNULL(tc, request1);
+    request2 = ogs_sbi_build_request(&message);
+    ABTS_PTR_NOTNULL(tc, request2);
+
+    key1 = ogs_sbi_cache_key(request1);
+    ABTS_PTR_NOTNULL(tc, key1);
+    key2 = ogs_sbi_cache_key(request2);
+    ABTS_PTR_NOTNULL(tc, key2);
+    ABTS_STR_EQUAL(tc, key1, key2);
+    ABTS_PTR_NOTNULL(tc, strstr(key1, "?dnn=internet&single-nssai="));
+    ogs_free(key2);
+    ogs_sbi_request_free(request2);
+
+    message.param.dnn = (char *)"ims";
+    request2 = ogs_sbi_build_request(&message);
+    ABTS_PTR_NOTNULL(tc, request2);
+    key2 = ogs_sbi_cache_key(request2);
+    ABTS_PTR_NOTNULL(tc, key2);
+    ABTS_TRUE(tc, strcmp(key1, key2) != 0);
+
+    ogs_free(key1);
+    ogs_free(key2);
+    ogs_sbi_request_free(request1);
+    ogs_sbi_request_free(request2);
+
+    /* The key does not depend on the order the parameters were added */
+    {
+        const char *forward[] = { "dnn", "plmn-id", "single-nssai" };
+        const char *reverse[] = { "single-nssai", "plmn-id", "dnn" };
+
+        request1 = cache_key_request(forward, 3);
+        request2 = cache_key_request(reverse, 3);
+
+        key1 = ogs_sbi_cache_key(request1);
+        ABTS_PTR_NOTNULL(tc, key1);
+        key2 = ogs_sbi_cache_key(request2);
+        ABTS_PTR_NOTNULL(tc, key2);
+        ABTS_STR_EQUAL(tc, "GET /nudr-dr/v1/subscription-data"
+                "?dnn=dnn&plmn-id=plmn-id&single-nssai=single-nssai", key1);
+        ABTS_STR_EQUAL(tc, key1, key2);
+
+        ogs_free(key1);
+        ogs_free(key2);
+        ogs_sbi_request_free(request1);
+        ogs_sbi_request_free(request2);
+    }
+}
+
 abts_suite *test_sbi_message(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -1035,6 +1178,7 @@ abts_suite *test_sbi_message(abts_suite *suite)
     abts_run_test(suite, sbi_message_test8, NULL);
     abts_run_test(suite, sbi_message_test9, NULL);
     abts_run_test(suite, sbi_message_test10, NULL);
+    abts_run_test(suite, sbi_message_test11, NULL);
 
     return suite;
 }
@@ -18,6 +18,7 @@
  */
 
 #include "ogs-nas-common.h"
+#include "ogs-sbi.h"
 #include "core/abts.h"
 
 static void security_test1(abts_case *tc, void *data)
@@ -407,6 +408,220 @@ static void security_test9(abts_case *tc, void *data)
     ogs_pkbuf_free(pkbuf);
 }
 
+static void security_test10(abts_case *tc, void *data)
+{
+    const char *_ik = "d3c5d592 327fb11c 4035c668 0af8c6d1";
+    const char *_ck = "2bd6459f 82c440e0 952c4910 4805ff48";
+    uint8_t ik[16], ck[16];
+    uint8_t message[100];
+    uint8_t mac1[4], mac2[4];
+    ogs_nas_security_cache_t cache;
+    ogs_pkbuf_t *pkbuf1 = NULL, *pkbuf2 = NULL;
+    int i, round;
+
+    memset(&cache, 0, sizeof(cache));
+    ogs_hex_from_string(_ik, ik, sizeof(ik));
+    ogs_hex_from_string(_ck, ck, sizeof(ck));
+    for (i = 0; i < sizeof(message); i++)
+        message[i] = i;
+
+    /* Second round uses new keys : the cache must follow them */
+    for (round = 0; round < 2; round++) {
+        pkbuf1 = ogs_pkbuf_alloc(NULL, OGS_NAS_HEADROOM+sizeof(message));
+        ogs_assert(pkbuf1);
+        ogs_pkbuf_reserve(pkbuf1, OGS_NAS_HEADROOM);
+        ogs_pkbuf_put_data(pkbuf1, message, sizeof(message));
+
+        pkbuf2 = ogs_pkbuf_copy(pkbuf1);
+        ogs_assert(pkbuf2);
+
+        ogs_nas_mac_calculate(OGS_NAS_SECURITY_ALGORITHMS_128_EIA2,
+                ik, 0x398a59b4 + round, 0x1a, 1, pkbuf1, mac1);
+        ogs_nas_mac_calculate_cached(&cache,
+                OGS_NAS_SECURITY_ALGORITHMS_128_EIA2,
+                ik, 0x398a59b4 + round, 0x1a, 1, pkbuf2, mac2);
+        ABTS_TRUE(tc, memcmp(mac1, mac2, 4) == 0);
+
+        ogs_nas_encrypt(OGS_NAS_SECURITY_ALGORITHMS_128_EEA2,
+                ck, 0xc675a64b + round, 0x0c, 1, pkbuf1);
+        ogs_nas_encrypt_cached(&cache, OGS_NAS_SECURITY_ALGORITHMS_128_EEA2,
+                ck, 0xc675a64b + round, 0x0c, 1, pkbuf2);
+        ABTS_INT_EQUAL(tc, pkbuf1->len, pkbuf2->len);
+        ABTS_TRUE(tc, memcmp(pkbuf1->data, pkbuf2->data, pkbuf1->len) == 0);
+
+        ogs_pkbuf_free(pkbuf1);
+        ogs_pkbuf_free(pkbuf2);
+
+        ik[0] ^= 0xff;
+        ck[0] ^= 0xff;
+    }
+}
+
+/*
+ * Conceals an MSIN the way a UE does (TS33.501 Annex C.3.2),
+ * using the lib/crypt implementations and a fresh ephemeral key.
+ */
+static char *security_test11_suci(uint8_t id, uint8_t scheme,
+        uint8_t *hnet_pubkey, const char *msin)
+{
+    const uint8_t basepoint[OGS_ECCKEY_LEN] = { 9 };
+    uint8_t eph_key[OGS_ECCKEY_LEN];
+    uint8_t eph_pubkey[OGS_ECCKEY_LEN+1];
+    int eph_pubkey_len;
+    uint8_t z[OGS_ECCKEY_LEN];
+
+    uint8_t ek[OGS_KEY_LEN];
+    uint8_t icb[OGS_IVEC_LEN];
+    uint8_t mk[OGS_SHA256_DIGEST_SIZE];
+
+    uint8_t scheme_output[OGS_ECCKEY_LEN+1+OGS_MSIN_LEN+OGS_MACTAG_LEN];
+    char scheme_output_hex[sizeof(scheme_output)*2+1];
+    uint8_t plain_text[OGS_MSIN_LEN];
+    int len;
+
+    if (scheme == OGS_PROTECTION_SCHEME_PROFILE_A) {
+        ogs_random(eph_key, sizeof(eph_key));
+        curve25519_donna(eph_pubkey, eph_key, basepoint);
+        eph_pubkey_len = OGS_ECCKEY_LEN;
+        curve25519_donna(z, eph_key, hnet_pubkey);
+    } else {
+        ogs_assert(ecc_make_key(eph_pubkey, eph_key) == 1);
+        eph_pubkey_len = OGS_ECCKEY_LEN+1;
+        ogs_assert(ecdh_shared_secret(hnet_pubkey, eph_key, z) == 1);
+    }
+
+    ogs_kdf_ansi_x963(z, OGS_ECCKEY_LEN,
+            eph_pubkey, eph_pubkey_len, ek, icb, mk);
+
+    ogs_bcd_to_buffer(msin, plain_text, &len);
+    ogs_assert(len == OGS_MSIN_LEN);
+
+    memcpy(scheme_output, eph_pubkey, eph_pubkey_len);
+    ogs_aes_ctr128_encrypt(ek, icb, plain_text, OGS_MSIN_LEN,
+            scheme_output + eph_pubkey_len);
+    ogs_hmac_sha256(mk, OGS_SHA256_DIGEST_SIZE,
+            scheme_output + eph_pubkey_len, OGS_MSIN_LEN,
+            scheme_output + eph_pubkey_len + OGS_MSIN_LEN, OGS_MACTAG_LEN);
+
+    ogs_hex_to_ascii(scheme_output,
+            eph_pubkey_len + OGS_MSIN_LEN + OGS_MACTAG_LEN,
+            scheme_output_hex, sizeof(scheme_output_hex));
+
+    return ogs_msprintf("suci-0-001-01-0000-%d-%d-%s",
+            scheme, id, scheme_output_hex);
+}
+
+#define SECURITY_TEST11_NUM_OF_SUCI 256
+static void security_test11(abts_case *tc, void *data)
+{
+    /* Test vectors of TS33.501 Annex C.4.3 and C.4.4 */
+    const char *_curve25519 =
+        "10c9c67e861a5625a1db8f684123896d9b3506199d3df1968e07b6c8448bb147";
+    const char *_secp256r1 =
+        "74a9f918471f56f3befda5c51d738a3f94f5a52d4bc9db9799f5225fbccdde41";
+    char suci_a[] = "suci-0-001-01-0000-1-1-"
+        "b2e92f836055a255837debf850b528997ce0201cb82adfe4be1f587d07d8457d"
+        "7ee4435e1978dc897bff24129c";
+    char suci_b[] = "suci-0-001-01-0000-2-2-"
+        "039AAB8376597021E855679A9778EA0B67396E68C66DF32C0F41E9ACCA2DA9B9D1"
+        "cdd22e34965500e9242e65f58c";
+    const uint8_t basepoint[OGS_ECCKEY_LEN] = { 9 };
+    uint8_t key_a[OGS_ECCKEY_LEN], pubkey_a[OGS_ECCKEY_LEN];
+    uint8_t key_b[OGS_ECCKEY_LEN], pubkey_b[OGS_ECCKEY_LEN+1];
+    char *suci[SECURITY_TEST11_NUM_OF_SUCI];
+    char *supi[SECURITY_TEST11_NUM_OF_SUCI];
+    char *expected[SECURITY_TEST11_NUM_OF_SUCI];
+    uint8_t key[OGS_ECCKEY_LEN];
+    char msin[OGS_MSIN_LEN*2+1];
+    char *p = NULL;
+    int i, rv;
+
+    rv = ogs_sbi_suci_set_hnet_key(1, OGS_PROTECTION_SCHEME_PROFILE_A,
+            ogs_hex_from_string(_curve25519, key, sizeof(key)));
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+    rv = ogs_sbi_suci_set_hnet_key(2, OGS_PROTECTION_SCHEME_PROFILE_B,
+            ogs_hex_from_string(_secp256r1, key, sizeof(key)));
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    p = ogs_supi_from_suci(suci_a);
+    ABTS_PTR_NOTNULL(tc, p);
+    ABTS_STR_EQUAL(tc, "imsi-00101001002086", p);
+    ogs_free(p);
+
+    p = ogs_supi_from_suci(suci_b);
+    ABTS_PTR_NOTNULL(tc, p);
+    ABTS_STR_EQUAL(tc, "imsi-00101001002086", p);
+    ogs_free(p);
+
+    /* A corrupted MAC-tag must not be de-concealed */
+    suci_a[strlen(suci_a)-1] ^= 1;
+    p = ogs_supi_from_suci(suci_a);
+    ABTS_PTR_EQUAL(tc, NULL, p);
+    suci_a[strlen(suci_a)-1] ^= 1;
+
+    /* Home Network keys generated for this test */
+    ogs_random(key_a, sizeof(key_a));
+    curve25519_donna(pubkey_a, key_a, basepoint);
+    rv = ogs_sbi_suci_set_hnet_key(3, OGS_PROTECTION_SCHEME_PROFILE_A, key_a);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    ABTS_INT_EQUAL(tc, 1, ecc_make_key(pubkey_b, key_b));
+    rv = ogs_sbi_suci_set_hnet_key(4, OGS_PROTECTION_SCHEME_PROFILE_B, key_b);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    /*
+     * Every SUCI of the batch conceals a different MSIN under its own
+     * ephemeral key. One in sixteen has a corrupted MAC-tag.
+     */
+    for (i = 0; i < SECURITY_TEST11_NUM_OF_SUCI; i++) {
+        ogs_snprintf(msin, sizeof(msin), "%010d", 1002086 + i * 7919);
+        if (i % 2)
+            suci[i] = security_test11_suci(
+                    4, OGS_PROTECTION_SCHEME_PROFILE_B, pubkey_b, msin);
+        else
+            suci[i] = security_test11_suci(
+                    3, OGS_PROTECTION_SCHEME_PROFILE_A, pubkey_a, msin);
+        ogs_assert(suci[i]);
+
+        if (i % 16 == 15) {
+            suci[i][strlen(suci[i])-1] ^= 1;
+            expected[i] = NULL;
+        } else {
+            expected[i] = ogs_msprintf("imsi-00101%s", msin);
+            ogs_assert(expected[i]);
+        }
+    }
+
+    rv = ogs_sbi_suci_init(2);
+    ABTS_INT_EQUAL(tc, OGS_OK, rv);
+
+    ogs_supi_from_suci_batch(suci, supi, SECURITY_TEST11_NUM_OF_SUCI);
+
+    for (i = 0; i < SECURITY_TEST11_NUM_OF_SUCI; i++) {
+        p = ogs_supi_from_suci(suci[i]);
+
+        if (expected[i]) {
+            ABTS_PTR_NOTNULL(tc, p);
+            ABTS_PTR_NOTNULL(tc, supi[i]);
+            ABTS_STR_EQUAL(tc, expected[i], p);
+            ABTS_STR_EQUAL(tc, p, supi[i]);
+            ogs_free(expected[i]);
+        } else {
+            ABTS_PTR_EQUAL(tc, NULL, p);
+            ABTS_PTR_EQUAL(tc, NULL, supi[i]);
+        }
+
+        if (p)
+            ogs_free(p);
+        if (supi[i])
+            ogs_free(supi[i]);
+        ogs_free(suci[i]);
+    }
+
+    ogs_sbi_suci_final();
+    ogs_sbi_suci_clear_hnet_key();
+}
+
 abts_suite *test_security(abts_suite *suite)
 {
     suite = ADD_SUITE(suite)
@@ -420,6 +635,8 @@ abts_suite *test_security(abts_suite *suite)
     abts_run_test(suite, security_test7, NULL);
     abts_run_test(suite, security_test8, NULL);
     abts_run_test(suite, security_test9, NULL);
+    abts_run_test(suite, security_test10, NULL);
+    abts_run_test(suite, security_test11, NULL);
 
     return suite;
 }